@@ -0,0 +1,44 @@
+#include "AllocationHook.h"
+#include <cstdlib>
+#include <new>
+
+#ifdef SCHACK_ALLOCATION_HOOK
+
+namespace {
+    thread_local uint64_t allocationCount = 0;
+
+    void* countedAllocate(std::size_t size) {
+        allocationCount++;
+        if (void* memory = std::malloc(size == 0 ? 1 : size)) {
+            return memory;
+        }
+        throw std::bad_alloc();
+    }
+}
+
+void* operator new(std::size_t size) { return countedAllocate(size); }
+void* operator new[](std::size_t size) { return countedAllocate(size); }
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete[](void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::size_t) noexcept { std::free(memory); }
+
+bool AllocationHook::isEnabled() {
+    return true;
+}
+
+uint64_t AllocationHook::threadAllocations() {
+    return allocationCount;
+}
+
+#else
+
+bool AllocationHook::isEnabled() {
+    return false;
+}
+
+uint64_t AllocationHook::threadAllocations() {
+    return 0;
+}
+
+#endif
@@ -0,0 +1,10 @@
+#pragma once
+#include <cstdint>
+
+// Debug hook that counts global operator new calls per thread. It is only
+// compiled in when SCHACK_ALLOCATION_HOOK is defined (Debug configuration);
+// otherwise the counter always reads zero.
+namespace AllocationHook {
+    bool isEnabled();
+    uint64_t threadAllocations();
+}
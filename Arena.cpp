@@ -0,0 +1,10 @@
+#include "Arena.h"
+
+Arena::Arena(size_t bytes)
+    : buffer(std::make_unique<std::byte[]>(bytes)), capacity(bytes), used(0) {
+}
+
+Arena& Arena::local() {
+    thread_local Arena arena(DEFAULT_CAPACITY);
+    return arena;
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+
+// Bump allocator over one block reserved up front. Allocation is a pointer
+// increment and nothing is freed individually; reset() releases everything
+// at once. local() returns the calling thread's arena.
+class Arena {
+private:
+    std::unique_ptr<std::byte[]> buffer;
+    size_t capacity;
+    size_t used;
+
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 1 << 20;
+
+    explicit Arena(size_t bytes);
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    // Storage for count objects of T; trivially destructible types only
+    template<typename T>
+    T* allocate(size_t count) {
+        static_assert(std::is_trivially_destructible_v<T>, "Arena never runs destructors");
+        size_t offset = (used + alignof(T) - 1) & ~(alignof(T) - 1);
+        if (offset + sizeof(T) * count > capacity) {
+            throw std::runtime_error("Arena exhausted");
+        }
+        used = offset + sizeof(T) * count;
+        return new (buffer.get() + offset) T[count];
+    }
+
+    void reset() { used = 0; }
+    size_t getUsed() const { return used; }
+    size_t getCapacity() const { return capacity; }
+
+    static Arena& local();
+};
@@ -0,0 +1,233 @@
+#include "BatchAnalysis.h"
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include "BoardState.h"
+#include "Search.h"
+#include "TablebaseProber.h"
+#include "TranspositionTable.h"
+#include "WorkStealingPool.h"
+
+namespace {
+    struct EpdEntry {
+        std::string fen;
+        std::string id;
+        std::string bestMoves;   // "bm" operation, SAN as written in the file
+    };
+
+    // Search state owned by one pool worker
+    struct WorkerContext {
+        TranspositionTable table;
+        Search search;
+        uint64_t nodes = 0;
+
+        explicit WorkerContext(size_t hashMegabytes) : table(hashMegabytes), search(table) {}
+    };
+
+    // Holds finished results until every earlier index has been written
+    class ReorderBuffer {
+    private:
+        std::ostream& out;
+        std::mutex mutex;
+        std::map<size_t, std::string> waiting;
+        size_t nextIndex = 0;
+
+    public:
+        explicit ReorderBuffer(std::ostream& stream) : out(stream) {}
+
+        void push(size_t index, std::string line) {
+            std::lock_guard<std::mutex> lock(mutex);
+            waiting.emplace(index, std::move(line));
+            auto it = waiting.begin();
+            while (it != waiting.end() && it->first == nextIndex) {
+                out << it->second << '\n';
+                it = waiting.erase(it);
+                nextIndex++;
+            }
+            out.flush();
+        }
+    };
+
+    std::string jsonEscape(const std::string& text) {
+        std::string escaped;
+        for (char c : text) {
+            if (c == '"' || c == '\\') escaped += '\\';
+            escaped += c;
+        }
+        return escaped;
+    }
+
+    // EPD: four FEN fields followed by ';'-terminated operations such as
+    // bm Nf3; id "WAC.001";
+    bool parseEpdLine(const std::string& line, EpdEntry& entry) {
+        std::istringstream stream(line);
+        std::string placement, side, castling, enPassant;
+        if (!(stream >> placement >> side >> castling >> enPassant)) return false;
+        entry.fen = placement + " " + side + " " + castling + " " + enPassant;
+
+        std::string operations;
+        std::getline(stream, operations);
+        std::istringstream opStream(operations);
+        std::string operation;
+        while (std::getline(opStream, operation, ';')) {
+            std::istringstream fields(operation);
+            std::string opcode;
+            if (!(fields >> opcode)) continue;
+            std::string operand;
+            std::getline(fields, operand);
+            operand.erase(0, operand.find_first_not_of(' '));
+
+            if (opcode == "id") {
+                if (operand.size() >= 2 && operand.front() == '"' && operand.back() == '"') {
+                    operand = operand.substr(1, operand.size() - 2);
+                }
+                entry.id = operand;
+            } else if (opcode == "bm") {
+                entry.bestMoves = operand;
+            }
+        }
+        return true;
+    }
+
+    std::string analyzePosition(size_t index, const EpdEntry& entry, WorkerContext& context,
+                                const SearchLimits& limits) {
+        std::ostringstream json;
+        json << "{\"index\":" << index << ",\"id\":\"" << jsonEscape(entry.id)
+             << "\",\"fen\":\"" << jsonEscape(entry.fen) << "\"";
+
+        BoardState position;
+        if (!position.setFromFEN(entry.fen)) {
+            json << ",\"error\":\"invalid FEN\"}";
+            return json.str();
+        }
+
+        // Clearing keeps every result independent of which worker ran it
+        context.table.clear();
+        SearchResult result = context.search.run(position, limits);
+        context.nodes += result.stats.totalNodes();
+
+        json << ",\"bestmove\":\"" << (result.bestMove.isNone() ? "" : result.bestMove.toUci()) << "\"";
+        if (Search::isMateScore(result.score)) {
+            int plies = Search::MATE_SCORE - std::abs(result.score);
+            json << ",\"mate\":" << (result.score > 0 ? (plies + 1) / 2 : -(plies + 1) / 2);
+        } else {
+            json << ",\"cp\":" << result.score;
+        }
+        json << ",\"depth\":" << result.depth
+             << ",\"nodes\":" << result.stats.totalNodes()
+             << ",\"time_ms\":" << static_cast<int64_t>(result.seconds * 1000.0)
+             << ",\"pv\":\"";
+        for (size_t i = 0; i < result.pv.size(); i++) {
+            json << (i > 0 ? " " : "") << result.pv[i].toUci();
+        }
+        json << "\"";
+        if (!entry.bestMoves.empty()) {
+            json << ",\"bm\":\"" << jsonEscape(entry.bestMoves) << "\"";
+        }
+        json << "}";
+        return json.str();
+    }
+}
+
+int BatchAnalysis::run(const std::vector<std::string>& args) {
+    std::string inputPath;
+    std::string outputPath;
+    int threads = WorkStealingPool::defaultThreadCount();
+    size_t hashMegabytes = 8;
+    std::string tablebaseDirectory;
+    SearchLimits limits;
+    limits.depth = 8;
+
+    for (size_t i = 0; i < args.size(); i++) {
+        if (args[i] == "--threads" && i + 1 < args.size()) {
+            threads = std::stoi(args[++i]);
+        } else if (args[i] == "--depth" && i + 1 < args.size()) {
+            limits.depth = std::stoi(args[++i]);
+        } else if (args[i] == "--nodes" && i + 1 < args.size()) {
+            limits.nodes = std::stoull(args[++i]);
+            limits.depth = Search::MAX_PLY;
+        } else if (args[i] == "--hash" && i + 1 < args.size()) {
+            hashMegabytes = std::stoull(args[++i]);
+        } else if (args[i] == "--out" && i + 1 < args.size()) {
+            outputPath = args[++i];
+        } else if (args[i] == "--tb" && i + 1 < args.size()) {
+            tablebaseDirectory = args[++i];
+        } else if (inputPath.empty() && args[i].rfind("--", 0) != 0) {
+            inputPath = args[i];
+        } else {
+            inputPath.clear();
+            break;
+        }
+    }
+    if (inputPath.empty()) {
+        std::cerr << "Usage: analyze-batch <file.epd> [--threads N] [--depth D | --nodes N] [--hash MB] [--tb <dir>] [--out <file.jsonl>]\n";
+        return 1;
+    }
+
+    std::ifstream input(inputPath);
+    if (!input.is_open()) {
+        std::cerr << "Could not open " << inputPath << "\n";
+        return 1;
+    }
+    std::vector<EpdEntry> entries;
+    std::string line;
+    while (std::getline(input, line)) {
+        EpdEntry entry;
+        if (parseEpdLine(line, entry)) entries.push_back(std::move(entry));
+    }
+
+    std::ofstream outputFile;
+    if (!outputPath.empty()) {
+        outputFile.open(outputPath);
+        if (!outputFile.is_open()) {
+            std::cerr << "Could not open " << outputPath << "\n";
+            return 1;
+        }
+    }
+    ReorderBuffer results(outputPath.empty() ? std::cout : outputFile);
+
+    // One prober for all workers, so each table is mapped once
+    std::unique_ptr<TablebaseProber> tablebases;
+    if (!tablebaseDirectory.empty()) {
+        tablebases = std::make_unique<TablebaseProber>(tablebaseDirectory);
+        std::cerr << "Tablebases: " << tablebases->getTableCount() << " tables in " << tablebaseDirectory << "\n";
+    }
+
+    threads = std::max(threads, 1);
+    std::vector<std::unique_ptr<WorkerContext>> contexts;
+    for (int i = 0; i < threads; i++) {
+        contexts.push_back(std::make_unique<WorkerContext>(hashMegabytes));
+        contexts.back()->search.setTablebases(tablebases.get());
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    {
+        WorkStealingPool pool(threads);
+        for (size_t index = 0; index < entries.size(); index++) {
+            pool.submit([&, index](int worker) {
+                std::string json;
+                try {
+                    json = analyzePosition(index, entries[index], *contexts[worker], limits);
+                }
+                catch (const std::exception& e) {
+                    json = "{\"index\":" + std::to_string(index) + ",\"error\":\"" + jsonEscape(e.what()) + "\"}";
+                }
+                results.push(index, std::move(json));
+            });
+        }
+        pool.wait();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    uint64_t totalNodes = 0;
+    for (const auto& context : contexts) totalNodes += context->nodes;
+    std::cerr << "Analyzed " << entries.size() << " positions with " << threads << " threads in "
+              << seconds << " s (" << static_cast<uint64_t>(seconds > 0.0 ? entries.size() / seconds : 0.0)
+              << " positions/s, " << static_cast<uint64_t>(seconds > 0.0 ? totalNodes / seconds : 0.0)
+              << " nodes/s)\n";
+    return 0;
+}
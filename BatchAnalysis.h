@@ -0,0 +1,10 @@
+#pragma once
+#include <string>
+#include <vector>
+
+// Offline analysis of EPD files. Positions are searched in parallel, one
+// single-threaded search per position, and results are written as JSON
+// lines in input order.
+namespace BatchAnalysis {
+    int run(const std::vector<std::string>& args);
+}
@@ -0,0 +1,518 @@
+#include "Benchmark.h"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string_view>
+#include <thread>
+#include "AllocationHook.h"
+#include "BoardState.h"
+#include "EvalCache.h"
+#include "MoveJournal.h"
+#include "Nnue.h"
+#include "San.h"
+#include "Search.h"
+#include "SearchStats.h"
+#include "TranspositionTable.h"
+
+namespace {
+    const char* const BENCH_POSITIONS[] = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+        "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+        "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+        "6k1/5ppp/8/8/8/8/5PPP/3R2K1 w - - 0 1",
+    };
+
+    // Evaluates every node of a fixed-depth tree, the way a search visits them
+    void walkTree(BoardState& state, NnueEvaluator& evaluator, int depth, std::vector<int>& scores) {
+        scores.push_back(evaluator.evaluate(state));
+        if (depth == 0) return;
+        MoveList moves;
+        state.generateMoves(moves);
+        for (int i = 0; i < moves.size(); i++) {
+            UndoInfo undo;
+            evaluator.push(state, moves[i]);
+            state.makeMove(moves[i], undo);
+            if (state.wasLegalMove()) walkTree(state, evaluator, depth - 1, scores);
+            state.unmakeMove(moves[i], undo);
+            evaluator.pop();
+        }
+    }
+
+    void walkTreeFromScratch(BoardState& state, const NnueNetwork& network, const NnueKernels& kernels,
+                             int depth, std::vector<int>& scores) {
+        scores.push_back(network.evaluate(state, kernels));
+        if (depth == 0) return;
+        MoveList moves;
+        state.generateMoves(moves);
+        for (int i = 0; i < moves.size(); i++) {
+            UndoInfo undo;
+            state.makeMove(moves[i], undo);
+            if (state.wasLegalMove()) walkTreeFromScratch(state, network, kernels, depth - 1, scores);
+            state.unmakeMove(moves[i], undo);
+        }
+    }
+
+    double secondsSince(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+int Benchmark::run(const std::vector<std::string>& args) {
+    int depth = 8;
+    int multiPV = 1;
+    int64_t moveTimeMs = 0;
+    std::string jsonPath;
+    std::string networkPath;
+    size_t evalCacheKilobytes = 0;
+
+    for (size_t i = 0; i < args.size(); i++) {
+        if (args[i] == "--depth" && i + 1 < args.size()) {
+            depth = std::stoi(args[++i]);
+        } else if (args[i] == "--multipv" && i + 1 < args.size()) {
+            multiPV = std::stoi(args[++i]);
+        } else if (args[i] == "--movetime" && i + 1 < args.size()) {
+            moveTimeMs = std::stoll(args[++i]);
+            depth = Search::MAX_PLY;
+        } else if (args[i] == "--json" && i + 1 < args.size()) {
+            jsonPath = args[++i];
+        } else if (args[i] == "--nnue" && i + 1 < args.size()) {
+            networkPath = args[++i];
+        } else if (args[i] == "--eval-cache" && i + 1 < args.size()) {
+            evalCacheKilobytes = std::stoull(args[++i]);
+        } else {
+            std::cerr << "Usage: bench [--depth D | --movetime ms] [--multipv K] [--nnue <file>] [--eval-cache KB] [--json <file>]\n";
+            return 1;
+        }
+    }
+
+    std::unique_ptr<NnueNetwork> network;
+    if (!networkPath.empty()) {
+        network = std::make_unique<NnueNetwork>(networkPath);
+        std::cout << "NNUE evaluation: " << networkPath << " (" << NnueKernels::best().name << ")\n";
+    }
+    Nnue::setActiveNetwork(network.get());
+
+    // Scores beyond 16 bits must miss rather than come back wrapped
+    EvalCache rangeCheck(1);
+    int cachedScore = 0;
+    for (int score : { 32767, -32768, 40000, -40000, 70000 }) {
+        rangeCheck.store(0x1234567890ABCDEFULL, score);
+        const bool hit = rangeCheck.probe(0x1234567890ABCDEFULL, cachedScore);
+        if (hit != (score >= -32768 && score <= 32767) || (hit && cachedScore != score)) {
+            std::cerr << "Eval cache returned " << cachedScore << " after storing " << score << "\n";
+            return 1;
+        }
+        rangeCheck.clear();
+    }
+
+    TranspositionTable table(16);
+    Search search(table);
+    EvalCache evalCache(evalCacheKilobytes > 0 ? evalCacheKilobytes : 1);
+    if (evalCacheKilobytes > 0) search.setEvalCache(&evalCache);
+    SearchLimits limits;
+    limits.depth = depth;
+    limits.multiPV = multiPV;
+    limits.moveTimeMs = moveTimeMs;
+    limits.printIterations = true;
+
+    SearchStats totals;
+    double totalSeconds = 0.0;
+    uint64_t totalAllocations = 0;
+    int index = 1;
+    for (const char* fen : BENCH_POSITIONS) {
+        BoardState position;
+        position.setFromFEN(fen);
+        table.clear();
+        evalCache.clear();
+        if (evalCacheKilobytes == 0) EvalCache::local().clear();
+
+        std::cout << "\nPosition " << index++ << ": " << fen << "\n";
+        SearchResult result = search.run(position, limits);
+        std::cout << "bestmove " << result.bestMove.toUci() << "\n";
+
+        totals.add(result.stats);
+        totalSeconds += result.seconds;
+        totalAllocations += result.allocations;
+    }
+
+    const uint64_t nps = totalSeconds > 0.0 ? static_cast<uint64_t>(totals.totalNodes() / totalSeconds) : 0;
+    std::cout << "\n=================================\n";
+    std::cout << "Total nodes: " << totals.totalNodes() << "\n";
+    std::cout << "Time: " << totalSeconds << " s\n";
+    std::cout << "Nodes/second: " << nps << "\n";
+    std::cout << "TT hit rate: " << totals.ttHitRate() * 100.0 << "%\n";
+    std::cout << "First-move cutoffs: " << totals.firstMoveCutoffRate() * 100.0 << "%\n";
+    std::cout << "Pawn hash hit rate: " << totals.pawnHitRate() * 100.0 << "%\n";
+    std::cout << "Eval cache hit rate: " << totals.evalHitRate() * 100.0 << "% ("
+              << (evalCacheKilobytes > 0 ? evalCacheKilobytes : EvalCache::local().getSizeKilobytes()) << " KB)\n";
+    if (AllocationHook::isEnabled()) {
+        std::cout << "Heap allocations during search: " << totalAllocations << "\n";
+    }
+    std::cout << "=================================\n";
+
+    if (!jsonPath.empty()) {
+        std::ofstream file(jsonPath);
+        if (!file.is_open()) {
+            std::cerr << "Could not open " << jsonPath << "\n";
+            return 1;
+        }
+        file << "{\"depth\":" << depth << ",\"multipv\":" << multiPV << ",\"seconds\":" << totalSeconds
+             << ",\"nps\":" << nps << ",\"stats\":" << totals.toJson() << "}\n";
+        std::cout << "Telemetry written to " << jsonPath << "\n";
+    }
+    Nnue::setActiveNetwork(nullptr);
+    if (totalAllocations > 0) {
+        std::cerr << "Search allocated on the heap " << totalAllocations << " times; it must not allocate at all\n";
+        return 1;
+    }
+    return 0;
+}
+
+int Benchmark::runNnue(const std::vector<std::string>& args) {
+    std::string networkPath;
+    std::string jsonPath;
+    int depth = 3;
+
+    for (size_t i = 0; i < args.size(); i++) {
+        if (args[i] == "--depth" && i + 1 < args.size()) {
+            depth = std::stoi(args[++i]);
+        } else if (args[i] == "--json" && i + 1 < args.size()) {
+            jsonPath = args[++i];
+        } else if (networkPath.empty() && args[i].rfind("--", 0) != 0) {
+            networkPath = args[i];
+        } else {
+            networkPath.clear();
+            break;
+        }
+    }
+    if (networkPath.empty()) {
+        std::cerr << "Usage: nnue-bench <network.nnue> [--depth D] [--json <file>]\n";
+        return 1;
+    }
+
+    const NnueNetwork network(networkPath);
+    std::vector<int> reference;
+    bool allExact = true;
+    std::ostringstream json;
+    json << "{\"depth\":" << depth << ",\"kernels\":[";
+
+    std::cout << std::left << std::setw(10) << "kernel" << std::right << std::setw(16) << "incremental/s"
+              << std::setw(16) << "scratch/s" << std::setw(12) << "refreshes" << "  bit-exact\n";
+
+    bool first = true;
+    for (const NnueKernels* kernels : NnueKernels::available()) {
+        NnueEvaluator evaluator(network, Search::MAX_PLY + 1, *kernels);
+        std::vector<int> incremental;
+        std::vector<int> scratch;
+
+        auto start = std::chrono::steady_clock::now();
+        for (const char* fen : BENCH_POSITIONS) {
+            BoardState position;
+            position.setFromFEN(fen);
+            evaluator.reset(position);
+            walkTree(position, evaluator, depth, incremental);
+        }
+        const double incrementalSeconds = secondsSince(start);
+
+        start = std::chrono::steady_clock::now();
+        for (const char* fen : BENCH_POSITIONS) {
+            BoardState position;
+            position.setFromFEN(fen);
+            walkTreeFromScratch(position, network, *kernels, depth, scratch);
+        }
+        const double scratchSeconds = secondsSince(start);
+
+        // The scalar kernel runs first and is the reference for everything else
+        if (reference.empty()) reference = scratch;
+        const bool exact = incremental == reference && scratch == reference;
+        allExact = allExact && exact;
+
+        const double evals = static_cast<double>(incremental.size());
+        const uint64_t incrementalRate = incrementalSeconds > 0.0 ? static_cast<uint64_t>(evals / incrementalSeconds) : 0;
+        const uint64_t scratchRate = scratchSeconds > 0.0 ? static_cast<uint64_t>(evals / scratchSeconds) : 0;
+        const double refreshRate = evals > 0.0 ? static_cast<double>(evaluator.getRefreshes()) / evals : 0.0;
+        std::cout << std::left << std::setw(10) << kernels->name << std::right << std::setw(16) << incrementalRate
+                  << std::setw(16) << scratchRate << std::setw(11) << std::fixed << std::setprecision(1)
+                  << refreshRate * 100.0 << "%" << std::defaultfloat << "  " << (exact ? "yes" : "NO") << "\n";
+
+        json << (first ? "" : ",") << "{\"name\":\"" << kernels->name << "\",\"evals\":" << incremental.size()
+             << ",\"incremental_per_second\":" << incrementalRate << ",\"scratch_per_second\":" << scratchRate
+             << ",\"bit_exact\":" << (exact ? "true" : "false") << "}";
+        first = false;
+    }
+    json << "]}";
+
+    std::cout << "Positions evaluated per kernel: " << reference.size() << "\n";
+    std::cout << "Selected kernel: " << NnueKernels::best().name << "\n";
+    if (!jsonPath.empty()) {
+        std::ofstream file(jsonPath);
+        if (!file.is_open()) {
+            std::cerr << "Could not open " << jsonPath << "\n";
+            return 1;
+        }
+        file << json.str() << "\n";
+        std::cout << "Results written to " << jsonPath << "\n";
+    }
+    if (!allExact) {
+        std::cerr << "Kernel output differs from the scalar reference\n";
+        return 1;
+    }
+    return 0;
+}
+
+int Benchmark::runFen(const std::vector<std::string>& args) {
+    std::string inputPath;
+    double targetSeconds = 1.0;
+    for (size_t i = 0; i < args.size(); i++) {
+        if (args[i] == "--seconds" && i + 1 < args.size()) {
+            targetSeconds = std::stod(args[++i]);
+        } else if (inputPath.empty() && args[i].rfind("--", 0) != 0) {
+            inputPath = args[i];
+        } else {
+            std::cerr << "Usage: fen-bench [fens.txt] [--seconds S]\n";
+            return 1;
+        }
+    }
+
+    std::vector<std::string> fens(std::begin(BENCH_POSITIONS), std::end(BENCH_POSITIONS));
+    if (!inputPath.empty()) {
+        std::ifstream file(inputPath);
+        if (!file.is_open()) {
+            std::cerr << "Could not open " << inputPath << "\n";
+            return 1;
+        }
+        fens.clear();
+        std::string line;
+        while (std::getline(file, line)) {
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            if (!line.empty()) fens.push_back(line);
+        }
+    }
+
+    // Every position must survive parse -> write -> parse unchanged
+    std::vector<std::string_view> views;
+    BoardState position;
+    BoardState reparsed;
+    char buffer[MAX_FEN_LENGTH];
+    for (const std::string& fen : fens) {
+        if (!position.setFromFEN(fen)) {
+            std::cerr << "Skipping invalid FEN: " << fen << "\n";
+            continue;
+        }
+        const std::string_view written(buffer, position.writeFEN(buffer));
+        if (!reparsed.setFromFEN(written) || reparsed.getKey() != position.getKey() ||
+            reparsed.getPawnKey() != position.getPawnKey() || reparsed.toFEN() != written) {
+            std::cerr << "Round trip failed: " << fen << " -> " << written << "\n";
+            return 1;
+        }
+        views.push_back(fen);
+    }
+    if (views.empty()) {
+        std::cerr << "No valid positions\n";
+        return 1;
+    }
+
+    // Whole passes over the list until the time is up; the key sum keeps the work observable
+    uint64_t parsed = 0;
+    uint64_t checksum = 0;
+    const uint64_t allocationsBefore = AllocationHook::threadAllocations();
+    auto start = std::chrono::steady_clock::now();
+    double parseSeconds = 0.0;
+    do {
+        for (std::string_view fen : views) {
+            position.setFromFEN(fen);
+            checksum += position.getKey();
+        }
+        parsed += views.size();
+        parseSeconds = secondsSince(start);
+    } while (parseSeconds < targetSeconds);
+    const uint64_t parseAllocations = AllocationHook::threadAllocations() - allocationsBefore;
+
+    uint64_t written = 0;
+    size_t bytes = 0;
+    start = std::chrono::steady_clock::now();
+    double writeSeconds = 0.0;
+    do {
+        for (int i = 0; i < 1024; i++) bytes += position.writeFEN(buffer);
+        written += 1024;
+        writeSeconds = secondsSince(start);
+    } while (writeSeconds < targetSeconds);
+
+    std::cout << "Positions: " << views.size() << " (checksum " << std::hex << (checksum ^ bytes) << std::dec << ")\n";
+    std::cout << "Parsed/second: " << static_cast<uint64_t>(static_cast<double>(parsed) / parseSeconds) << "\n";
+    std::cout << "Written/second: " << static_cast<uint64_t>(static_cast<double>(written) / writeSeconds) << "\n";
+    if (AllocationHook::isEnabled()) {
+        std::cout << "Heap allocations while parsing: " << parseAllocations << "\n";
+    }
+    if (parseAllocations > 0) {
+        std::cerr << "FEN parsing allocated on the heap " << parseAllocations << " times; it must not allocate at all\n";
+        return 1;
+    }
+    return 0;
+}
+
+int Benchmark::runSan(const std::vector<std::string>& args) {
+    int games = 200;
+    uint64_t seed = 1;
+    for (size_t i = 0; i < args.size(); i++) {
+        if (args[i] == "--games" && i + 1 < args.size()) {
+            games = std::stoi(args[++i]);
+        } else if (args[i] == "--seed" && i + 1 < args.size()) {
+            seed = std::stoull(args[++i]);
+        } else {
+            std::cerr << "Usage: san-bench [--games N] [--seed S]\n";
+            return 1;
+        }
+    }
+
+    // Every legal move along seeded random games from the bench positions
+    struct Sample {
+        uint32_t position;
+        PackedMove move;
+    };
+    std::vector<BoardState> positions;
+    std::vector<Sample> samples;
+    std::mt19937_64 random(seed);
+    for (int game = 0; game < games; game++) {
+        BoardState position;
+        position.setFromFEN(BENCH_POSITIONS[game % std::size(BENCH_POSITIONS)]);
+        for (int ply = 0; ply < 200; ply++) {
+            MoveList moves;
+            position.generateLegalMoves(moves);
+            if (moves.empty()) break;
+            positions.push_back(position);
+            for (PackedMove move : moves) samples.push_back(Sample{ static_cast<uint32_t>(positions.size() - 1), move });
+            UndoInfo undo;
+            position.makeMove(moves[static_cast<int>(random() % static_cast<uint64_t>(moves.size()))], undo);
+        }
+    }
+
+    std::vector<char> text(samples.size() * San::MAX_LENGTH);
+    std::vector<uint8_t> lengths(samples.size());
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < samples.size(); i++) {
+        lengths[i] = static_cast<uint8_t>(San::write(positions[samples[i].position], samples[i].move, &text[i * San::MAX_LENGTH]));
+    }
+    const double writeSeconds = secondsSince(start);
+
+    size_t mismatches = 0;
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < samples.size(); i++) {
+        const std::string_view san(&text[i * San::MAX_LENGTH], lengths[i]);
+        if (San::parse(positions[samples[i].position], san) != samples[i].move) mismatches++;
+    }
+    const double parseSeconds = secondsSince(start);
+
+    // Malformed moves must be rejected, pawn pushes onto or next to the
+    // mover's own back rank included
+    const struct {
+        const char* fen;
+        const char* san;
+    } invalidMoves[] = {
+        { "k7/8/8/8/8/8/8/K7 w - - 0 1", "e1" },
+        { "k7/8/8/8/8/8/8/K7 w - - 0 1", "e2" },
+        { "k7/8/8/8/8/8/8/K7 w - - 0 1", "e1=Q" },
+        { "k7/8/8/8/8/8/8/K7 w - - 0 1", "dxe1" },
+        { "k7/8/8/8/8/8/8/K7 b - - 0 1", "e8" },
+        { "k7/8/8/8/8/8/8/K7 b - - 0 1", "e7" },
+        { "k7/8/8/8/8/8/8/K7 b - - 0 1", "e8=Q" },
+        { "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", "e5" },
+        { "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR b KQkq - 0 1", "e4" },
+    };
+    for (const auto& invalid : invalidMoves) {
+        BoardState position;
+        position.setFromFEN(invalid.fen);
+        if (!San::parse(position, invalid.san).isNone()) {
+            std::cerr << "Parsed invalid move " << invalid.san << " in " << invalid.fen << "\n";
+            mismatches++;
+        }
+    }
+
+    const double count = static_cast<double>(samples.size());
+    std::cout << "Positions: " << positions.size() << ", moves: " << samples.size() << "\n";
+    std::cout << "Written/second: " << static_cast<uint64_t>(writeSeconds > 0.0 ? count / writeSeconds : 0.0) << "\n";
+    std::cout << "Parsed/second: " << static_cast<uint64_t>(parseSeconds > 0.0 ? count / parseSeconds : 0.0) << "\n";
+    if (mismatches > 0) {
+        std::cerr << mismatches << " moves did not survive write and parse\n";
+        return 1;
+    }
+    std::cout << "All moves round-trip\n";
+    return 0;
+}
+
+int Benchmark::runJournal(const std::vector<std::string>& args) {
+    int moves = 10000;
+    int intervalMicroseconds = 0;
+    std::string path = "journal_bench.bin";
+    for (size_t i = 0; i < args.size(); i++) {
+        if (args[i] == "--moves" && i + 1 < args.size()) {
+            moves = std::max(std::stoi(args[++i]), 1);
+        } else if (args[i] == "--interval" && i + 1 < args.size()) {
+            intervalMicroseconds = std::stoi(args[++i]);
+        } else if (args[i] == "--file" && i + 1 < args.size()) {
+            path = args[++i];
+        } else {
+            std::cerr << "Usage: journal-bench [--moves N] [--interval us] [--file <path>]\n";
+            return 1;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::remove(path, error);
+    std::vector<double> latencies(static_cast<size_t>(moves));
+    uint64_t syncs = 0;
+    double flushSeconds = 0.0;
+    {
+        MoveJournal journal;
+        journal.open(path, nullptr);
+        for (int i = 0; i < moves; i++) {
+            const uint8_t record[4] = { static_cast<uint8_t>(i & 63), static_cast<uint8_t>((i * 7) & 63), 0, 5 };
+            const auto start = std::chrono::steady_clock::now();
+            journal.append(3, record, sizeof(record));
+            latencies[static_cast<size_t>(i)] = secondsSince(start) * 1e6;
+            if (intervalMicroseconds > 0) std::this_thread::sleep_for(std::chrono::microseconds(intervalMicroseconds));
+        }
+        const auto start = std::chrono::steady_clock::now();
+        journal.flush();
+        flushSeconds = secondsSince(start);
+        syncs = journal.getSyncCount();
+        journal.close();
+    }
+
+    // Simulate a crash in the middle of writing one more record
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::app);
+        const char torn[5] = { 3, 4, 0, 1, 2 };
+        file.write(torn, sizeof(torn));
+    }
+    MoveJournal journal;
+    uint64_t recovered = 0;
+    const JournalRecovery recovery = journal.open(path, [&](uint8_t, const uint8_t*, size_t) { recovered++; });
+    journal.close();
+    std::filesystem::remove(path, error);
+
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&](double fraction) {
+        return latencies[std::min(latencies.size() - 1, static_cast<size_t>(fraction * static_cast<double>(latencies.size())))];
+    };
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Appends: " << moves << ", latency us: p50 " << percentile(0.5) << ", p99 " << percentile(0.99)
+              << ", max " << latencies.back() << "\n";
+    std::cout << "Syncs: " << syncs << " (" << static_cast<double>(moves) / static_cast<double>(std::max<uint64_t>(syncs, 1))
+              << " records per sync), final flush " << flushSeconds * 1000.0 << " ms\n";
+    std::cout << "Recovery: " << recovered << " records, " << recovery.discardedBytes << " torn bytes discarded\n";
+    if (recovered != static_cast<uint64_t>(moves) || recovery.discardedBytes != 5) {
+        std::cerr << "Recovery did not return exactly the committed records\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include <string>
+#include <vector>
+
+// Fixed-position search benchmark, used to compare search performance
+// between builds and machines
+namespace Benchmark {
+    int run(const std::vector<std::string>& args);
+
+    // NNUE evaluation throughput per SIMD kernel, incremental and from
+    // scratch, checked bit-for-bit against the scalar reference
+    int runNnue(const std::vector<std::string>& args);
+
+    // FEN parse and write throughput over the bench positions or a file
+    // of FENs, after checking that each one round-trips unchanged
+    int runFen(const std::vector<std::string>& args);
+
+    // SAN write and parse throughput over every legal move along seeded
+    // random games; fails unless each move parses back to itself
+    int runSan(const std::vector<std::string>& args);
+
+    // Move journal append latency on the calling thread and the number of
+    // group-committed syncs, then recovery after a torn final record
+    int runJournal(const std::vector<std::string>& args);
+}
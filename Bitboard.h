@@ -0,0 +1,173 @@
+#pragma once
+#include <array>
+#include <bit>
+#include <cstdint>
+#include "Enums.h"
+
+// 64-bit square sets. Square index = row * 8 + col, using the same
+// row/col layout as Board (row 0 is Black's back rank, a8 = 0, h1 = 63).
+using Bitboard = uint64_t;
+
+namespace Bitboards {
+    constexpr Bitboard EMPTY = 0ULL;
+    constexpr Bitboard ROW_0 = 0xFFULL;            // rank 8
+    constexpr Bitboard COL_A = 0x0101010101010101ULL;
+    constexpr Bitboard COL_H = COL_A << 7;
+    constexpr Bitboard LIGHT_SQUARES = 0xAA55AA55AA55AA55ULL;   // a8, h1 and the squares of their color
+
+    constexpr int makeSquare(int row, int col) { return row * 8 + col; }
+    constexpr int rowOf(int square) { return square >> 3; }
+    constexpr int colOf(int square) { return square & 7; }
+    constexpr Bitboard squareBit(int square) { return 1ULL << square; }
+    constexpr Bitboard rowMask(int row) { return ROW_0 << (row * 8); }
+    constexpr Bitboard colMask(int col) { return COL_A << col; }
+
+    inline int lsb(Bitboard b) { return std::countr_zero(b); }
+    inline int msb(Bitboard b) { return 63 - std::countl_zero(b); }
+    inline int popCount(Bitboard b) { return std::popcount(b); }
+    inline int popLsb(Bitboard& b) {
+        int square = lsb(b);
+        b &= b - 1;
+        return square;
+    }
+
+    // Ray directions; the first four step to higher square indices
+    enum Direction { SOUTH, EAST, SOUTH_EAST, SOUTH_WEST, NORTH, WEST, NORTH_WEST, NORTH_EAST };
+
+    namespace detail {
+        constexpr int ROW_STEP[8] = { 1, 0, 1, 1, -1, 0, -1, -1 };
+        constexpr int COL_STEP[8] = { 0, 1, 1, -1, 0, -1, -1, 1 };
+
+        constexpr Bitboard stepAttacks(int square, const int (*offsets)[2], int count) {
+            Bitboard result = 0;
+            for (int i = 0; i < count; i++) {
+                int r = rowOf(square) + offsets[i][0];
+                int c = colOf(square) + offsets[i][1];
+                if (r >= 0 && r < 8 && c >= 0 && c < 8) {
+                    result |= squareBit(makeSquare(r, c));
+                }
+            }
+            return result;
+        }
+
+        constexpr std::array<Bitboard, 64> makeKnightTable() {
+            constexpr int offsets[8][2] = { {-2,-1}, {-2,1}, {-1,-2}, {-1,2}, {1,-2}, {1,2}, {2,-1}, {2,1} };
+            std::array<Bitboard, 64> table{};
+            for (int sq = 0; sq < 64; sq++) table[sq] = stepAttacks(sq, offsets, 8);
+            return table;
+        }
+
+        constexpr std::array<Bitboard, 64> makeKingTable() {
+            constexpr int offsets[8][2] = { {-1,-1}, {-1,0}, {-1,1}, {0,-1}, {0,1}, {1,-1}, {1,0}, {1,1} };
+            std::array<Bitboard, 64> table{};
+            for (int sq = 0; sq < 64; sq++) table[sq] = stepAttacks(sq, offsets, 8);
+            return table;
+        }
+
+        constexpr std::array<std::array<Bitboard, 64>, 2> makePawnTable() {
+            // White pawns capture towards row 0, black pawns towards row 7
+            constexpr int whiteOffsets[2][2] = { {-1,-1}, {-1,1} };
+            constexpr int blackOffsets[2][2] = { {1,-1}, {1,1} };
+            std::array<std::array<Bitboard, 64>, 2> table{};
+            for (int sq = 0; sq < 64; sq++) {
+                table[0][sq] = stepAttacks(sq, whiteOffsets, 2);
+                table[1][sq] = stepAttacks(sq, blackOffsets, 2);
+            }
+            return table;
+        }
+
+        constexpr std::array<std::array<Bitboard, 64>, 8> makeRayTable() {
+            std::array<std::array<Bitboard, 64>, 8> table{};
+            for (int dir = 0; dir < 8; dir++) {
+                for (int sq = 0; sq < 64; sq++) {
+                    Bitboard ray = 0;
+                    int r = rowOf(sq) + ROW_STEP[dir];
+                    int c = colOf(sq) + COL_STEP[dir];
+                    while (r >= 0 && r < 8 && c >= 0 && c < 8) {
+                        ray |= squareBit(makeSquare(r, c));
+                        r += ROW_STEP[dir];
+                        c += COL_STEP[dir];
+                    }
+                    table[dir][sq] = ray;
+                }
+            }
+            return table;
+        }
+
+        // Squares strictly between two squares on one line, empty otherwise
+        constexpr std::array<std::array<Bitboard, 64>, 64> makeBetweenTable() {
+            std::array<std::array<Bitboard, 64>, 64> table{};
+            for (int sq = 0; sq < 64; sq++) {
+                for (int dir = 0; dir < 8; dir++) {
+                    Bitboard passed = 0;
+                    int r = rowOf(sq) + ROW_STEP[dir];
+                    int c = colOf(sq) + COL_STEP[dir];
+                    while (r >= 0 && r < 8 && c >= 0 && c < 8) {
+                        table[sq][makeSquare(r, c)] = passed;
+                        passed |= squareBit(makeSquare(r, c));
+                        r += ROW_STEP[dir];
+                        c += COL_STEP[dir];
+                    }
+                }
+            }
+            return table;
+        }
+
+        inline constexpr auto KNIGHT_ATTACKS = makeKnightTable();
+        inline constexpr auto KING_ATTACKS = makeKingTable();
+        inline constexpr auto PAWN_ATTACKS = makePawnTable();
+        inline constexpr auto RAYS = makeRayTable();
+        inline constexpr auto BETWEEN = makeBetweenTable();
+
+        // Attacks along one ray, stopping at (and including) the first blocker
+        inline Bitboard rayAttacks(int dir, int square, Bitboard occupied) {
+            Bitboard ray = RAYS[dir][square];
+            Bitboard blockers = ray & occupied;
+            if (blockers) {
+                int first = (dir < NORTH) ? lsb(blockers) : msb(blockers);
+                ray ^= RAYS[dir][first];
+            }
+            return ray;
+        }
+    }
+
+    inline Bitboard knightAttacks(int square) { return detail::KNIGHT_ATTACKS[square]; }
+    inline Bitboard kingAttacks(int square) { return detail::KING_ATTACKS[square]; }
+    inline Bitboard pawnAttacks(PieceColor color, int square) {
+        return detail::PAWN_ATTACKS[static_cast<int>(color)][square];
+    }
+    inline Bitboard between(int from, int to) { return detail::BETWEEN[from][to]; }
+
+    // Squares attacked by a whole set of pawns (White captures towards row 0)
+    constexpr Bitboard pawnSetAttacks(PieceColor color, Bitboard pawns) {
+        return color == PieceColor::WHITE
+            ? ((pawns & ~COL_A) >> 9) | ((pawns & ~COL_H) >> 7)
+            : ((pawns & ~COL_A) << 7) | ((pawns & ~COL_H) << 9);
+    }
+
+    inline Bitboard rookAttacks(int square, Bitboard occupied) {
+        return detail::rayAttacks(NORTH, square, occupied) | detail::rayAttacks(SOUTH, square, occupied) |
+               detail::rayAttacks(EAST, square, occupied) | detail::rayAttacks(WEST, square, occupied);
+    }
+
+    inline Bitboard bishopAttacks(int square, Bitboard occupied) {
+        return detail::rayAttacks(NORTH_EAST, square, occupied) | detail::rayAttacks(NORTH_WEST, square, occupied) |
+               detail::rayAttacks(SOUTH_EAST, square, occupied) | detail::rayAttacks(SOUTH_WEST, square, occupied);
+    }
+
+    inline Bitboard queenAttacks(int square, Bitboard occupied) {
+        return rookAttacks(square, occupied) | bishopAttacks(square, occupied);
+    }
+
+    // Attack set of a non-pawn piece of the given type
+    inline Bitboard pieceAttacks(PieceType type, int square, Bitboard occupied) {
+        switch (type) {
+            case PieceType::KNIGHT: return knightAttacks(square);
+            case PieceType::BISHOP: return bishopAttacks(square, occupied);
+            case PieceType::ROOK: return rookAttacks(square, occupied);
+            case PieceType::QUEEN: return queenAttacks(square, occupied);
+            case PieceType::KING: return kingAttacks(square);
+            default: return 0;
+        }
+    }
+}
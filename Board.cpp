@@ -1,5 +1,8 @@
 #include "Board.h"
+#include <cstdlib>
 #include <iostream>
+#include "BoardState.h"
+#include "Endgames.h"
 
 // Private helper methods
 std::string Board::getPieceKey(PieceType type, PieceColor color) const {
@@ -123,7 +126,7 @@ bool Board::wouldLeaveKingInCheck(Position<int> from, Position<int> to) {
 // Public methods
 Board::Board() : currentTurn(PieceColor::WHITE), texturesLoaded(false), 
           lastMoveFrom(-1, -1), lastMoveTo(-1, -1), lastMovedPiece(nullptr),
-          halfmoveClock(0) {
+          halfmoveClock(0), fullmoveNumber(1) {
     for (int i = 0; i < BOARD_SIZE; i++) {
         for (int j = 0; j < BOARD_SIZE; j++) {
             board[i][j] = nullptr;
@@ -322,6 +325,7 @@ bool Board::movePiece(Position<int> from, Position<int> to) {
     lastMoveTo = to;
     lastMovedPiece = piece;
 
+    if (currentTurn == PieceColor::BLACK) fullmoveNumber++;
     currentTurn = (currentTurn == PieceColor::WHITE) ? PieceColor::BLACK : PieceColor::WHITE;
     
     // Track position for threefold repetition (after turn switch)
@@ -597,34 +601,13 @@ bool Board::isPlayerInStalemate(PieceColor color) const {
 }
 
 bool Board::hasInsufficientMaterial() const {
-    std::vector<PieceType> whitePieces, blackPieces;
-    
+    // KvK, KBvK and KNvK are flagged in the endgame registry
+    uint64_t materialKey = 0;
     for (const auto& piece : pieces) {
-        if (piece->getType() != PieceType::KING) {
-            if (piece->getColor() == PieceColor::WHITE) {
-                whitePieces.push_back(piece->getType());
-            } else {
-                blackPieces.push_back(piece->getType());
-            }
-        }
-    }
-    
-    // King vs King
-    if (whitePieces.empty() && blackPieces.empty()) return true;
-    
-    // King + Bishop vs King or King vs King + Bishop
-    if ((whitePieces.size() == 1 && whitePieces[0] == PieceType::BISHOP && blackPieces.empty()) ||
-        (blackPieces.size() == 1 && blackPieces[0] == PieceType::BISHOP && whitePieces.empty())) {
-        return true;
+        materialKey += materialKeyUnit(makePieceCode(piece->getColor(), piece->getType()));
     }
-    
-    // King + Knight vs King or King vs King + Knight
-    if ((whitePieces.size() == 1 && whitePieces[0] == PieceType::KNIGHT && blackPieces.empty()) ||
-        (blackPieces.size() == 1 && blackPieces[0] == PieceType::KNIGHT && whitePieces.empty())) {
-        return true;
-    }
-    
-    return false;
+    const Endgames::Entry* entry = Endgames::probe(materialKey);
+    return entry != nullptr && entry->insufficientMaterial;
 }
 
 bool Board::isFiftyMoveRule() const {
@@ -656,6 +639,133 @@ std::string Board::getPositionHash() const {
     return hash;
 }
 
+std::string Board::toFEN() const {
+    std::string fen;
+    for (int row = 0; row < BOARD_SIZE; row++) {
+        int empty = 0;
+        for (int col = 0; col < BOARD_SIZE; col++) {
+            Piece* piece = board[row][col];
+            if (piece == nullptr) {
+                empty++;
+                continue;
+            }
+            if (empty > 0) fen += static_cast<char>('0' + empty);
+            empty = 0;
+            fen += piece->getSymbol();
+        }
+        if (empty > 0) fen += static_cast<char>('0' + empty);
+        if (row < BOARD_SIZE - 1) fen += '/';
+    }
+    fen += (currentTurn == PieceColor::WHITE) ? " w " : " b ";
+
+    // Castling rights follow from kings and rooks that have not moved yet
+    auto unmoved = [this](int row, int col, PieceType type, PieceColor color) {
+        Piece* piece = board[row][col];
+        return piece != nullptr && piece->getType() == type && piece->getColor() == color && !piece->getHasMoved();
+    };
+    std::string castling;
+    if (unmoved(7, 4, PieceType::KING, PieceColor::WHITE)) {
+        if (unmoved(7, 7, PieceType::ROOK, PieceColor::WHITE)) castling += 'K';
+        if (unmoved(7, 0, PieceType::ROOK, PieceColor::WHITE)) castling += 'Q';
+    }
+    if (unmoved(0, 4, PieceType::KING, PieceColor::BLACK)) {
+        if (unmoved(0, 7, PieceType::ROOK, PieceColor::BLACK)) castling += 'k';
+        if (unmoved(0, 0, PieceType::ROOK, PieceColor::BLACK)) castling += 'q';
+    }
+    fen += castling.empty() ? "-" : castling;
+
+    // En passant target square after a double pawn push
+    Piece* moved = getPieceAt(lastMoveTo);
+    if (moved != nullptr && moved == lastMovedPiece && moved->getType() == PieceType::PAWN &&
+        std::abs(lastMoveTo.getRow() - lastMoveFrom.getRow()) == 2) {
+        int row = (lastMoveFrom.getRow() + lastMoveTo.getRow()) / 2;
+        fen += " ";
+        fen += static_cast<char>('a' + lastMoveTo.getCol());
+        fen += static_cast<char>('8' - row);
+    } else {
+        fen += " -";
+    }
+
+    fen += " " + std::to_string(halfmoveClock) + " " + std::to_string(fullmoveNumber);
+    return fen;
+}
+
+bool Board::fromFEN(std::string_view fen) {
+    // BoardState validates the FEN and normalizes castling and en passant
+    BoardState state;
+    if (!state.setFromFEN(fen)) return false;
+
+    // Pieces of the right type and color are reused from the current
+    // position; new ones are only allocated when there are too few
+    size_t used = 0;
+    for (int square = 0; square < 64; square++) {
+        const int code = state.getPieceAt(square);
+        if (code == NO_PIECE) continue;
+        const PieceType type = pieceCodeType(code);
+        const PieceColor color = pieceCodeColor(code);
+        const Position<int> position(Bitboards::rowOf(square), Bitboards::colOf(square));
+
+        size_t match = used;
+        while (match < pieces.size() && (pieces[match]->getType() != type || pieces[match]->getColor() != color)) {
+            match++;
+        }
+        if (match < pieces.size()) {
+            std::swap(pieces[used], pieces[match]);
+        } else {
+            std::unique_ptr<Piece> piece;
+            switch (type) {
+                case PieceType::KING: piece = std::make_unique<King>(color, position); break;
+                case PieceType::QUEEN: piece = std::make_unique<Queen>(color, position); break;
+                case PieceType::ROOK: piece = std::make_unique<Rook>(color, position); break;
+                case PieceType::BISHOP: piece = std::make_unique<Bishop>(color, position); break;
+                case PieceType::KNIGHT: piece = std::make_unique<Knight>(color, position); break;
+                case PieceType::PAWN: piece = std::make_unique<Pawn>(color, position); break;
+            }
+            auto it = textures.find(getPieceKey(type, color));
+            if (it != textures.end()) piece->setTexture(&it->second);
+            pieces.push_back(std::move(piece));
+            std::swap(pieces[used], pieces.back());
+        }
+
+        // Only unmoved kings and rooks may castle and only unmoved pawns may
+        // double-step, so hasMoved carries the castling rights and pawn ranks
+        Piece* piece = pieces[used++].get();
+        piece->setPosition(position);
+        const int homeRow = (color == PieceColor::WHITE) ? 7 : 0;
+        const uint8_t rights = state.getCastlingRights() >> (color == PieceColor::WHITE ? 0 : 2);
+        bool unmoved = false;
+        if (type == PieceType::PAWN) {
+            unmoved = position.getRow() == ((color == PieceColor::WHITE) ? 6 : 1);
+        } else if (type == PieceType::KING) {
+            unmoved = position == Position<int>(homeRow, 4) && (rights & 3) != 0;
+        } else if (type == PieceType::ROOK) {
+            unmoved = (position == Position<int>(homeRow, 7) && (rights & 1)) ||
+                      (position == Position<int>(homeRow, 0) && (rights & 2));
+        }
+        piece->setHasMoved(!unmoved);
+    }
+    pieces.erase(pieces.begin() + static_cast<std::ptrdiff_t>(used), pieces.end());
+    updateBoardArray();
+
+    currentTurn = state.getSideToMove();
+    halfmoveClock = state.getHalfmoveClock();
+    fullmoveNumber = state.getFullmoveNumber();
+    positionHistory.clear();
+
+    // An en passant square stands for the double push that was just played
+    lastMoveFrom = Position<int>(-1, -1);
+    lastMoveTo = Position<int>(-1, -1);
+    lastMovedPiece = nullptr;
+    const int enPassant = state.getEnPassantSquare();
+    if (enPassant >= 0) {
+        const int direction = (currentTurn == PieceColor::WHITE) ? 1 : -1;   // toward the pushed pawn
+        lastMoveFrom = Position<int>(Bitboards::rowOf(enPassant) - direction, Bitboards::colOf(enPassant));
+        lastMoveTo = Position<int>(Bitboards::rowOf(enPassant) + direction, Bitboards::colOf(enPassant));
+        lastMovedPiece = getPieceAt(lastMoveTo);
+    }
+    return true;
+}
+
 int Board::getMaterialScore(PieceColor color) const {
     int score = 0;
     for (const auto& piece : pieces) {
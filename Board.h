@@ -5,6 +5,7 @@
 #include <SFML/Graphics.hpp>
 #include <map>
 #include <string>
+#include <string_view>
 #include "Piece.h"
 #include "King.h"
 #include "Queen.h"
@@ -37,6 +38,7 @@ class Board {
     
     // Draw condition tracking
     int halfmoveClock;  // For 50-move rule
+    int fullmoveNumber;
     std::map<std::string, int> positionHistory;  // For threefold repetition
 
     // Private helper methods
@@ -67,6 +69,10 @@ class Board {
     bool isFiftyMoveRule() const;
     bool isThreefoldRepetition() const;
     std::string getPositionHash() const;
+    // Sets up any legal FEN position, reusing existing Piece objects; leaves
+    // the board unchanged and returns false if the FEN is invalid
+    bool fromFEN(std::string_view fen);
+    std::string toFEN() const;
     int getMaterialScore(PieceColor color) const;
     Piece* getPieceAt(Position<int> pos) const;
     PieceColor getCurrentTurn() const;
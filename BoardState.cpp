@@ -0,0 +1,678 @@
+#include "BoardState.h"
+#include <algorithm>
+#include "PieceSquareTables.h"
+#include "Zobrist.h"
+
+using namespace Bitboards;
+
+namespace {
+    // Castling rights that survive a move touching each square
+    constexpr std::array<uint8_t, 64> makeCastlingMasks() {
+        std::array<uint8_t, 64> masks{};
+        for (auto& mask : masks) mask = 15;
+        masks[makeSquare(7, 0)] = static_cast<uint8_t>(15 & ~WHITE_QUEENSIDE);
+        masks[makeSquare(7, 7)] = static_cast<uint8_t>(15 & ~WHITE_KINGSIDE);
+        masks[makeSquare(7, 4)] = static_cast<uint8_t>(15 & ~(WHITE_KINGSIDE | WHITE_QUEENSIDE));
+        masks[makeSquare(0, 0)] = static_cast<uint8_t>(15 & ~BLACK_QUEENSIDE);
+        masks[makeSquare(0, 7)] = static_cast<uint8_t>(15 & ~BLACK_KINGSIDE);
+        masks[makeSquare(0, 4)] = static_cast<uint8_t>(15 & ~(BLACK_KINGSIDE | BLACK_QUEENSIDE));
+        return masks;
+    }
+
+    constexpr auto CASTLING_MASKS = makeCastlingMasks();
+
+    constexpr const char* PIECE_CHARS = "KQRBNPkqrbnp";
+
+    // FEN placement characters: piece codes, then runs of 1-8 empty
+    // squares, the row separator and everything else
+    constexpr int FEN_EMPTY_1 = NO_PIECE + 1;
+    constexpr int FEN_EMPTY_8 = FEN_EMPTY_1 + 7;
+    constexpr int FEN_ROW_END = FEN_EMPTY_8 + 1;
+    constexpr int FEN_INVALID = FEN_ROW_END + 1;
+
+    constexpr std::array<uint8_t, 256> makeFenCodes() {
+        std::array<uint8_t, 256> codes{};
+        for (auto& code : codes) code = FEN_INVALID;
+        for (int piece = 0; piece < 12; piece++) codes[static_cast<unsigned char>(PIECE_CHARS[piece])] = static_cast<uint8_t>(piece);
+        for (int run = 1; run <= 8; run++) codes['0' + run] = static_cast<uint8_t>(FEN_EMPTY_1 + run - 1);
+        codes['/'] = FEN_ROW_END;
+        return codes;
+    }
+
+    constexpr auto FEN_CODES = makeFenCodes();
+
+    bool isFenSpace(char c) {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+    }
+
+    bool isFenFieldEnd(const char* cursor, const char* end) {
+        return cursor == end || isFenSpace(*cursor);
+    }
+
+    const char* skipFenSpaces(const char* cursor, const char* end) {
+        while (cursor != end && isFenSpace(*cursor)) cursor++;
+        return cursor;
+    }
+
+    // Unsigned decimal field, saturated to 16 bits; fallback when the field is missing
+    const char* readFenNumber(const char* cursor, const char* end, uint16_t fallback, uint16_t& number) {
+        number = fallback;
+        if (cursor == end || *cursor < '0' || *cursor > '9') return cursor;
+        uint32_t value = 0;
+        for (; cursor != end && *cursor >= '0' && *cursor <= '9'; cursor++) {
+            value = std::min<uint32_t>(value * 10 + static_cast<uint32_t>(*cursor - '0'), UINT16_MAX);
+        }
+        number = static_cast<uint16_t>(value);
+        return cursor;
+    }
+
+    char* writeFenNumber(char* out, uint16_t value) {
+        char digits[5];
+        int count = 0;
+        do {
+            digits[count++] = static_cast<char>('0' + value % 10);
+            value = static_cast<uint16_t>(value / 10);
+        } while (value != 0);
+        while (count > 0) *out++ = digits[--count];
+        return out;
+    }
+}
+
+BoardState::BoardState() {
+    clear();
+}
+
+void BoardState::clear() {
+    for (auto& bb : byPiece) bb = 0;
+    byColor[0] = byColor[1] = 0;
+    occupied = 0;
+    std::fill(std::begin(mailbox), std::end(mailbox), static_cast<uint8_t>(NO_PIECE));
+    sideToMove = PieceColor::WHITE;
+    castlingRights = 0;
+    enPassantSquare = -1;
+    halfmoveClock = 0;
+    fullmoveNumber = 1;
+    key = 0;
+    pawnKey = 0;
+    materialKey = 0;
+    mgScore = 0;
+    egScore = 0;
+    phase = 0;
+}
+
+void BoardState::setStartPosition() {
+    setFromFEN("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+}
+
+void BoardState::putPiece(int square, int piece) {
+    Bitboard bit = squareBit(square);
+    byPiece[piece] |= bit;
+    byColor[static_cast<int>(pieceCodeColor(piece))] |= bit;
+    occupied |= bit;
+    mailbox[square] = static_cast<uint8_t>(piece);
+    key ^= Zobrist::KEYS.pieceSquare[piece][square];
+    if (pieceCodeType(piece) == PieceType::PAWN) pawnKey ^= Zobrist::KEYS.pieceSquare[piece][square];
+    materialKey += materialKeyUnit(piece);
+    mgScore += PieceSquareTables::COMBINED.mg[piece][square];
+    egScore += PieceSquareTables::COMBINED.eg[piece][square];
+    phase += PieceSquareTables::PHASE_WEIGHT[piece % 6];
+}
+
+void BoardState::removePiece(int square) {
+    int piece = mailbox[square];
+    Bitboard bit = squareBit(square);
+    byPiece[piece] ^= bit;
+    byColor[static_cast<int>(pieceCodeColor(piece))] ^= bit;
+    occupied ^= bit;
+    mailbox[square] = NO_PIECE;
+    key ^= Zobrist::KEYS.pieceSquare[piece][square];
+    if (pieceCodeType(piece) == PieceType::PAWN) pawnKey ^= Zobrist::KEYS.pieceSquare[piece][square];
+    materialKey -= materialKeyUnit(piece);
+    mgScore -= PieceSquareTables::COMBINED.mg[piece][square];
+    egScore -= PieceSquareTables::COMBINED.eg[piece][square];
+    phase -= PieceSquareTables::PHASE_WEIGHT[piece % 6];
+}
+
+void BoardState::movePieceBits(int from, int to) {
+    int piece = mailbox[from];
+    Bitboard fromTo = squareBit(from) | squareBit(to);
+    byPiece[piece] ^= fromTo;
+    byColor[static_cast<int>(pieceCodeColor(piece))] ^= fromTo;
+    occupied ^= fromTo;
+    mailbox[from] = NO_PIECE;
+    mailbox[to] = static_cast<uint8_t>(piece);
+    key ^= Zobrist::KEYS.pieceSquare[piece][from] ^ Zobrist::KEYS.pieceSquare[piece][to];
+    if (pieceCodeType(piece) == PieceType::PAWN) {
+        pawnKey ^= Zobrist::KEYS.pieceSquare[piece][from] ^ Zobrist::KEYS.pieceSquare[piece][to];
+    }
+    mgScore += PieceSquareTables::COMBINED.mg[piece][to] - PieceSquareTables::COMBINED.mg[piece][from];
+    egScore += PieceSquareTables::COMBINED.eg[piece][to] - PieceSquareTables::COMBINED.eg[piece][from];
+}
+
+bool BoardState::setFromFEN(std::string_view fen) {
+    clear();
+    const char* cursor = fen.data();
+    const char* const end = cursor + fen.size();
+
+    // Placement in one pass: keys and evaluation terms are summed in locals
+    // the way putPiece() would, colour and occupancy bitboards are derived
+    // from the piece bitboards at the end
+    cursor = skipFenSpaces(cursor, end);
+    uint64_t pieceKey = 0, pawns = 0, material = 0;
+    int mg = 0, eg = 0, gamePhase = 0;
+    int square = 0, rowEnd = 8;
+    for (; !isFenFieldEnd(cursor, end); cursor++) {
+        const int code = FEN_CODES[static_cast<unsigned char>(*cursor)];
+        if (code < NO_PIECE) {
+            if (square >= rowEnd) return false;
+            const uint64_t squareKey = Zobrist::KEYS.pieceSquare[code][square];
+            byPiece[code] |= squareBit(square);
+            mailbox[square] = static_cast<uint8_t>(code);
+            pieceKey ^= squareKey;
+            if (pieceCodeType(code) == PieceType::PAWN) pawns ^= squareKey;
+            material += materialKeyUnit(code);
+            mg += PieceSquareTables::COMBINED.mg[code][square];
+            eg += PieceSquareTables::COMBINED.eg[code][square];
+            gamePhase += PieceSquareTables::PHASE_WEIGHT[code % 6];
+            square++;
+        } else if (code <= FEN_EMPTY_8) {
+            square += code - FEN_EMPTY_1 + 1;
+            if (square > rowEnd) return false;
+        } else if (code == FEN_ROW_END) {
+            if (square != rowEnd || rowEnd == 64) return false;
+            rowEnd += 8;
+        } else {
+            return false;
+        }
+    }
+    if (square != 64) return false;
+    for (int piece = 0; piece < 6; piece++) {
+        byColor[0] |= byPiece[piece];
+        byColor[1] |= byPiece[piece + 6];
+    }
+    occupied = byColor[0] | byColor[1];
+    key = pieceKey;
+    pawnKey = pawns;
+    materialKey = material;
+    mgScore = mg;
+    egScore = eg;
+    phase = gamePhase;
+    if (popCount(getPieces(PieceColor::WHITE, PieceType::KING)) != 1 ||
+        popCount(getPieces(PieceColor::BLACK, PieceType::KING)) != 1) {
+        return false;
+    }
+
+    cursor = skipFenSpaces(cursor, end);
+    if (cursor == end || (*cursor != 'w' && *cursor != 'b')) return false;
+    sideToMove = (*cursor++ == 'w') ? PieceColor::WHITE : PieceColor::BLACK;
+    if (!isFenFieldEnd(cursor, end)) return false;
+
+    cursor = skipFenSpaces(cursor, end);
+    if (cursor == end) return false;
+    for (; !isFenFieldEnd(cursor, end); cursor++) {
+        switch (*cursor) {
+            case 'K': castlingRights |= WHITE_KINGSIDE; break;
+            case 'Q': castlingRights |= WHITE_QUEENSIDE; break;
+            case 'k': castlingRights |= BLACK_KINGSIDE; break;
+            case 'q': castlingRights |= BLACK_QUEENSIDE; break;
+            case '-': break;
+            default: return false;
+        }
+    }
+
+    cursor = skipFenSpaces(cursor, end);
+    if (cursor == end) return false;
+    if (*cursor == '-') {
+        cursor++;
+    } else {
+        if (end - cursor < 2 || cursor[0] < 'a' || cursor[0] > 'h' || cursor[1] < '1' || cursor[1] > '8') {
+            return false;
+        }
+        const int target = makeSquare('8' - cursor[1], cursor[0] - 'a');
+        cursor += 2;
+        // Only keep the square if a pawn can actually capture there
+        if (pawnAttacks(oppositeColor(sideToMove), target) & getPieces(sideToMove, PieceType::PAWN)) {
+            enPassantSquare = static_cast<int8_t>(target);
+        }
+    }
+    if (!isFenFieldEnd(cursor, end)) return false;
+
+    // Clocks are optional, as in EPD-style records
+    cursor = skipFenSpaces(cursor, end);
+    cursor = readFenNumber(cursor, end, 0, halfmoveClock);
+    cursor = skipFenSpaces(cursor, end);
+    readFenNumber(cursor, end, 1, fullmoveNumber);
+    if (fullmoveNumber == 0) fullmoveNumber = 1;
+
+    key ^= Zobrist::KEYS.castling[castlingRights];
+    if (enPassantSquare >= 0) key ^= Zobrist::KEYS.enPassantCol[colOf(enPassantSquare)];
+    if (sideToMove == PieceColor::BLACK) key ^= Zobrist::KEYS.sideToMove;
+    return true;
+}
+
+size_t BoardState::writeFEN(char* buffer) const {
+    char* out = buffer;
+    for (int row = 0; row < 8; row++) {
+        int empty = 0;
+        for (int col = 0; col < 8; col++) {
+            int piece = mailbox[makeSquare(row, col)];
+            if (piece == NO_PIECE) {
+                empty++;
+                continue;
+            }
+            if (empty > 0) {
+                *out++ = static_cast<char>('0' + empty);
+                empty = 0;
+            }
+            *out++ = PIECE_CHARS[piece];
+        }
+        if (empty > 0) *out++ = static_cast<char>('0' + empty);
+        if (row < 7) *out++ = '/';
+    }
+
+    *out++ = ' ';
+    *out++ = (sideToMove == PieceColor::WHITE) ? 'w' : 'b';
+    *out++ = ' ';
+    if (castlingRights == 0) *out++ = '-';
+    if (castlingRights & WHITE_KINGSIDE) *out++ = 'K';
+    if (castlingRights & WHITE_QUEENSIDE) *out++ = 'Q';
+    if (castlingRights & BLACK_KINGSIDE) *out++ = 'k';
+    if (castlingRights & BLACK_QUEENSIDE) *out++ = 'q';
+
+    *out++ = ' ';
+    if (enPassantSquare >= 0) {
+        *out++ = static_cast<char>('a' + colOf(enPassantSquare));
+        *out++ = static_cast<char>('8' - rowOf(enPassantSquare));
+    } else {
+        *out++ = '-';
+    }
+    *out++ = ' ';
+    out = writeFenNumber(out, halfmoveClock);
+    *out++ = ' ';
+    out = writeFenNumber(out, fullmoveNumber);
+    return static_cast<size_t>(out - buffer);
+}
+
+std::string BoardState::toFEN() const {
+    char buffer[MAX_FEN_LENGTH];
+    return std::string(buffer, writeFEN(buffer));
+}
+
+uint64_t BoardState::computeKey() const {
+    uint64_t result = 0;
+    for (int square = 0; square < 64; square++) {
+        if (mailbox[square] != NO_PIECE) {
+            result ^= Zobrist::KEYS.pieceSquare[mailbox[square]][square];
+        }
+    }
+    result ^= Zobrist::KEYS.castling[castlingRights];
+    if (enPassantSquare >= 0) result ^= Zobrist::KEYS.enPassantCol[colOf(enPassantSquare)];
+    if (sideToMove == PieceColor::BLACK) result ^= Zobrist::KEYS.sideToMove;
+    return result;
+}
+
+uint64_t BoardState::computePawnKey() const {
+    uint64_t result = 0;
+    for (int color = 0; color < 2; color++) {
+        int piece = makePieceCode(static_cast<PieceColor>(color), PieceType::PAWN);
+        Bitboard pawns = byPiece[piece];
+        while (pawns) result ^= Zobrist::KEYS.pieceSquare[piece][popLsb(pawns)];
+    }
+    return result;
+}
+
+uint64_t BoardState::computeMaterialKey() const {
+    uint64_t result = 0;
+    for (int piece = 0; piece < 12; piece++) {
+        result += materialKeyUnit(piece) * static_cast<uint64_t>(popCount(byPiece[piece]));
+    }
+    return result;
+}
+
+void BoardState::makeMove(PackedMove move, UndoInfo& undo) {
+    undo.key = key;
+    undo.capturedPiece = NO_PIECE;
+    undo.castlingRights = castlingRights;
+    undo.enPassantSquare = enPassantSquare;
+    undo.halfmoveClock = halfmoveClock;
+
+    const int from = move.getFrom();
+    const int to = move.getTo();
+    const PieceColor us = sideToMove;
+    const PieceColor them = oppositeColor(us);
+    const int movingPiece = mailbox[from];
+
+    if (enPassantSquare >= 0) {
+        key ^= Zobrist::KEYS.enPassantCol[colOf(enPassantSquare)];
+        enPassantSquare = -1;
+    }
+
+    halfmoveClock++;
+    if (move.isEnPassant()) {
+        int captureSquare = to + (us == PieceColor::WHITE ? 8 : -8);
+        undo.capturedPiece = mailbox[captureSquare];
+        removePiece(captureSquare);
+    } else if (move.isCapture()) {
+        undo.capturedPiece = mailbox[to];
+        removePiece(to);
+    }
+    if (undo.capturedPiece != NO_PIECE || pieceCodeType(movingPiece) == PieceType::PAWN) {
+        halfmoveClock = 0;
+    }
+
+    movePieceBits(from, to);
+
+    if (move.isCastling()) {
+        bool kingside = move.getFlags() == PackedMove::KING_CASTLE;
+        movePieceBits(kingside ? to + 1 : to - 2, kingside ? to - 1 : to + 1);
+    } else if (move.isPromotion()) {
+        removePiece(to);
+        putPiece(to, makePieceCode(us, move.getPromotionType()));
+    } else if (move.getFlags() == PackedMove::DOUBLE_PUSH) {
+        int square = (from + to) / 2;
+        if (pawnAttacks(us, square) & getPieces(them, PieceType::PAWN)) {
+            enPassantSquare = static_cast<int8_t>(square);
+            key ^= Zobrist::KEYS.enPassantCol[colOf(square)];
+        }
+    }
+
+    uint8_t newRights = castlingRights & CASTLING_MASKS[from] & CASTLING_MASKS[to];
+    if (newRights != castlingRights) {
+        key ^= Zobrist::KEYS.castling[castlingRights] ^ Zobrist::KEYS.castling[newRights];
+        castlingRights = newRights;
+    }
+
+    sideToMove = them;
+    key ^= Zobrist::KEYS.sideToMove;
+    if (us == PieceColor::BLACK) fullmoveNumber++;
+}
+
+void BoardState::unmakeMove(PackedMove move, const UndoInfo& undo) {
+    sideToMove = oppositeColor(sideToMove);
+    const PieceColor us = sideToMove;
+    const int from = move.getFrom();
+    const int to = move.getTo();
+
+    if (us == PieceColor::BLACK) fullmoveNumber--;
+
+    if (move.isPromotion()) {
+        removePiece(to);
+        putPiece(to, makePieceCode(us, PieceType::PAWN));
+    }
+    movePieceBits(to, from);
+
+    if (move.isCastling()) {
+        bool kingside = move.getFlags() == PackedMove::KING_CASTLE;
+        movePieceBits(kingside ? to - 1 : to + 1, kingside ? to + 1 : to - 2);
+    }
+
+    if (undo.capturedPiece != NO_PIECE) {
+        int captureSquare = move.isEnPassant() ? to + (us == PieceColor::WHITE ? 8 : -8) : to;
+        putPiece(captureSquare, undo.capturedPiece);
+    }
+
+    castlingRights = undo.castlingRights;
+    enPassantSquare = undo.enPassantSquare;
+    halfmoveClock = undo.halfmoveClock;
+    key = undo.key;
+}
+
+void BoardState::makeNullMove(UndoInfo& undo) {
+    undo.key = key;
+    undo.capturedPiece = NO_PIECE;
+    undo.castlingRights = castlingRights;
+    undo.enPassantSquare = enPassantSquare;
+    undo.halfmoveClock = halfmoveClock;
+
+    if (enPassantSquare >= 0) {
+        key ^= Zobrist::KEYS.enPassantCol[colOf(enPassantSquare)];
+        enPassantSquare = -1;
+    }
+    halfmoveClock++;
+    sideToMove = oppositeColor(sideToMove);
+    key ^= Zobrist::KEYS.sideToMove;
+}
+
+void BoardState::unmakeNullMove(const UndoInfo& undo) {
+    sideToMove = oppositeColor(sideToMove);
+    enPassantSquare = undo.enPassantSquare;
+    halfmoveClock = undo.halfmoveClock;
+    key = undo.key;
+}
+
+void BoardState::generatePawnMoves(MoveList& list, bool capturesOnly) const {
+    const PieceColor us = sideToMove;
+    const PieceColor them = oppositeColor(us);
+    const Bitboard pawns = getPieces(us, PieceType::PAWN);
+    const Bitboard enemies = getPieces(them);
+    const Bitboard empty = ~occupied;
+    const int forward = (us == PieceColor::WHITE) ? -8 : 8;
+    const Bitboard promotionRow = rowMask(us == PieceColor::WHITE ? 0 : 7);
+    const Bitboard doublePushRow = rowMask(us == PieceColor::WHITE ? 5 : 2);
+
+    auto shiftForward = [us](Bitboard b) {
+        return (us == PieceColor::WHITE) ? (b >> 8) : (b << 8);
+    };
+
+    Bitboard singlePush = shiftForward(pawns) & empty;
+
+    // Promotions by push; only the queen promotion counts as "tactical"
+    Bitboard promotions = singlePush & promotionRow;
+    while (promotions) {
+        int to = popLsb(promotions);
+        list.add(PackedMove(to - forward, to, PackedMove::PROMOTION + 3));
+        if (!capturesOnly) {
+            for (int type = 0; type < 3; type++) {
+                list.add(PackedMove(to - forward, to, PackedMove::PROMOTION + type));
+            }
+        }
+    }
+
+    if (!capturesOnly) {
+        Bitboard quiet = singlePush & ~promotionRow;
+        Bitboard doublePush = shiftForward(singlePush & doublePushRow) & empty;
+        while (quiet) {
+            int to = popLsb(quiet);
+            list.add(PackedMove(to - forward, to, PackedMove::QUIET));
+        }
+        while (doublePush) {
+            int to = popLsb(doublePush);
+            list.add(PackedMove(to - 2 * forward, to, PackedMove::DOUBLE_PUSH));
+        }
+    }
+
+    Bitboard attackers = pawns;
+    while (attackers) {
+        int from = popLsb(attackers);
+        Bitboard captures = pawnAttacks(us, from) & enemies;
+        while (captures) {
+            int to = popLsb(captures);
+            if (squareBit(to) & promotionRow) {
+                list.add(PackedMove(from, to, PackedMove::PROMOTION + PackedMove::CAPTURE + 3));
+                if (!capturesOnly) {
+                    for (int type = 0; type < 3; type++) {
+                        list.add(PackedMove(from, to, PackedMove::PROMOTION + PackedMove::CAPTURE + type));
+                    }
+                }
+            } else {
+                list.add(PackedMove(from, to, PackedMove::CAPTURE));
+            }
+        }
+    }
+
+    if (enPassantSquare >= 0) {
+        Bitboard capturers = pawnAttacks(them, enPassantSquare) & pawns;
+        while (capturers) {
+            list.add(PackedMove(popLsb(capturers), enPassantSquare, PackedMove::EN_PASSANT));
+        }
+    }
+}
+
+void BoardState::generatePieceMoves(MoveList& list, Bitboard targets) const {
+    const PieceColor us = sideToMove;
+    const Bitboard enemies = getPieces(oppositeColor(us));
+    static constexpr PieceType types[5] = {
+        PieceType::KNIGHT, PieceType::BISHOP, PieceType::ROOK, PieceType::QUEEN, PieceType::KING
+    };
+
+    for (PieceType type : types) {
+        Bitboard pieces = getPieces(us, type);
+        while (pieces) {
+            int from = popLsb(pieces);
+            Bitboard attacks = pieceAttacks(type, from, occupied) & targets;
+            while (attacks) {
+                int to = popLsb(attacks);
+                list.add(PackedMove(from, to, (squareBit(to) & enemies) ? PackedMove::CAPTURE : PackedMove::QUIET));
+            }
+        }
+    }
+}
+
+void BoardState::generateCastling(MoveList& list) const {
+    const PieceColor us = sideToMove;
+    const PieceColor them = oppositeColor(us);
+    const int row = (us == PieceColor::WHITE) ? 7 : 0;
+    const int kingSquare = makeSquare(row, 4);
+    const uint8_t kingside = (us == PieceColor::WHITE) ? WHITE_KINGSIDE : BLACK_KINGSIDE;
+    const uint8_t queenside = (us == PieceColor::WHITE) ? WHITE_QUEENSIDE : BLACK_QUEENSIDE;
+    const int rook = makePieceCode(us, PieceType::ROOK);
+
+    if (!(castlingRights & (kingside | queenside))) return;
+    if (mailbox[kingSquare] != makePieceCode(us, PieceType::KING)) return;
+    if (isSquareAttacked(kingSquare, them)) return;
+
+    // The destination square is verified by the usual legality check after makeMove
+    if ((castlingRights & kingside) && mailbox[kingSquare + 3] == rook &&
+        !(occupied & (squareBit(kingSquare + 1) | squareBit(kingSquare + 2))) &&
+        !isSquareAttacked(kingSquare + 1, them)) {
+        list.add(PackedMove(kingSquare, kingSquare + 2, PackedMove::KING_CASTLE));
+    }
+    if ((castlingRights & queenside) && mailbox[kingSquare - 4] == rook &&
+        !(occupied & (squareBit(kingSquare - 1) | squareBit(kingSquare - 2) | squareBit(kingSquare - 3))) &&
+        !isSquareAttacked(kingSquare - 1, them)) {
+        list.add(PackedMove(kingSquare, kingSquare - 2, PackedMove::QUEEN_CASTLE));
+    }
+}
+
+void BoardState::generateMoves(MoveList& list) const {
+    list.count = 0;
+    generatePawnMoves(list, false);
+    generatePieceMoves(list, ~getPieces(sideToMove));
+    generateCastling(list);
+}
+
+void BoardState::generateCaptures(MoveList& list) const {
+    list.count = 0;
+    generatePawnMoves(list, true);
+    generatePieceMoves(list, getPieces(oppositeColor(sideToMove)));
+}
+
+void BoardState::generateLegalMoves(MoveList& list) {
+    MoveList pseudo;
+    generateMoves(pseudo);
+    list.count = 0;
+    for (PackedMove move : pseudo) {
+        UndoInfo undo;
+        makeMove(move, undo);
+        if (wasLegalMove()) list.add(move);
+        unmakeMove(move, undo);
+    }
+}
+
+void BoardState::generateChecks(MoveList& list) const {
+    MoveList all;
+    generateMoves(all);
+    list.count = 0;
+    for (PackedMove move : all) {
+        if (givesCheck(move)) list.add(move);
+    }
+}
+
+bool BoardState::wasLegalMove() const {
+    PieceColor mover = oppositeColor(sideToMove);
+    return !isSquareAttacked(getKingSquare(mover), sideToMove);
+}
+
+bool BoardState::givesCheck(PackedMove move) const {
+    const PieceColor us = sideToMove;
+    const int kingSquare = getKingSquare(oppositeColor(us));
+    const Bitboard kingBit = squareBit(kingSquare);
+    const int from = move.getFrom();
+    const int to = move.getTo();
+    const PieceType type = move.isPromotion() ? move.getPromotionType() : pieceCodeType(mailbox[from]);
+
+    // Occupancy after the move
+    Bitboard occupancy = (occupied ^ squareBit(from)) | squareBit(to);
+    if (move.isEnPassant()) {
+        occupancy ^= squareBit(to + (us == PieceColor::WHITE ? 8 : -8));
+    }
+
+    // Direct check by the moved (or promoted) piece
+    if (type == PieceType::PAWN) {
+        if (pawnAttacks(us, to) & kingBit) return true;
+    } else if (type != PieceType::KING && (pieceAttacks(type, to, occupancy) & kingBit)) {
+        return true;
+    }
+
+    // Check by the rook after castling
+    if (move.isCastling()) {
+        bool kingside = move.getFlags() == PackedMove::KING_CASTLE;
+        int rookFrom = kingside ? to + 1 : to - 2;
+        int rookTo = kingside ? to - 1 : to + 1;
+        occupancy ^= squareBit(rookFrom) | squareBit(rookTo);
+        if (rookAttacks(rookTo, occupancy) & kingBit) return true;
+    }
+
+    // Discovered check by a slider that the moving piece was blocking
+    const Bitboard others = getPieces(us) & ~squareBit(from);
+    const Bitboard queens = getPieces(us, PieceType::QUEEN);
+    const Bitboard diagonal = (getPieces(us, PieceType::BISHOP) | queens) & others;
+    const Bitboard straight = (getPieces(us, PieceType::ROOK) | queens) & others;
+    return (bishopAttacks(kingSquare, occupancy) & diagonal) || (rookAttacks(kingSquare, occupancy) & straight);
+}
+
+PackedMove BoardState::parseUciMove(const std::string& text) {
+    MoveList moves;
+    generateLegalMoves(moves);
+    for (PackedMove move : moves) {
+        if (move.toUci() == text) return move;
+    }
+    return PackedMove::none();
+}
+
+Bitboard BoardState::attackersTo(int square, Bitboard occupancy) const {
+    const Bitboard bishopsQueens = byPiece[makePieceCode(PieceColor::WHITE, PieceType::BISHOP)] |
+                                   byPiece[makePieceCode(PieceColor::BLACK, PieceType::BISHOP)] |
+                                   byPiece[makePieceCode(PieceColor::WHITE, PieceType::QUEEN)] |
+                                   byPiece[makePieceCode(PieceColor::BLACK, PieceType::QUEEN)];
+    const Bitboard rooksQueens = byPiece[makePieceCode(PieceColor::WHITE, PieceType::ROOK)] |
+                                 byPiece[makePieceCode(PieceColor::BLACK, PieceType::ROOK)] |
+                                 byPiece[makePieceCode(PieceColor::WHITE, PieceType::QUEEN)] |
+                                 byPiece[makePieceCode(PieceColor::BLACK, PieceType::QUEEN)];
+
+    return (pawnAttacks(PieceColor::WHITE, square) & getPieces(PieceColor::BLACK, PieceType::PAWN)) |
+           (pawnAttacks(PieceColor::BLACK, square) & getPieces(PieceColor::WHITE, PieceType::PAWN)) |
+           (knightAttacks(square) & (getPieces(PieceColor::WHITE, PieceType::KNIGHT) | getPieces(PieceColor::BLACK, PieceType::KNIGHT))) |
+           (kingAttacks(square) & (getPieces(PieceColor::WHITE, PieceType::KING) | getPieces(PieceColor::BLACK, PieceType::KING))) |
+           (bishopAttacks(square, occupancy) & bishopsQueens) |
+           (rookAttacks(square, occupancy) & rooksQueens);
+}
+
+bool BoardState::isSquareAttacked(int square, PieceColor attackingColor) const {
+    const PieceColor defender = oppositeColor(attackingColor);
+    if (pawnAttacks(defender, square) & getPieces(attackingColor, PieceType::PAWN)) return true;
+    if (knightAttacks(square) & getPieces(attackingColor, PieceType::KNIGHT)) return true;
+    if (kingAttacks(square) & getPieces(attackingColor, PieceType::KING)) return true;
+
+    const Bitboard queens = getPieces(attackingColor, PieceType::QUEEN);
+    if (bishopAttacks(square, occupied) & (getPieces(attackingColor, PieceType::BISHOP) | queens)) return true;
+    return (rookAttacks(square, occupied) & (getPieces(attackingColor, PieceType::ROOK) | queens)) != 0;
+}
+
+bool BoardState::isInCheck() const {
+    return isSquareAttacked(getKingSquare(sideToMove), oppositeColor(sideToMove));
+}
+
+bool BoardState::hasNonPawnMaterial(PieceColor color) const {
+    return (getPieces(color) & ~getPieces(color, PieceType::PAWN) & ~getPieces(color, PieceType::KING)) != 0;
+}
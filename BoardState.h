@@ -0,0 +1,126 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include "Bitboard.h"
+#include "Enums.h"
+#include "PackedMove.h"
+
+// Piece codes used by BoardState: color * 6 + type (PieceType order)
+constexpr int NO_PIECE = 12;
+
+constexpr int makePieceCode(PieceColor color, PieceType type) {
+    return static_cast<int>(color) * 6 + static_cast<int>(type);
+}
+constexpr PieceColor pieceCodeColor(int piece) { return piece < 6 ? PieceColor::WHITE : PieceColor::BLACK; }
+constexpr PieceType pieceCodeType(int piece) { return static_cast<PieceType>(piece % 6); }
+constexpr PieceColor oppositeColor(PieceColor color) {
+    return color == PieceColor::WHITE ? PieceColor::BLACK : PieceColor::WHITE;
+}
+
+// Material key: one 4-bit piece count per piece code, so the key names the
+// exact material on the board and changes by one addition per piece
+constexpr uint64_t materialKeyUnit(int piece) { return 1ULL << (4 * piece); }
+constexpr int materialKeyCount(uint64_t materialKey, int piece) { return static_cast<int>((materialKey >> (4 * piece)) & 0xF); }
+
+// Castling right bits
+constexpr uint8_t WHITE_KINGSIDE = 1;
+constexpr uint8_t WHITE_QUEENSIDE = 2;
+constexpr uint8_t BLACK_KINGSIDE = 4;
+constexpr uint8_t BLACK_QUEENSIDE = 8;
+
+// Longest FEN BoardState::writeFEN() produces (both clocks at 65535)
+constexpr size_t MAX_FEN_LENGTH = 96;
+
+// Everything makeMove() changes that unmakeMove() cannot recompute
+struct UndoInfo {
+    uint64_t key;
+    uint8_t capturedPiece;
+    uint8_t castlingRights;
+    int8_t enPassantSquare;
+    uint16_t halfmoveClock;
+};
+
+// Compact, copyable chess position with bitboards, make/unmake and move
+// generation. This is the representation used by search and tooling; the
+// UI-facing Board keeps its Piece objects.
+class BoardState {
+private:
+    Bitboard byPiece[12];
+    Bitboard byColor[2];
+    Bitboard occupied;
+    uint8_t mailbox[64];
+    PieceColor sideToMove;
+    uint8_t castlingRights;
+    int8_t enPassantSquare;   // -1 when no en passant capture is possible
+    uint16_t halfmoveClock;
+    uint16_t fullmoveNumber;
+    uint64_t key;
+    uint64_t pawnKey;         // Zobrist key of the pawns alone
+    uint64_t materialKey;     // piece counts, see materialKeyUnit()
+
+    // Incremental tapered-eval accumulators (White minus Black, material included)
+    int mgScore;
+    int egScore;
+    int phase;
+
+    void putPiece(int square, int piece);
+    void removePiece(int square);
+    void movePieceBits(int from, int to);
+    void generatePawnMoves(MoveList& list, bool capturesOnly) const;
+    void generatePieceMoves(MoveList& list, Bitboard targets) const;
+    void generateCastling(MoveList& list) const;
+
+public:
+    BoardState();
+
+    void clear();
+    void setStartPosition();
+    // Single pass over the text, no heap allocation; clocks may be omitted
+    bool setFromFEN(std::string_view fen);
+    // Writes at most MAX_FEN_LENGTH characters, no terminator; returns the length
+    size_t writeFEN(char* buffer) const;
+    std::string toFEN() const;
+    uint64_t computeKey() const;
+    uint64_t computePawnKey() const;
+    uint64_t computeMaterialKey() const;
+
+    // Make/unmake; the caller owns the undo record
+    void makeMove(PackedMove move, UndoInfo& undo);
+    void unmakeMove(PackedMove move, const UndoInfo& undo);
+    void makeNullMove(UndoInfo& undo);
+    void unmakeNullMove(const UndoInfo& undo);
+
+    // Pseudo-legal generation; use wasLegalMove() after makeMove to filter
+    void generateMoves(MoveList& list) const;
+    void generateCaptures(MoveList& list) const;
+    void generateLegalMoves(MoveList& list);
+    void generateChecks(MoveList& list) const;
+    bool wasLegalMove() const;
+    bool givesCheck(PackedMove move) const;
+    PackedMove parseUciMove(const std::string& text);
+
+    Bitboard attackersTo(int square, Bitboard occupancy) const;
+    bool isSquareAttacked(int square, PieceColor attackingColor) const;
+    bool isInCheck() const;
+    bool hasNonPawnMaterial(PieceColor color) const;
+
+    // Accessors
+    int getPieceAt(int square) const { return mailbox[square]; }
+    Bitboard getPieces(PieceColor color, PieceType type) const { return byPiece[makePieceCode(color, type)]; }
+    Bitboard getPieces(PieceColor color) const { return byColor[static_cast<int>(color)]; }
+    Bitboard getOccupied() const { return occupied; }
+    int getKingSquare(PieceColor color) const { return Bitboards::lsb(getPieces(color, PieceType::KING)); }
+    PieceColor getSideToMove() const { return sideToMove; }
+    uint8_t getCastlingRights() const { return castlingRights; }
+    int getEnPassantSquare() const { return enPassantSquare; }
+    int getHalfmoveClock() const { return halfmoveClock; }
+    int getFullmoveNumber() const { return fullmoveNumber; }
+    uint64_t getKey() const { return key; }
+    uint64_t getPawnKey() const { return pawnKey; }
+    uint64_t getMaterialKey() const { return materialKey; }
+    int getMidgameScore() const { return mgScore; }
+    int getEndgameScore() const { return egScore; }
+    int getPhase() const { return phase; }
+};
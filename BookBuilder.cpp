@@ -0,0 +1,334 @@
+#include "BookBuilder.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string_view>
+#include "BoardState.h"
+#include "ExternalSort.h"
+#include "PgnReader.h"
+#include "PolyglotBook.h"
+#include "WorkStealingPool.h"
+
+namespace {
+    constexpr size_t BATCH_BYTES = 1 << 20;         // PGN text handed to one task
+    constexpr size_t MERGE_WIDTH = 64;              // runs merged at once
+    constexpr std::string_view GAME_START = "[Event ";
+
+    struct Record {
+        uint64_t key;
+        uint32_t points;     // 2 per win, 1 per draw, for the side that moved
+        uint32_t games;
+        uint16_t move;       // Polyglot encoding
+    };
+
+    bool recordLess(const Record& a, const Record& b) {
+        return a.key != b.key ? a.key < b.key : a.move < b.move;
+    }
+
+    // Folds record into into when both are the same move of the same position
+    bool combineRecords(Record& into, const Record& record) {
+        if (into.key != record.key || into.move != record.move) return false;
+        into.points += record.points;
+        into.games += record.games;
+        return true;
+    }
+
+    // Sorts and folds records with the same key and move into one
+    void sortAndCombine(std::vector<Record>& records) {
+        std::sort(records.begin(), records.end(), recordLess);
+        size_t out = 0;
+        for (size_t i = 0; i < records.size(); i++) {
+            if (out == 0 || !combineRecords(records[out - 1], records[i])) records[out++] = records[i];
+        }
+        records.resize(out);
+    }
+
+    // K-way merge of sorted runs, folding equal records; emit receives them in order
+    template <typename Emit>
+    void mergeRuns(const std::vector<std::string>& paths, size_t bufferRecords, Emit&& emit) {
+        bool pending = false;
+        Record current{};
+        ExternalSort::mergeRuns<Record>(paths, bufferRecords, recordLess, [&](const Record& record) {
+            if (pending && combineRecords(current, record)) return;
+            if (pending) emit(current);
+            current = record;
+            pending = true;
+        });
+        if (pending) emit(current);
+    }
+
+    // Collects the records of one position and writes its book entries
+    class BookWriter {
+    private:
+        std::ofstream out;
+        uint32_t minGames;
+        std::vector<Record> group;
+        std::vector<Polyglot::Entry> entries;
+        uint64_t positions = 0;
+        uint64_t written = 0;
+
+        void flush() {
+            entries.clear();
+            uint32_t maxPoints = 0;
+            for (const Record& record : group) {
+                if (record.games >= minGames) maxPoints = std::max(maxPoints, record.points);
+            }
+            for (const Record& record : group) {
+                if (record.games < minGames) continue;
+                const uint64_t weight = maxPoints > 0xFFFF ? uint64_t{ record.points } * 0xFFFF / maxPoints : record.points;
+                if (weight > 0) entries.push_back(Polyglot::Entry{ record.key, record.move, static_cast<uint16_t>(weight), 0 });
+            }
+            group.clear();
+            if (entries.empty()) return;
+
+            std::stable_sort(entries.begin(), entries.end(), [](const Polyglot::Entry& a, const Polyglot::Entry& b) {
+                return a.weight > b.weight;
+            });
+            for (const Polyglot::Entry& entry : entries) {
+                uint8_t bytes[Polyglot::ENTRY_SIZE];
+                Polyglot::writeEntry(entry, bytes);
+                out.write(reinterpret_cast<const char*>(bytes), sizeof(bytes));
+            }
+            positions++;
+            written += entries.size();
+        }
+
+    public:
+        BookWriter(const std::string& path, uint32_t minimumGames)
+            : out(path, std::ios::binary), minGames(minimumGames) {
+            if (!out.is_open()) throw std::runtime_error("Could not write " + path);
+        }
+
+        void add(const Record& record) {
+            if (!group.empty() && group.front().key != record.key) flush();
+            group.push_back(record);
+        }
+
+        void finish(const std::string& path) {
+            flush();
+            out.close();
+            if (!out) throw std::runtime_error("Could not write " + path);
+        }
+
+        uint64_t getPositions() const { return positions; }
+        uint64_t getEntries() const { return written; }
+    };
+
+    // Everything one worker accumulates
+    struct WorkerState {
+        std::vector<Record> records;
+        uint64_t games = 0;
+        uint64_t skipped = 0;
+        uint64_t replayed = 0;
+    };
+
+    // Replays the first plies of one game into records; false when the game is unusable
+    bool replayGame(const PgnGame& game, int plies, std::vector<Record>& records, uint64_t& replayed) {
+        const std::string_view result = game.getTag("Result");
+        uint32_t whitePoints;
+        if (result == "1-0") whitePoints = 2;
+        else if (result == "0-1") whitePoints = 0;
+        else if (result == "1/2-1/2") whitePoints = 1;
+        else return false;
+        if (plies <= 0) return true;
+
+        BoardState board;
+        int ply = 0;
+        const bool legal = Pgn::replay(game, board, [&](const BoardState& before, PackedMove move) {
+            const bool whiteMoved = before.getSideToMove() == PieceColor::WHITE;
+            records.push_back(Record{ Polyglot::key(before), whiteMoved ? whitePoints : 2 - whitePoints, 1,
+                                      Polyglot::encodeMove(move) });
+            replayed++;
+            return ++ply < plies;
+        });
+        return legal || ply > 0;
+    }
+
+    void processBatch(const std::string& batch, const BookBuilder::Options& options, size_t capacity,
+                      WorkerState& state, ExternalSort::RunFiles& runs) {
+        const std::string_view text(batch);
+        const size_t start = text.find(GAME_START);
+        if (start == std::string_view::npos) return;
+        PgnReader reader(text.substr(start));
+        PgnGame game;
+        while (reader.next(game)) {
+            if (replayGame(game, options.plies, state.records, state.replayed)) state.games++;
+            else state.skipped++;
+
+            if (state.records.size() >= capacity) {
+                sortAndCombine(state.records);
+                // Spill once combining frees less than half of the share
+                if (state.records.size() >= capacity / 2) {
+                    ExternalSort::writeRun(state.records, runs.create());
+                    state.records.clear();
+                }
+            }
+        }
+    }
+}
+
+BookBuilder::Report BookBuilder::build(const Options& options) {
+    const auto start = std::chrono::steady_clock::now();
+    const int threads = std::max(1, options.threads);
+    const size_t budget = std::max<size_t>(options.memoryMegabytes, 16) * 1024 * 1024;
+    // Batches in flight take 2 per thread; records get three quarters of the rest
+    const size_t inFlightBytes = 2 * static_cast<size_t>(threads) * BATCH_BYTES;
+    const size_t recordBytes = budget > 2 * inFlightBytes ? (budget - inFlightBytes) * 3 / 4 : budget / 2;
+    const size_t capacity = std::max<size_t>(recordBytes / sizeof(Record) / static_cast<size_t>(threads), 1024);
+
+    Report report;
+    ExternalSort::RunFiles runs(options.outputPath);
+    std::vector<WorkerState> states(static_cast<size_t>(threads));
+    for (auto& state : states) state.records.reserve(capacity);
+
+    std::mutex flightMutex;
+    std::condition_variable batchDone;
+    size_t inFlight = 0;
+    std::exception_ptr failure;     // first worker error, rethrown once the pool is done
+    auto lastReport = start;
+    {
+        WorkStealingPool pool(threads);
+        for (const std::string& input : options.inputs) {
+            std::ifstream in(input, std::ios::binary);
+            if (!in.is_open()) throw std::runtime_error("Could not open " + input);
+
+            std::string carry;
+            std::vector<char> chunk(BATCH_BYTES);
+            while (in) {
+                in.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+                const size_t got = static_cast<size_t>(in.gcount());
+                report.inputBytes += got;
+                carry.append(chunk.data(), got);
+
+                // Hand over whole games only; the last one may continue in the next chunk
+                size_t cut = in ? carry.rfind(GAME_START) : carry.size();
+                if (cut == std::string::npos || cut == 0) {
+                    if (in) continue;
+                    cut = carry.size();
+                }
+                auto batch = std::make_shared<std::string>(carry.substr(0, cut));
+                carry.erase(0, cut);
+
+                std::unique_lock<std::mutex> lock(flightMutex);
+                batchDone.wait(lock, [&] { return inFlight < 2 * static_cast<size_t>(threads); });
+                inFlight++;
+                lock.unlock();
+                pool.submit([&, batch](int worker) {
+                    try {
+                        processBatch(*batch, options, capacity, states[worker], runs);
+                    }
+                    catch (...) {
+                        std::lock_guard<std::mutex> guard(flightMutex);
+                        if (!failure) failure = std::current_exception();
+                    }
+                    std::lock_guard<std::mutex> guard(flightMutex);
+                    inFlight--;
+                    batchDone.notify_one();
+                });
+
+                const auto now = std::chrono::steady_clock::now();
+                if (now - lastReport > std::chrono::seconds(2)) {
+                    uint64_t games = 0;
+                    for (const auto& state : states) games += state.games;   // approximate while workers run
+                    const double seconds = std::chrono::duration<double>(now - start).count();
+                    std::cout << "  " << games << " games, " << static_cast<uint64_t>(games / seconds) << " games/s, "
+                              << report.inputBytes / (1024 * 1024) << " MB read\n";
+                    lastReport = now;
+                }
+            }
+        }
+        pool.wait();
+    }
+    if (failure) std::rethrow_exception(failure);
+
+    for (const auto& state : states) {
+        report.games += state.games;
+        report.skippedGames += state.skipped;
+        report.records += state.replayed;
+    }
+
+    const std::string temporaryPath = options.outputPath + ".tmp";
+    BookWriter writer(temporaryPath, options.minGames);
+    if (runs.getCreated() == 0) {
+        // Everything fit in memory
+        std::vector<Record> all = std::move(states[0].records);
+        for (auto& state : states) {
+            all.insert(all.end(), state.records.begin(), state.records.end());
+            std::vector<Record>().swap(state.records);
+        }
+        sortAndCombine(all);
+        for (const Record& record : all) writer.add(record);
+    } else {
+        for (auto& state : states) {
+            if (!state.records.empty()) {
+                sortAndCombine(state.records);
+                ExternalSort::writeRun(state.records, runs.create());
+            }
+            std::vector<Record>().swap(state.records);
+        }
+        std::vector<std::string> pending = runs.getPaths();
+        report.runs = pending.size();
+
+        const size_t bufferRecords = std::max<size_t>(budget / (MERGE_WIDTH + 1) / sizeof(Record), 1024);
+        pending = ExternalSort::reduceRuns<Record>(runs, pending, MERGE_WIDTH, bufferRecords, recordLess, combineRecords);
+        mergeRuns(pending, bufferRecords, [&](const Record& record) { writer.add(record); });
+    }
+    writer.finish(temporaryPath);
+    std::filesystem::rename(temporaryPath, options.outputPath);
+
+    report.positions = writer.getPositions();
+    report.entries = writer.getEntries();
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return report;
+}
+
+int BookBuilder::run(const std::vector<std::string>& args) {
+    Options options;
+    options.threads = WorkStealingPool::defaultThreadCount();
+    bool valid = true;
+    Polyglot::loadDefaultRandom64();
+    for (size_t i = 0; i < args.size(); i++) {
+        if (args[i] == "--out" && i + 1 < args.size()) {
+            options.outputPath = args[++i];
+        } else if (args[i] == "--plies" && i + 1 < args.size()) {
+            options.plies = std::stoi(args[++i]);
+        } else if (args[i] == "--threads" && i + 1 < args.size()) {
+            options.threads = std::max(1, std::stoi(args[++i]));
+        } else if (args[i] == "--memory" && i + 1 < args.size()) {
+            options.memoryMegabytes = std::stoull(args[++i]);
+        } else if (args[i] == "--random64" && i + 1 < args.size()) {
+            Polyglot::loadRandom64(args[++i]);
+        } else if (args[i] == "--min-games" && i + 1 < args.size()) {
+            options.minGames = static_cast<uint32_t>(std::stoul(args[++i]));
+        } else if (args[i].rfind("--", 0) != 0) {
+            options.inputs.push_back(args[i]);
+        } else {
+            valid = false;
+        }
+    }
+    if (!valid || options.inputs.empty()) {
+        std::cerr << "Usage: bookbuild <games.pgn>... [--out <book.bin>] [--plies N] [--threads N] [--memory MB] [--min-games N] [--random64 <file>]\n";
+        return 1;
+    }
+
+    const Report report = build(options);
+    const double seconds = report.seconds > 0.0 ? report.seconds : 1e-9;
+    std::cout << "Replayed " << report.games << " games (" << report.skippedGames << " skipped) with "
+              << options.threads << " threads in " << report.seconds << " s: "
+              << static_cast<uint64_t>(report.games / seconds) << " games/s, "
+              << report.inputBytes / seconds / (1024 * 1024) << " MB/s\n"
+              << "  " << report.records << " moves, " << report.runs << " runs spilled to disk\n"
+              << "Wrote " << report.entries << " entries for " << report.positions << " positions to "
+              << options.outputPath << "\n";
+    if (!Polyglot::hasStandardRandom64()) {
+        std::cout << "Keys use the built-in Random64 table; the book reads back with this program only\n";
+    }
+    return 0;
+}
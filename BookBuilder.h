@@ -0,0 +1,42 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Builds Polyglot opening books from PGN files (command bookbuild). Games
+// are read in large batches and replayed in parallel; every move of the
+// first N plies becomes a (key, move, points) record, 2 points for a win
+// and 1 for a draw from the side that played it.
+//
+// Memory stays bounded: each worker keeps a fixed share of the budget,
+// merges duplicate records when it fills up and spills a sorted run to
+// disk once merging no longer frees enough room. Runs are k-way merged
+// (in several passes for very large inputs) into the final book, where a
+// move's weight is its points scaled to 16 bits per position.
+namespace BookBuilder {
+    struct Options {
+        std::vector<std::string> inputs;
+        std::string outputPath = "book.bin";
+        int plies = 20;
+        int threads = 1;
+        size_t memoryMegabytes = 256;    // record buffers and merge buffers together
+        uint32_t minGames = 1;           // moves played in fewer games are left out
+    };
+
+    struct Report {
+        uint64_t games = 0;
+        uint64_t skippedGames = 0;       // no result, bad FEN or unreadable moves
+        uint64_t inputBytes = 0;
+        uint64_t records = 0;            // moves replayed within the ply limit
+        size_t runs = 0;                 // sorted runs spilled to disk
+        uint64_t positions = 0;
+        uint64_t entries = 0;
+        double seconds = 0.0;
+    };
+
+    // Throws std::runtime_error on I/O errors
+    Report build(const Options& options);
+
+    int run(const std::vector<std::string>& args);
+}
@@ -0,0 +1,9 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace Checksum {
+    // CRC-32 (IEEE 802.3, as in zip and PNG). Pass the previous result as crc
+    // to continue over data split across calls.
+    uint32_t crc32(const void* data, size_t size, uint32_t crc = 0);
+}
@@ -0,0 +1,356 @@
+#include "CommandLine.h"
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "BatchAnalysis.h"
+#include "Benchmark.h"
+#include "BookBuilder.h"
+#include "Constants.h"
+#include "GameArchive.h"
+#include "GameCodec.h"
+#include "BoardState.h"
+#include "MateSolver.h"
+#include "Nnue.h"
+#include "PgnReader.h"
+#include "PositionDatabase.h"
+#include "ResultsStore.h"
+#include "PolyglotBook.h"
+#include "TablebaseGenerator.h"
+#include "TablebaseProber.h"
+#include "Tuner.h"
+
+namespace {
+    void printUsage() {
+        std::cout << "Usage: Schack [command] [options]\n";
+        std::cout << "Without a command the graphical game starts.\n\n";
+        std::cout << "Commands:\n";
+        std::cout << "  bench [--depth D | --movetime ms] [--multipv K] [--nnue <file>] [--eval-cache KB] [--json <file>]\n";
+        std::cout << "                                      Search benchmark with telemetry\n";
+        std::cout << "  mate <fen> | --file <fens.txt> [--max N] [--nodes N] [--all-moves]\n";
+        std::cout << "                                      Prove forced mates (checks only by default)\n";
+        std::cout << "  analyze-batch <file.epd> [--threads N] [--depth D | --nodes N] [--hash MB] [--tb <dir>] [--out <file>]\n";
+        std::cout << "                                      Analyze EPD positions in parallel, JSON lines in input order\n";
+        std::cout << "  nnue-bench <network.nnue> [--depth D] [--json <file>]\n";
+        std::cout << "                                      NNUE evaluation throughput per SIMD kernel\n";
+        std::cout << "  nnue-init <network.nnue> [--seed N]  Write a randomly initialised network\n";
+        std::cout << "  fen-bench [fens.txt] [--seconds S]  FEN parse/write throughput and round-trip check\n";
+        std::cout << "  san-bench [--games N] [--seed S]    SAN write/parse throughput and round-trip check\n";
+        std::cout << "  journal-bench [--moves N] [--interval us] [--file <path>]\n";
+        std::cout << "                                      Move journal append latency, group commit and recovery\n";
+        std::cout << "  tune <positions.epd> [--threads N] [--epochs N] [--rate cp] [--out <file.h>]\n";
+        std::cout << "                                      Fit material values to game results (writes TunedParameters.h)\n";
+        std::cout << "  tbgen <signature>... [--dir <path>] [--threads N] [--memory MB]\n";
+        std::cout << "                                      Generate endgame tablebases (up to 5 pieces, e.g. KRPvKR)\n";
+        std::cout << "  tbprobe <fen> [--dir <path>]        Tablebase result of a position and of each legal move\n";
+        std::cout << "  bookbuild <games.pgn>... [--out <book.bin>] [--plies N] [--threads N] [--memory MB] [--min-games N]\n";
+        std::cout << "                                      Build a Polyglot book from PGN games (external sort, bounded memory)\n";
+        std::cout << "  book <book.bin> [fen] [--random64 <file>] [--seed N] | book --check\n";
+        std::cout << "                                      Polyglot book moves of a position (start position by default)\n";
+        std::cout << "  pgnread <games.pgn>... [--no-replay] [--variations]\n";
+        std::cout << "                                      Stream PGN files, replay every game, report games/s and MB/s\n";
+        std::cout << "  gamepack <games.pgn>... [--out <games.bin>]\n";
+        std::cout << "                                      Convert PGN to binary game records, compare size and load time\n";
+        std::cout << "  results import <match_results.txt>... | index | player <name> | h2h <a> <b> | top [N] [--min-games N] [--store <file>]\n";
+        std::cout << "                                      Match results store: import text results, per-player queries\n";
+        std::cout << "  posdb build <games.pgn>... [--out <positions.db>] [--plies N] [--threads N] [--memory MB]\n";
+        std::cout << "  posdb query <positions.db> [fen] [--moves \"e4 e5 Nf3\"] [--games N]\n";
+        std::cout << "                                      Position database: games, results and next moves of a position\n";
+        std::cout << "  archive pack <games.pgn>... [--out <games_archive.bin>] [--threads N] [--level 0-9] [--block KB]\n";
+        std::cout << "  archive get <games_archive.bin> <game id>... | export <games_archive.bin> <games.pgn> [--threads N]\n";
+        std::cout << "                                      Block-compressed game archive with random access by game id\n";
+    }
+
+    void printMateResult(const MateResult& result) {
+        if (result.found) {
+            std::cout << "mate in " << result.mateIn << ":";
+            for (PackedMove move : result.line) {
+                std::cout << " " << move.toUci();
+            }
+        } else {
+            std::cout << (result.aborted ? "unknown (node limit)" : "no mate found");
+        }
+        std::cout << " | proof size " << result.proofSize
+                  << " | nodes " << result.nodes
+                  << " | " << static_cast<int>(result.seconds * 1000.0) << " ms\n";
+    }
+
+    int runMate(const std::vector<std::string>& args) {
+        MateSolver::Options options;
+        std::vector<std::string> fens;
+        std::string fenFile;
+
+        for (size_t i = 0; i < args.size(); i++) {
+            if (args[i] == "--max" && i + 1 < args.size()) {
+                options.maxMoves = std::stoi(args[++i]);
+            } else if (args[i] == "--nodes" && i + 1 < args.size()) {
+                options.maxNodes = std::stoull(args[++i]);
+            } else if (args[i] == "--file" && i + 1 < args.size()) {
+                fenFile = args[++i];
+            } else if (args[i] == "--all-moves") {
+                options.checksOnly = false;
+            } else {
+                fens.push_back(args[i]);
+            }
+        }
+
+        if (!fenFile.empty()) {
+            std::ifstream file(fenFile);
+            if (!file.is_open()) {
+                std::cerr << "Could not open " << fenFile << "\n";
+                return 1;
+            }
+            std::string line;
+            while (std::getline(file, line)) {
+                if (!line.empty()) fens.push_back(line);
+            }
+        }
+        if (fens.empty()) {
+            printUsage();
+            return 1;
+        }
+
+        MateSolver solver;
+        int solved = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (const auto& fen : fens) {
+            BoardState position;
+            if (!position.setFromFEN(fen)) {
+                std::cerr << "Skipping invalid FEN: " << fen << "\n";
+                continue;
+            }
+            MateResult result = solver.solve(position, options);
+            if (fens.size() > 1) std::cout << fen << " | ";
+            printMateResult(result);
+            if (result.found) solved++;
+        }
+
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (fens.size() > 1) {
+            std::cout << "\nSolved " << solved << "/" << fens.size() << " in " << seconds << " s ("
+                      << static_cast<int>(seconds > 0.0 ? fens.size() * 60.0 / seconds : 0.0)
+                      << " puzzles/minute)\n";
+        }
+        return 0;
+    }
+
+    const char* wdlName(int wdl) {
+        return wdl > 0 ? "win" : wdl < 0 ? "loss" : "draw";
+    }
+
+    int runTbProbe(const std::vector<std::string>& args) {
+        std::string directory = ".";
+        std::string fen;
+        for (size_t i = 0; i < args.size(); i++) {
+            if (args[i] == "--dir" && i + 1 < args.size()) {
+                directory = args[++i];
+            } else {
+                fen += (fen.empty() ? "" : " ") + args[i];
+            }
+        }
+        BoardState position;
+        if (fen.empty() || !position.setFromFEN(fen)) {
+            printUsage();
+            return 1;
+        }
+
+        TablebaseProber prober(directory);
+        TablebaseProbe probe;
+        if (!prober.probe(position, probe)) {
+            std::cout << "Not in the tablebases (" << prober.getTableCount() << " tables in " << directory << ")\n";
+            return 1;
+        }
+        std::cout << (position.getSideToMove() == PieceColor::WHITE ? "White" : "Black") << " to move: "
+                  << wdlName(probe.wdl) << ", DTZ " << probe.dtz << "\n";
+
+        // Results after each move, from the mover's side; the best move wins
+        // fastest or loses slowest, counting a capture or pawn move as DTZ 0
+        MoveList moves;
+        position.generateLegalMoves(moves);
+        PackedMove best = PackedMove::none();
+        int bestRank = 0;
+        for (int i = 0; i < moves.size(); i++) {
+            UndoInfo undo;
+            position.makeMove(moves[i], undo);
+            TablebaseProbe child;
+            const bool found = prober.probe(position, child);
+            const bool zeroing = position.getHalfmoveClock() == 0;
+            position.unmakeMove(moves[i], undo);
+
+            std::cout << "  " << moves[i].toUci() << "  ";
+            if (!found) {
+                std::cout << "unknown\n";
+                continue;
+            }
+            std::cout << wdlName(-child.wdl) << ", DTZ " << child.dtz << "\n";
+            const int distance = zeroing ? 0 : child.dtz + 1;
+            const int rank = -child.wdl > 0 ? 2000 - distance : -child.wdl < 0 ? distance - 2000 : 0;
+            if (best.isNone() || rank > bestRank) {
+                best = moves[i];
+                bestRank = rank;
+            }
+        }
+        if (!best.isNone()) std::cout << "best move " << best.toUci() << "\n";
+        return 0;
+    }
+
+    int runBook(const std::vector<std::string>& args) {
+        std::string bookPath;
+        std::string fen;
+        uint64_t seed = static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+        bool check = false;
+        Polyglot::loadDefaultRandom64();
+        for (size_t i = 0; i < args.size(); i++) {
+            if (args[i] == "--random64" && i + 1 < args.size()) {
+                Polyglot::loadRandom64(args[++i]);
+            } else if (args[i] == "--check") {
+                check = true;
+            } else if (args[i] == "--seed" && i + 1 < args.size()) {
+                seed = std::stoull(args[++i]);
+            } else if (bookPath.empty()) {
+                bookPath = args[i];
+            } else {
+                fen += (fen.empty() ? "" : " ") + args[i];
+            }
+        }
+        if (check) {
+            // Start position key against the one published with the format
+            if (!Polyglot::hasStandardRandom64()) {
+                std::cout << "FAIL: no standard Random64 table (" << ChessConstants::POLYGLOT_RANDOM_FILE
+                          << " or --random64)\n";
+                return 1;
+            }
+            BoardState start;
+            start.setStartPosition();
+            const bool passed = Polyglot::checkStartKey();
+            std::cout << (passed ? "OK" : "FAIL") << ": start position key " << std::hex
+                      << Polyglot::key(start) << std::dec << ", expected 463b96181691fc9c\n";
+            return passed ? 0 : 1;
+        }
+        BoardState position;
+        if (fen.empty()) fen = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+        if (bookPath.empty() || !position.setFromFEN(fen)) {
+            printUsage();
+            return 1;
+        }
+        if (!Polyglot::hasStandardRandom64()) {
+            std::cout << "Note: built-in Random64 table, only books written by bookbuild will match (see --random64)\n";
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        PolyglotBook book(bookPath);
+        const double openMicroseconds = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        start = std::chrono::steady_clock::now();
+        const std::vector<BookMove> moves = book.probe(position);
+        const double probeMicroseconds = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << bookPath << ": " << book.getEntryCount() << " entries, opened in " << openMicroseconds
+                  << " us, probed in " << probeMicroseconds << " us\n";
+        std::cout << "key " << std::hex << Polyglot::key(position) << std::dec << "\n";
+        if (moves.empty()) {
+            std::cout << "out of book\n";
+            return 0;
+        }
+        uint64_t total = 0;
+        for (const BookMove& move : moves) total += move.weight;
+        for (const BookMove& move : moves) {
+            std::cout << "  " << move.move.toUci() << "  weight " << move.weight;
+            if (total > 0) std::cout << " (" << move.weight * 100 / total << "%)";
+            std::cout << "\n";
+        }
+        std::mt19937_64 random(seed);
+        std::cout << "best move " << book.bestMove(position).toUci()
+                  << ", weighted pick " << book.weightedMove(position, random()).toUci() << "\n";
+        return 0;
+    }
+
+    int runNnueInit(const std::vector<std::string>& args) {
+        std::string path;
+        uint32_t seed = 1;
+        for (size_t i = 0; i < args.size(); i++) {
+            if (args[i] == "--seed" && i + 1 < args.size()) {
+                seed = static_cast<uint32_t>(std::stoul(args[++i]));
+            } else {
+                path = args[i];
+            }
+        }
+        if (path.empty()) {
+            printUsage();
+            return 1;
+        }
+        NnueNetwork::writeRandom(path, seed);
+        NnueNetwork check(path);
+        std::cout << "Wrote random network to " << path << " (seed " << seed << ")\n";
+        return 0;
+    }
+}
+
+int CommandLine::run(int argc, char* argv[]) {
+    std::string command = argv[1];
+    std::vector<std::string> args(argv + 2, argv + argc);
+
+    try {
+        if (command == "bench") {
+            return Benchmark::run(args);
+        }
+        if (command == "mate") {
+            return runMate(args);
+        }
+        if (command == "analyze-batch") {
+            return BatchAnalysis::run(args);
+        }
+        if (command == "nnue-bench") {
+            return Benchmark::runNnue(args);
+        }
+        if (command == "fen-bench") {
+            return Benchmark::runFen(args);
+        }
+        if (command == "san-bench") {
+            return Benchmark::runSan(args);
+        }
+        if (command == "journal-bench") {
+            return Benchmark::runJournal(args);
+        }
+        if (command == "nnue-init") {
+            return runNnueInit(args);
+        }
+        if (command == "tune") {
+            return Tuner::run(args);
+        }
+        if (command == "tbgen") {
+            return TablebaseGenerator::run(args);
+        }
+        if (command == "tbprobe") {
+            return runTbProbe(args);
+        }
+        if (command == "bookbuild") {
+            return BookBuilder::run(args);
+        }
+        if (command == "pgnread") {
+            return Pgn::run(args);
+        }
+        if (command == "gamepack") {
+            return GameCodec::run(args);
+        }
+        if (command == "results") {
+            return Results::run(args);
+        }
+        if (command == "posdb") {
+            return PositionDb::run(args);
+        }
+        if (command == "archive") {
+            return Archive::run(args);
+        }
+        if (command == "book") {
+            return runBook(args);
+        }
+        printUsage();
+        return (command == "help" || command == "--help") ? 0 : 1;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+// Headless entry points, selected by the first command-line argument
+// (e.g. "Schack.exe bench"). Without arguments the GUI game starts.
+namespace CommandLine {
+    int run(int argc, char* argv[]);
+}
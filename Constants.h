@@ -1,4 +1,5 @@
 #pragma once
+#include "TunedParameters.h"
 
 namespace ChessConstants {
     // Board dimensions
@@ -11,18 +12,39 @@ namespace ChessConstants {
     // Game rules
     constexpr int HALFMOVE_DRAW_LIMIT = 100;  // 50-move rule (100 halfmoves)
     constexpr int REPETITION_DRAW_LIMIT = 3;   // Threefold repetition
+
+    // Analysis mode
+    constexpr int ANALYSIS_LINES = 3;          // Best moves shown as arrows
+    constexpr int ANALYSIS_MAX_DEPTH = 32;
+    constexpr int ANALYSIS_HASH_MB = 32;
+    constexpr const char* TABLEBASE_DIRECTORY = "tablebases";  // Probed by analysis when present
+
+    // Opening book (Polyglot), both optional
+    constexpr const char* BOOK_FILE = "book.bin";
+    constexpr const char* POLYGLOT_RANDOM_FILE = "polyglot-random64.txt";  // Random64 table for third-party books
+
+    // Player names when none is entered at startup
+    constexpr const char* DEFAULT_WHITE_NAME = "White Player";
+    constexpr const char* DEFAULT_BLACK_NAME = "Black Player";
     
-    // Material values (for evaluation)
-    constexpr int PAWN_VALUE = 1;
-    constexpr int KNIGHT_VALUE = 3;
-    constexpr int BISHOP_VALUE = 3;
-    constexpr int ROOK_VALUE = 5;
-    constexpr int QUEEN_VALUE = 9;
+    // Material values in centipawns (for evaluation), midgame and endgame;
+    // fitted by the tuner into TunedParameters.h
+    constexpr int PAWN_VALUE = TunedParameters::PAWN_MG;
+    constexpr int KNIGHT_VALUE = TunedParameters::KNIGHT_MG;
+    constexpr int BISHOP_VALUE = TunedParameters::BISHOP_MG;
+    constexpr int ROOK_VALUE = TunedParameters::ROOK_MG;
+    constexpr int QUEEN_VALUE = TunedParameters::QUEEN_MG;
+    constexpr int PAWN_VALUE_EG = TunedParameters::PAWN_EG;
+    constexpr int KNIGHT_VALUE_EG = TunedParameters::KNIGHT_EG;
+    constexpr int BISHOP_VALUE_EG = TunedParameters::BISHOP_EG;
+    constexpr int ROOK_VALUE_EG = TunedParameters::ROOK_EG;
+    constexpr int QUEEN_VALUE_EG = TunedParameters::QUEEN_EG;
     
     // UI rendering constants
     constexpr float MOVE_HINT_DOT_RADIUS = 0.15f;      // Radius for empty square hints
     constexpr float MOVE_HINT_RING_RADIUS = 0.45f;     // Radius for capture hints
     constexpr float MOVE_HINT_RING_THICKNESS = 4.0f;   // Border thickness for capture ring
+    constexpr float ANALYSIS_ARROW_WIDTH = 0.15f;      // Arrow shaft width (fraction of a square)
     
     // Colors (RGB)
     namespace Colors {
@@ -49,7 +71,9 @@ namespace ChessConstants {
     namespace Assets {
         constexpr const char* BOARD_TEXTURE = "assets/board.jpg";
         constexpr const char* FONT_PATH = "C:\\Windows\\Fonts\\arial.ttf";
-        constexpr const char* HISTORY_FILE = "game_history.txt";
+        constexpr const char* HISTORY_FILE = "game_history.bin";
+        constexpr const char* JOURNAL_FILE = "game_journal.bin";
         constexpr const char* RESULTS_FILE = "match_results.txt";
+        constexpr const char* RESULTS_STORE = "match_results.bin";
     }
 }
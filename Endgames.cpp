@@ -0,0 +1,186 @@
+#include "Endgames.h"
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
+#include <unordered_map>
+#include "Evaluation.h"
+#include "KpkBitbase.h"
+
+namespace {
+    using Bitboards::colOf;
+    using Bitboards::rowOf;
+
+    int distance(int a, int b) {
+        return std::max(std::abs(rowOf(a) - rowOf(b)), std::abs(colOf(a) - colOf(b)));
+    }
+
+    // 0 in the four centre squares, 6 in the corners
+    int centerDistance(int square) {
+        const int col = colOf(square);
+        const int row = rowOf(square);
+        return (col < 4 ? 3 - col : col - 4) + (row < 4 ? 3 - row : row - 4);
+    }
+
+    // Drive the weak king to the edge and bring the strong king next to it
+    int pushToEdge(int square) { return 20 * centerDistance(square); }
+    int pushClose(int a, int b) { return 140 - 20 * distance(a, b); }
+
+    int nonPawnMaterial(const BoardState& state, PieceColor color) {
+        int total = 0;
+        for (PieceType type : { PieceType::QUEEN, PieceType::ROOK, PieceType::BISHOP, PieceType::KNIGHT }) {
+            total += Evaluation::pieceValue(type) * Bitboards::popCount(state.getPieces(color, type));
+        }
+        return total;
+    }
+
+    bool isLightSquare(int square) {
+        return ((rowOf(square) + colOf(square)) & 1) == 0;   // a8 is light
+    }
+
+    int evaluateDraw(const BoardState&, PieceColor) {
+        return 0;
+    }
+
+    // Mating material against a lone king (KQK, KRK, KBBK, ...)
+    int evaluateKXK(const BoardState& state, PieceColor strong) {
+        const PieceColor weak = oppositeColor(strong);
+        const Bitboard bishops = state.getPieces(strong, PieceType::BISHOP);
+        const bool bishopPairOnOneColor = bishops != 0 && state.getPieces(strong, PieceType::QUEEN) == 0 &&
+                                          state.getPieces(strong, PieceType::ROOK) == 0 &&
+                                          ((bishops & Bitboards::LIGHT_SQUARES) == 0 ||
+                                           (bishops & ~Bitboards::LIGHT_SQUARES) == 0);
+        if (bishopPairOnOneColor) return 0;
+
+        const int weakKing = state.getKingSquare(weak);
+        const int strongKing = state.getKingSquare(strong);
+        return Endgames::KNOWN_WIN + nonPawnMaterial(state, strong) +
+               pushToEdge(weakKing) + pushClose(strongKing, weakKing);
+    }
+
+    // Bishop and knight mate only in a corner of the bishop's color
+    int evaluateKBNK(const BoardState& state, PieceColor strong) {
+        const PieceColor weak = oppositeColor(strong);
+        const int weakKing = state.getKingSquare(weak);
+        const int strongKing = state.getKingSquare(strong);
+        const int bishop = Bitboards::lsb(state.getPieces(strong, PieceType::BISHOP));
+        const int cornerA = isLightSquare(bishop) ? 0 : 7;     // a8 or h8
+        const int cornerB = isLightSquare(bishop) ? 63 : 56;   // h1 or a1
+        const int cornerDistance = std::min(distance(weakKing, cornerA), distance(weakKing, cornerB));
+        return Endgames::KNOWN_WIN + nonPawnMaterial(state, strong) +
+               200 - 30 * cornerDistance + pushClose(strongKing, weakKing);
+    }
+
+    // Queen against rook wins, but only by pushing the defending king to the edge
+    int evaluateKQKR(const BoardState& state, PieceColor strong) {
+        const PieceColor weak = oppositeColor(strong);
+        const int weakKing = state.getKingSquare(weak);
+        const int strongKing = state.getKingSquare(strong);
+        return Evaluation::pieceValue(PieceType::QUEEN) - Evaluation::pieceValue(PieceType::ROOK) +
+               pushToEdge(weakKing) + pushClose(strongKing, weakKing);
+    }
+
+    // King and pawn against king is exact from the bitbase; won positions
+    // prefer a more advanced pawn so the search makes progress towards KQK
+    int evaluateKPK(const BoardState& state, PieceColor strong) {
+        if (!KpkBitbase::probe(state, strong)) return 0;
+        const int pawn = Bitboards::lsb(state.getPieces(strong, PieceType::PAWN));
+        const int rank = strong == PieceColor::WHITE ? 7 - rowOf(pawn) : rowOf(pawn);
+        return Endgames::KNOWN_WIN + Evaluation::pieceValue(PieceType::PAWN) + 20 * rank;
+    }
+
+    // Rook against a minor piece is usually a draw
+    int scaleRookVersusMinor(const BoardState&, PieceColor) {
+        return 12;
+    }
+
+    struct Registration {
+        const char* signature;
+        Endgames::EvaluateFunction evaluate;
+        Endgames::ScaleFunction scale;
+        bool insufficientMaterial;
+    };
+
+    constexpr Registration REGISTRATIONS[] = {
+        { "KvK", evaluateDraw, nullptr, true },
+        { "KBvK", evaluateDraw, nullptr, true },
+        { "KNvK", evaluateDraw, nullptr, true },
+        { "KNNvK", evaluateDraw, nullptr, false },
+        { "KBvKB", evaluateDraw, nullptr, false },
+        { "KNvKN", evaluateDraw, nullptr, false },
+        { "KBvKN", evaluateDraw, nullptr, false },
+        { "KQvK", evaluateKXK, nullptr, false },
+        { "KRvK", evaluateKXK, nullptr, false },
+        { "KQQvK", evaluateKXK, nullptr, false },
+        { "KQRvK", evaluateKXK, nullptr, false },
+        { "KRRvK", evaluateKXK, nullptr, false },
+        { "KQBvK", evaluateKXK, nullptr, false },
+        { "KQNvK", evaluateKXK, nullptr, false },
+        { "KRBvK", evaluateKXK, nullptr, false },
+        { "KRNvK", evaluateKXK, nullptr, false },
+        { "KBBvK", evaluateKXK, nullptr, false },
+        { "KBNvK", evaluateKBNK, nullptr, false },
+        { "KPvK", evaluateKPK, nullptr, false },
+        { "KQvKR", evaluateKQKR, nullptr, false },
+        { "KRvKB", nullptr, scaleRookVersusMinor, false },
+        { "KRvKN", nullptr, scaleRookVersusMinor, false },
+    };
+
+    std::unordered_map<uint64_t, Endgames::Entry> buildRegistry() {
+        std::unordered_map<uint64_t, Endgames::Entry> registry;
+        for (const Registration& registration : REGISTRATIONS) {
+            for (PieceColor strong : { PieceColor::WHITE, PieceColor::BLACK }) {
+                // Symmetric signatures map both colors to one key; the first one stays
+                registry.emplace(Endgames::materialKey(registration.signature, strong),
+                                 Endgames::Entry{ registration.signature, strong, registration.evaluate,
+                                                  registration.scale, registration.insufficientMaterial });
+            }
+        }
+        return registry;
+    }
+
+    const std::unordered_map<uint64_t, Endgames::Entry>& registry() {
+        static const std::unordered_map<uint64_t, Endgames::Entry> entries = buildRegistry();
+        return entries;
+    }
+
+    constexpr char PIECE_LETTERS[6] = { 'K', 'Q', 'R', 'B', 'N', 'P' };   // PieceType order
+}
+
+void Endgames::init() {
+    registry();
+}
+
+const Endgames::Entry* Endgames::probe(uint64_t materialKey) {
+    const auto& entries = registry();
+    auto it = entries.find(materialKey);
+    return it == entries.end() ? nullptr : &it->second;
+}
+
+uint64_t Endgames::materialKey(const std::string& signature, PieceColor strong) {
+    uint64_t key = 0;
+    PieceColor color = strong;
+    for (char letter : signature) {
+        if (letter == 'v') {
+            color = oppositeColor(strong);
+            continue;
+        }
+        const char* found = std::find(std::begin(PIECE_LETTERS), std::end(PIECE_LETTERS), letter);
+        if (found == std::end(PIECE_LETTERS)) {
+            throw std::runtime_error("Bad material signature: " + signature);
+        }
+        key += materialKeyUnit(makePieceCode(color, static_cast<PieceType>(found - PIECE_LETTERS)));
+    }
+    return key;
+}
+
+std::string Endgames::signature(uint64_t materialKey) {
+    std::string text;
+    for (PieceColor color : { PieceColor::WHITE, PieceColor::BLACK }) {
+        if (color == PieceColor::BLACK) text += 'v';
+        for (int type = 0; type < 6; type++) {
+            const int count = materialKeyCount(materialKey, makePieceCode(color, static_cast<PieceType>(type)));
+            text.append(static_cast<size_t>(count), PIECE_LETTERS[type]);
+        }
+    }
+    return text;
+}
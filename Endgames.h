@@ -0,0 +1,41 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include "BoardState.h"
+
+// Specialized evaluation for known endgames, keyed by material signature
+// such as "KBNvK" (strong side first). Entries are registered for both
+// colors and found with one hash lookup on BoardState::getMaterialKey().
+// An entry either replaces the evaluation outright or scales the generic
+// evaluation towards a draw.
+namespace Endgames {
+    constexpr int MAX_PIECES = 5;          // largest registered signature, kings included
+    constexpr int SCALE_NORMAL = 64;
+    constexpr int KNOWN_WIN = 10000;       // below Search::MATE_BOUND, above any material count
+
+    // Score in centipawns from the strong side's point of view
+    using EvaluateFunction = int (*)(const BoardState& state, PieceColor strong);
+    // Factor out of SCALE_NORMAL applied to the generic evaluation when the strong side is ahead
+    using ScaleFunction = int (*)(const BoardState& state, PieceColor strong);
+
+    struct Entry {
+        const char* signature;
+        PieceColor strong;
+        EvaluateFunction evaluate;     // nullptr for scaling-only entries
+        ScaleFunction scale;           // nullptr for evaluation entries
+        bool insufficientMaterial;     // no legal sequence can mate (KvK, KBvK, KNvK)
+    };
+
+    // Builds the registry, which otherwise happens on the first probe
+    // inside a search; called at startup next to KpkBitbase::init()
+    void init();
+
+    // Entry for this exact material, or nullptr
+    const Entry* probe(uint64_t materialKey);
+
+    // Material key for a signature like "KRvKB" with the given side holding the first half
+    uint64_t materialKey(const std::string& signature, PieceColor strong);
+
+    // Signature of the material on the board, White first, e.g. "KQPvKR"
+    std::string signature(uint64_t materialKey);
+}
@@ -0,0 +1,26 @@
+#include "EvalCache.h"
+#include <algorithm>
+#include <bit>
+
+EvalCache::EvalCache(size_t kilobytes) : slotCount(0), indexMask(0) {
+    resize(kilobytes);
+}
+
+void EvalCache::resize(size_t kilobytes) {
+    slotCount = std::bit_floor(std::max<size_t>(kilobytes * 1024 / sizeof(uint64_t), 1));
+    slots = std::make_unique<std::atomic<uint64_t>[]>(slotCount);
+    indexMask = slotCount - 1;
+    clear();
+}
+
+void EvalCache::clear() {
+    // Slot 0 decodes as key bits 0 with score 0; a real key matching that is negligible
+    for (size_t i = 0; i < slotCount; i++) {
+        slots[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+EvalCache& EvalCache::local() {
+    thread_local EvalCache cache;
+    return cache;
+}
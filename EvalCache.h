@@ -0,0 +1,44 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+
+// Static evaluations keyed by Zobrist key. Each slot is a single 64-bit
+// word holding the upper 48 key bits and a 16-bit score, so a reader racing
+// a writer sees either the old entry or the new one, never a mix. One
+// table can therefore be shared by several search threads without locks,
+// or each thread can use its own (see local()). Hit counters live in
+// SearchStats so shared tables do not bounce a counter cache line.
+class EvalCache {
+private:
+    std::unique_ptr<std::atomic<uint64_t>[]> slots;
+    size_t slotCount;
+    uint64_t indexMask;
+
+public:
+    explicit EvalCache(size_t kilobytes = 1024);
+
+    void resize(size_t kilobytes);
+    void clear();
+
+    // Score from the side to move's point of view, as stored
+    bool probe(uint64_t key, int& score) const {
+        const uint64_t data = slots[key & indexMask].load(std::memory_order_relaxed);
+        if ((data ^ key) >> 16 != 0) return false;
+        score = static_cast<int16_t>(data & 0xFFFF);
+        return true;
+    }
+
+    // Scores outside 16 bits would wrap, so they are not cached
+    void store(uint64_t key, int score) {
+        if (score < std::numeric_limits<int16_t>::min() || score > std::numeric_limits<int16_t>::max()) return;
+        const uint64_t data = (key & ~uint64_t(0xFFFF)) | static_cast<uint16_t>(static_cast<int16_t>(score));
+        slots[key & indexMask].store(data, std::memory_order_relaxed);
+    }
+
+    size_t getSizeKilobytes() const { return slotCount * sizeof(uint64_t) / 1024; }
+
+    static EvalCache& local();
+};
@@ -0,0 +1,287 @@
+#include "Evaluation.h"
+#include <algorithm>
+#include "Constants.h"
+#include "Endgames.h"
+#include "PieceSquareTables.h"
+
+namespace {
+    // Pawn-structure weights (centipawns), indexed by rank from the pawn's own side (0 = first rank)
+    constexpr int PASSED_MG[8] = { 0, 5, 10, 15, 25, 45, 70, 0 };
+    constexpr int PASSED_EG[8] = { 0, 10, 20, 35, 60, 100, 150, 0 };
+    constexpr int FREE_PASSER_EG[8] = { 0, 0, 5, 10, 20, 35, 50, 0 };
+    constexpr int ISOLATED_MG = -10;
+    constexpr int ISOLATED_EG = -15;
+    constexpr int DOUBLED_MG = -10;
+    constexpr int DOUBLED_EG = -20;
+    constexpr int BACKWARD_MG = -8;
+    constexpr int BACKWARD_EG = -10;
+    constexpr int SHIELD_BONUS = 10;
+
+    // Mobility: centipawns per reachable square beyond a typical count, indexed by PieceType
+    constexpr int MOBILITY_MG[6] = { 0, 1, 2, 5, 4, 0 };
+    constexpr int MOBILITY_EG[6] = { 0, 2, 4, 5, 4, 0 };
+    constexpr int MOBILITY_BASELINE[6] = { 0, 12, 6, 6, 4, 0 };
+
+    // King safety: units per attacked king-zone square, indexed by PieceType
+    constexpr int KING_ATTACK_WEIGHT[6] = { 0, 5, 3, 2, 2, 0 };
+    constexpr int KING_DANGER_LIMIT = 500;
+
+    // Threats (midgame, endgame)
+    constexpr int THREAT_BY_PAWN_MG = 45;
+    constexpr int THREAT_BY_PAWN_EG = 35;
+    constexpr int THREAT_BY_MINOR_MG = 30;
+    constexpr int THREAT_BY_MINOR_EG = 25;
+    constexpr int THREAT_BY_ROOK_MG = 30;
+    constexpr int THREAT_BY_ROOK_EG = 25;
+    constexpr int HANGING_MG = 25;
+    constexpr int HANGING_EG = 20;
+
+    constexpr int relativeRank(PieceColor color, int square) {
+        return color == PieceColor::WHITE ? 7 - Bitboards::rowOf(square) : Bitboards::rowOf(square);
+    }
+
+    struct PawnMasks {
+        Bitboard forwardFile[2][64];   // squares ahead on the same file
+        Bitboard attackSpan[2][64];    // squares ahead on the adjacent files
+        Bitboard passed[2][64];        // forwardFile | attackSpan
+        Bitboard shield[2][64];        // two ranks in front of a king, three files wide
+        Bitboard adjacentFiles[8];
+    };
+
+    constexpr PawnMasks makePawnMasks() {
+        PawnMasks masks{};
+        for (int col = 0; col < 8; col++) {
+            if (col > 0) masks.adjacentFiles[col] |= Bitboards::colMask(col - 1);
+            if (col < 7) masks.adjacentFiles[col] |= Bitboards::colMask(col + 1);
+        }
+        for (int color = 0; color < 2; color++) {
+            const int step = color == 0 ? -1 : 1;   // White advances towards row 0
+            for (int square = 0; square < 64; square++) {
+                const int row = Bitboards::rowOf(square);
+                const int col = Bitboards::colOf(square);
+                for (int r = row + step; r >= 0 && r < 8; r += step) {
+                    masks.forwardFile[color][square] |= Bitboards::squareBit(Bitboards::makeSquare(r, col));
+                    if (col > 0) masks.attackSpan[color][square] |= Bitboards::squareBit(Bitboards::makeSquare(r, col - 1));
+                    if (col < 7) masks.attackSpan[color][square] |= Bitboards::squareBit(Bitboards::makeSquare(r, col + 1));
+                }
+                masks.passed[color][square] = masks.forwardFile[color][square] | masks.attackSpan[color][square];
+                for (int r = row + step; r != row + 3 * step && r >= 0 && r < 8; r += step) {
+                    for (int c = col - 1; c <= col + 1; c++) {
+                        if (c >= 0 && c < 8) masks.shield[color][square] |= Bitboards::squareBit(Bitboards::makeSquare(r, c));
+                    }
+                }
+            }
+        }
+        return masks;
+    }
+
+    constexpr PawnMasks PAWN_MASKS = makePawnMasks();
+}
+
+int Evaluation::pieceValue(PieceType type) {
+    switch (type) {
+        case PieceType::PAWN: return ChessConstants::PAWN_VALUE;
+        case PieceType::KNIGHT: return ChessConstants::KNIGHT_VALUE;
+        case PieceType::BISHOP: return ChessConstants::BISHOP_VALUE;
+        case PieceType::ROOK: return ChessConstants::ROOK_VALUE;
+        case PieceType::QUEEN: return ChessConstants::QUEEN_VALUE;
+        case PieceType::KING: return 0;
+    }
+    return 0;
+}
+
+void Evaluation::evaluatePawns(const BoardState& state, PawnEntry& entry) {
+    int mg = 0;
+    int eg = 0;
+    for (int c = 0; c < 2; c++) {
+        const PieceColor color = static_cast<PieceColor>(c);
+        const Bitboard ours = state.getPieces(color, PieceType::PAWN);
+        const Bitboard theirs = state.getPieces(oppositeColor(color), PieceType::PAWN);
+        int colorMg = 0;
+        int colorEg = 0;
+        entry.passed[c] = 0;
+        entry.attackSpan[c] = 0;
+
+        Bitboard pawns = ours;
+        while (pawns) {
+            const int square = Bitboards::popLsb(pawns);
+            const int col = Bitboards::colOf(square);
+            entry.attackSpan[c] |= PAWN_MASKS.attackSpan[c][square];
+
+            if ((PAWN_MASKS.passed[c][square] & theirs) == 0) {
+                entry.passed[c] |= Bitboards::squareBit(square);
+                const int rank = relativeRank(color, square);
+                colorMg += PASSED_MG[rank];
+                colorEg += PASSED_EG[rank];
+            }
+            if ((ours & PAWN_MASKS.adjacentFiles[col]) == 0) {
+                colorMg += ISOLATED_MG;
+                colorEg += ISOLATED_EG;
+            } else if ((ours & PAWN_MASKS.adjacentFiles[col] & ~PAWN_MASKS.attackSpan[c][square]) == 0) {
+                // No neighbour level or behind can ever defend it; backward if the stop square is contested
+                const int stop = square + (color == PieceColor::WHITE ? -8 : 8);
+                if (Bitboards::pawnAttacks(color, stop) & theirs) {
+                    colorMg += BACKWARD_MG;
+                    colorEg += BACKWARD_EG;
+                }
+            }
+            if (PAWN_MASKS.forwardFile[c][square] & ours) {
+                colorMg += DOUBLED_MG;
+                colorEg += DOUBLED_EG;
+            }
+        }
+
+        mg += color == PieceColor::WHITE ? colorMg : -colorMg;
+        eg += color == PieceColor::WHITE ? colorEg : -colorEg;
+    }
+    entry.mgScore = static_cast<int16_t>(mg);
+    entry.egScore = static_cast<int16_t>(eg);
+}
+
+void Evaluation::generateAttacks(const BoardState& state, AttackInfo& info) {
+    const Bitboard occupied = state.getOccupied();
+
+    // Pawns and kings first: the mobility area and king zones depend on them
+    for (int c = 0; c < 2; c++) {
+        const PieceColor color = static_cast<PieceColor>(c);
+        const int king = state.getKingSquare(color);
+        const Bitboard pawnAttacks = Bitboards::pawnSetAttacks(color, state.getPieces(color, PieceType::PAWN));
+        const Bitboard kingAttacks = Bitboards::kingAttacks(king);
+        for (Bitboard& set : info.byType[c]) set = 0;
+        info.byType[c][static_cast<int>(PieceType::PAWN)] = pawnAttacks;
+        info.byType[c][static_cast<int>(PieceType::KING)] = kingAttacks;
+        info.all[c] = pawnAttacks | kingAttacks;
+        info.multiple[c] = pawnAttacks & kingAttacks;
+        info.kingZone[c] = kingAttacks | Bitboards::squareBit(king);
+        info.mobilityMg[c] = info.mobilityEg[c] = 0;
+        info.kingAttackers[c] = info.kingAttackUnits[c] = 0;
+    }
+
+    for (int c = 0; c < 2; c++) {
+        const PieceColor color = static_cast<PieceColor>(c);
+        const int them = 1 - c;
+        // Squares not blocked by own pawns or king and not covered by enemy pawns
+        const Bitboard mobilityArea = ~(state.getPieces(color, PieceType::PAWN) |
+                                        state.getPieces(color, PieceType::KING) |
+                                        info.byType[them][static_cast<int>(PieceType::PAWN)]);
+
+        for (PieceType type : { PieceType::KNIGHT, PieceType::BISHOP, PieceType::ROOK, PieceType::QUEEN }) {
+            const int t = static_cast<int>(type);
+            Bitboard pieces = state.getPieces(color, type);
+            while (pieces) {
+                const Bitboard attacks = Bitboards::pieceAttacks(type, Bitboards::popLsb(pieces), occupied);
+                info.multiple[c] |= info.all[c] & attacks;
+                info.all[c] |= attacks;
+                info.byType[c][t] |= attacks;
+
+                const int moves = Bitboards::popCount(attacks & mobilityArea) - MOBILITY_BASELINE[t];
+                info.mobilityMg[c] += MOBILITY_MG[t] * moves;
+                info.mobilityEg[c] += MOBILITY_EG[t] * moves;
+
+                const Bitboard zoneHits = attacks & info.kingZone[them];
+                if (zoneHits) {
+                    info.kingAttackers[c]++;
+                    info.kingAttackUnits[c] += KING_ATTACK_WEIGHT[t] * Bitboards::popCount(zoneHits);
+                }
+            }
+        }
+    }
+}
+
+int Evaluation::evaluateWhite(const BoardState& state, PawnTable& pawns) {
+    // Known endgames replace or scale the generic evaluation
+    const Endgames::Entry* endgame = nullptr;
+    if (Bitboards::popCount(state.getOccupied()) <= Endgames::MAX_PIECES) {
+        endgame = Endgames::probe(state.getMaterialKey());
+        if (endgame != nullptr && endgame->evaluate != nullptr) {
+            const int score = endgame->evaluate(state, endgame->strong);
+            return endgame->strong == PieceColor::WHITE ? score : -score;
+        }
+    }
+
+    bool found;
+    PawnEntry& entry = pawns.probe(state.getPawnKey(), found);
+    if (!found) {
+        evaluatePawns(state, entry);
+        entry.key = state.getPawnKey();
+    }
+
+    int mg = state.getMidgameScore() + entry.mgScore;
+    int eg = state.getEndgameScore() + entry.egScore;
+
+    for (int c = 0; c < 2; c++) {
+        const PieceColor color = static_cast<PieceColor>(c);
+        const int sign = color == PieceColor::WHITE ? 1 : -1;
+
+        // Pawn shield in front of a king that stays on its first two ranks
+        const int king = state.getKingSquare(color);
+        if (relativeRank(color, king) <= 1) {
+            mg += sign * SHIELD_BONUS * Bitboards::popCount(PAWN_MASKS.shield[c][king] & state.getPieces(color, PieceType::PAWN));
+        }
+
+        // Passed pawns whose stop square is free are worth more in the endgame
+        Bitboard passed = entry.passed[c];
+        while (passed) {
+            const int square = Bitboards::popLsb(passed);
+            const int stop = square + (color == PieceColor::WHITE ? -8 : 8);
+            if (!(state.getOccupied() & Bitboards::squareBit(stop))) {
+                eg += sign * FREE_PASSER_EG[relativeRank(color, square)];
+            }
+        }
+    }
+
+    AttackInfo attacks;
+    generateAttacks(state, attacks);
+    for (int c = 0; c < 2; c++) {
+        const PieceColor color = static_cast<PieceColor>(c);
+        const int them = 1 - c;
+        const int sign = color == PieceColor::WHITE ? 1 : -1;
+
+        mg += sign * attacks.mobilityMg[c];
+        eg += sign * attacks.mobilityEg[c];
+
+        // Danger grows with the square of the attack weight once two pieces join in
+        if (attacks.kingAttackers[c] >= 2) {
+            const int units = attacks.kingAttackUnits[c];
+            mg += sign * std::min(units * units / 4, KING_DANGER_LIMIT);
+        }
+
+        // Enemy pieces (not pawns or the king) under attack
+        const Bitboard targets = state.getPieces(oppositeColor(color)) &
+                                 ~state.getPieces(oppositeColor(color), PieceType::PAWN) &
+                                 ~state.getPieces(oppositeColor(color), PieceType::KING);
+        const Bitboard majors = state.getPieces(oppositeColor(color), PieceType::ROOK) |
+                                state.getPieces(oppositeColor(color), PieceType::QUEEN);
+        const int byPawn = Bitboards::popCount(targets & attacks.byType[c][static_cast<int>(PieceType::PAWN)]);
+        const int byMinor = Bitboards::popCount(majors & (attacks.byType[c][static_cast<int>(PieceType::KNIGHT)] |
+                                                          attacks.byType[c][static_cast<int>(PieceType::BISHOP)]));
+        const int byRook = Bitboards::popCount(state.getPieces(oppositeColor(color), PieceType::QUEEN) &
+                                               attacks.byType[c][static_cast<int>(PieceType::ROOK)]);
+        const int hanging = Bitboards::popCount(targets & attacks.all[c] & ~attacks.all[them]);
+        mg += sign * (byPawn * THREAT_BY_PAWN_MG + byMinor * THREAT_BY_MINOR_MG +
+                      byRook * THREAT_BY_ROOK_MG + hanging * HANGING_MG);
+        eg += sign * (byPawn * THREAT_BY_PAWN_EG + byMinor * THREAT_BY_MINOR_EG +
+                      byRook * THREAT_BY_ROOK_EG + hanging * HANGING_EG);
+    }
+
+    const int phase = std::min(state.getPhase(), PieceSquareTables::MAX_PHASE);
+    int score = (mg * phase + eg * (PieceSquareTables::MAX_PHASE - phase)) / PieceSquareTables::MAX_PHASE;
+    if (endgame != nullptr && endgame->scale != nullptr &&
+        (endgame->strong == PieceColor::WHITE ? score > 0 : score < 0)) {
+        score = score * endgame->scale(state, endgame->strong) / Endgames::SCALE_NORMAL;
+    }
+    return score;
+}
+
+int Evaluation::evaluateWhite(const BoardState& state) {
+    return evaluateWhite(state, PawnTable::local());
+}
+
+int Evaluation::evaluate(const BoardState& state, PawnTable& pawns) {
+    const int score = evaluateWhite(state, pawns);
+    return state.getSideToMove() == PieceColor::WHITE ? score : -score;
+}
+
+int Evaluation::evaluate(const BoardState& state) {
+    return evaluate(state, PawnTable::local());
+}
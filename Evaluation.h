@@ -0,0 +1,39 @@
+#pragma once
+#include "BoardState.h"
+#include "Enums.h"
+#include "PawnTable.h"
+
+// Static evaluation used by the search. Scores are in centipawns from the
+// point of view of the side to move. Material and piece-square terms come
+// from accumulators BoardState maintains on make/unmake, blended between
+// middlegame and endgame by the remaining non-pawn material. Pawn
+// structure is looked up in a PawnTable; the overloads without one use the
+// calling thread's table. Mobility, king safety and threats share one
+// attack-generation pass per evaluation (AttackInfo). Known endgames are
+// handed to the Endgames registry first.
+namespace Evaluation {
+    // Attack sets of both sides, indexed by PieceColor, generated once per
+    // evaluation together with the per-piece counts the terms need
+    struct AttackInfo {
+        Bitboard byType[2][6];     // union over all pieces of a type
+        Bitboard all[2];
+        Bitboard multiple[2];      // squares attacked by at least two pieces
+        Bitboard kingZone[2];      // king square and its neighbours
+        int mobilityMg[2];
+        int mobilityEg[2];
+        int kingAttackers[2];      // pieces hitting the enemy king zone
+        int kingAttackUnits[2];    // weighted zone squares they hit
+    };
+
+
+    int pieceValue(PieceType type);
+    int evaluate(const BoardState& state, PawnTable& pawns);
+    int evaluate(const BoardState& state);
+    int evaluateWhite(const BoardState& state, PawnTable& pawns);   // White's point of view
+    int evaluateWhite(const BoardState& state);
+
+    // Pawn-structure terms for the current pawns (the pawn table miss path)
+    void evaluatePawns(const BoardState& state, PawnEntry& entry);
+
+    void generateAttacks(const BoardState& state, AttackInfo& info);
+}
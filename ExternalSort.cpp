@@ -0,0 +1,27 @@
+#include "ExternalSort.h"
+#include <algorithm>
+#include <filesystem>
+
+ExternalSort::RunFiles::~RunFiles() {
+    std::error_code error;
+    for (const auto& path : paths) std::filesystem::remove(path, error);
+}
+
+std::string ExternalSort::RunFiles::create() {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::string path = prefix + ".run" + std::to_string(created++) + ".tmp";
+    paths.push_back(path);
+    return path;
+}
+
+void ExternalSort::RunFiles::remove(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::error_code error;
+    std::filesystem::remove(path, error);
+    paths.erase(std::find(paths.begin(), paths.end(), path));
+}
+
+std::vector<std::string> ExternalSort::RunFiles::getPaths() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return paths;
+}
@@ -0,0 +1,123 @@
+#pragma once
+#include <cstddef>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Building blocks for sorting more records than fit in memory: sorted runs
+// are spilled to temporary files and k-way merged back. Records are
+// trivially copyable structs written to runs as raw bytes.
+namespace ExternalSort {
+    // Temporary run files named after the output file, removed on destruction
+    class RunFiles {
+    private:
+        std::string prefix;
+        std::mutex mutex;
+        std::vector<std::string> paths;
+        size_t created = 0;
+
+    public:
+        explicit RunFiles(const std::string& outputPath) : prefix(outputPath) {}
+        ~RunFiles();
+
+        RunFiles(const RunFiles&) = delete;
+        RunFiles& operator=(const RunFiles&) = delete;
+
+        std::string create();
+        void remove(const std::string& path);
+
+        size_t getCreated() const { return created; }
+        std::vector<std::string> getPaths();
+    };
+
+    template <typename Record>
+    void writeRun(const std::vector<Record>& records, const std::string& path) {
+        std::ofstream out(path, std::ios::binary);
+        out.write(reinterpret_cast<const char*>(records.data()), static_cast<std::streamsize>(records.size() * sizeof(Record)));
+        if (!out) throw std::runtime_error("Could not write " + path);
+    }
+
+    // Buffered sequential reader of one run
+    template <typename Record>
+    class RunReader {
+    private:
+        std::ifstream in;
+        std::vector<Record> buffer;
+        size_t position = 0;
+        size_t filled = 0;
+
+    public:
+        RunReader(const std::string& path, size_t bufferRecords) : in(path, std::ios::binary), buffer(bufferRecords) {
+            if (!in.is_open()) throw std::runtime_error("Could not open " + path);
+        }
+
+        bool next(Record& record) {
+            if (position == filled) {
+                in.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(buffer.size() * sizeof(Record)));
+                filled = static_cast<size_t>(in.gcount()) / sizeof(Record);
+                position = 0;
+                if (filled == 0) return false;
+            }
+            record = buffer[position++];
+            return true;
+        }
+    };
+
+    // K-way merge of runs sorted by less; emit receives every record in order
+    template <typename Record, typename Less, typename Emit>
+    void mergeRuns(const std::vector<std::string>& paths, size_t bufferRecords, Less less, Emit&& emit) {
+        std::vector<std::unique_ptr<RunReader<Record>>> readers;
+        using Head = std::pair<Record, size_t>;
+        auto greater = [&less](const Head& a, const Head& b) { return less(b.first, a.first); };
+        std::priority_queue<Head, std::vector<Head>, decltype(greater)> heads(greater);
+        for (const auto& path : paths) {
+            readers.push_back(std::make_unique<RunReader<Record>>(path, bufferRecords));
+            Record record;
+            if (readers.back()->next(record)) heads.emplace(record, readers.size() - 1);
+        }
+        while (!heads.empty()) {
+            const auto [record, source] = heads.top();
+            heads.pop();
+            Record following;
+            if (readers[source]->next(following)) heads.emplace(following, source);
+            emit(record);
+        }
+    }
+
+    // Merges runs in groups of width into new runs until at most width
+    // remain. combine(last, record) folds record into the last record
+    // written and returns true, or returns false to keep both.
+    template <typename Record, typename Less, typename Combine>
+    std::vector<std::string> reduceRuns(RunFiles& runs, std::vector<std::string> pending, size_t width,
+                                        size_t bufferRecords, Less less, Combine combine) {
+        while (pending.size() > width) {
+            std::vector<std::string> group(pending.begin(), pending.begin() + static_cast<std::ptrdiff_t>(width));
+            pending.erase(pending.begin(), pending.begin() + static_cast<std::ptrdiff_t>(width));
+
+            const std::string merged = runs.create();
+            std::ofstream out(merged, std::ios::binary);
+            std::vector<Record> buffer;
+            buffer.reserve(bufferRecords);
+            mergeRuns<Record>(group, bufferRecords, less, [&](const Record& record) {
+                if (!buffer.empty() && combine(buffer.back(), record)) return;
+                if (buffer.size() >= bufferRecords) {
+                    // Keep the last record back: the next one may still combine into it
+                    out.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>((buffer.size() - 1) * sizeof(Record)));
+                    buffer.erase(buffer.begin(), buffer.end() - 1);
+                }
+                buffer.push_back(record);
+            });
+            out.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size() * sizeof(Record)));
+            out.close();
+            if (!out) throw std::runtime_error("Could not write " + merged);
+            for (const auto& path : group) runs.remove(path);
+            pending.push_back(merged);
+        }
+        return pending;
+    }
+}
@@ -1,4 +1,11 @@
 #include "Game.h"
+#include <cmath>
+#include <filesystem>
+#include "Constants.h"
+#include "Endgames.h"
+#include "Evaluation.h"
+#include "KpkBitbase.h"
+#include "ResultsStore.h"
 
 // Private helper methods
 Position<int> Game::getSquareFromMouse(int mouseX, int mouseY) {
@@ -58,24 +65,14 @@ std::string Game::formatTime(int seconds) {
     return oss.str();
 }
 
-void Game::saveMatchResult(const std::string& resultType) {
-    std::ofstream file("match_results.txt", std::ios::app);
-    if (!file.is_open()) {
-        std::cerr << "Could not open match_results.txt\n";
-        return;
-    }
-    
+void Game::saveMatchResult(const std::string& resultType, const std::string& adjudicatedWinner) {
     // Get current time
     std::time_t now = std::time(nullptr);
     std::tm timeInfo;
     localtime_s(&timeInfo, &now);
-    char timeBuffer[100];
-    std::strftime(timeBuffer, sizeof(timeBuffer), "%Y-%m-%d %H:%M", &timeInfo);
     
     // Calculate game duration
     int duration = static_cast<int>(std::difftime(now, gameStartTime));
-    int durationMin = duration / 60;
-    int durationSec = duration % 60;
     
     // Determine winner
     std::string winner, loser;
@@ -96,22 +93,45 @@ void Game::saveMatchResult(const std::string& resultType) {
             winner = whitePlayerName;
             loser = blackPlayerName;
         }
-    } else if (resultType == "Stalemate") {
+    } else if (!adjudicatedWinner.empty()) {
+        winner = adjudicatedWinner;
+        loser = (adjudicatedWinner == whitePlayerName ? blackPlayerName : whitePlayerName);
+    } else if (resultType == "Stalemate" || resultType == "Draw - KPK Adjudication") {
         winner = "Draw";
         loser = "Draw";
     }
     
+    GameResult result = GameResult::UNKNOWN;
+    if (resultType == "Stalemate" || resultType.rfind("Draw", 0) == 0) result = GameResult::DRAW;
+    else if (winner == whitePlayerName) result = GameResult::WHITE_WINS;
+    else if (winner == blackPlayerName) result = GameResult::BLACK_WINS;
+    history->setResult(result);
+
     // Write result
-    file << timeBuffer << " | "
-         << whitePlayerName << " | "
-         << blackPlayerName << " | "
-         << winner << " | "
-         << resultType << " | "
-         << durationMin << ":" << std::setfill('0') << std::setw(2) << durationSec
-         << "\n";
-    
-    file.close();
-    std::cout << "\nMatch result saved to match_results.txt\n";
+    MatchResult match;
+    match.time = static_cast<uint64_t>(timeInfo.tm_year + 1900) * 100000000 + static_cast<uint64_t>(timeInfo.tm_mon + 1) * 1000000 +
+                 static_cast<uint64_t>(timeInfo.tm_mday) * 10000 + static_cast<uint64_t>(timeInfo.tm_hour) * 100 +
+                 static_cast<uint64_t>(timeInfo.tm_min);
+    match.white = whitePlayerName;
+    match.black = blackPlayerName;
+    match.result = result;
+    match.termination = Results::parseTermination(resultType);
+    match.durationSeconds = static_cast<uint32_t>(std::max(duration, 0));
+    try {
+        ResultsStore store(ChessConstants::Assets::RESULTS_STORE);
+        // Results from before the binary store are carried over once
+        std::error_code fileError;
+        if (store.getRecordCount() == 0 && std::filesystem::exists(ChessConstants::Assets::RESULTS_FILE, fileError)) {
+            uint64_t skipped = 0;
+            const uint64_t imported = store.importText(ChessConstants::Assets::RESULTS_FILE, skipped);
+            std::cout << "Imported " << imported << " earlier results from " << ChessConstants::Assets::RESULTS_FILE << "\n";
+        }
+        store.append(match);
+        std::cout << "\nMatch result saved to " << ChessConstants::Assets::RESULTS_STORE << "\n";
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Could not save match result: " << e.what() << "\n";
+    }
 }
 
 void Game::handleEvents() {
@@ -162,6 +182,20 @@ void Game::handleEvents() {
                 history->clear();
                 isPieceSelected = false;
                 std::cout << "Game reset!\n";
+                updateEvaluation();
+                restartAnalysis();
+                printBookMoves();
+            }
+            else if (keyPress->code == sf::Keyboard::Key::A) {
+                // Toggle analysis arrows
+                analysisEnabled = !analysisEnabled;
+                if (analysisEnabled) {
+                    startAnalysis();
+                    std::cout << "Analysis on\n";
+                } else {
+                    stopAnalysis();
+                    std::cout << "Analysis off\n";
+                }
             }
             else if (keyPress->code == sf::Keyboard::Key::Escape) {
                 window.close();
@@ -193,10 +227,14 @@ void Game::handleMouseClick(int mouseX, int mouseY) {
             
             // Promote the pawn
             board->promotePawn(promotionSquare, selectedType);
+            history->setLastPromotion(selectedType);
             std::cout << "Pawn promoted!\n";
             
             waitingForPromotion = false;
             promotionSquare = Position<int>(-1, -1);
+            updateEvaluation();
+            restartAnalysis();
+            printBookMoves();
             return;
         }
         return; // Ignore board clicks during promotion
@@ -255,6 +293,7 @@ void Game::handleMouseClick(int mouseX, int mouseY) {
                 
                 // Add to history
                 history->addMove(Move(selectedSquare, clickedSquare, isCapture, isCastling));
+                updateEvaluation();
                 
                 // Check for pawn promotion
                 Piece* movedPiece = board->getPieceAt(clickedSquare);
@@ -268,6 +307,7 @@ void Game::handleMouseClick(int mouseX, int mouseY) {
                         std::cout << "Choose promotion piece!\n";
                         isPieceSelected = false;
                         currentValidMoves.clear();
+                        stopAnalysis();
                         return; // Don't check for checkmate yet
                     }
                 }
@@ -298,6 +338,10 @@ void Game::handleMouseClick(int mouseX, int mouseY) {
                     std::cout << "\n*** DRAW! Insufficient material to checkmate. ***\n\n";
                     saveMatchResult("Draw - Insufficient Material");
                 }
+                // King and pawn versus king is decided by the bitbase
+                else if (adjudicateEndgame()) {
+                    gameOver = true;
+                }
                 // Check for draw by 50-move rule
                 else if (board->isFiftyMoveRule()) {
                     gameOver = true;
@@ -324,6 +368,8 @@ void Game::handleMouseClick(int mouseX, int mouseY) {
                 
                 isPieceSelected = false;
                 currentValidMoves.clear();
+                restartAnalysis();
+                printBookMoves();
             }
             else {
                 std::cout << "Invalid move!\n";
@@ -366,16 +412,19 @@ void Game::render() {
         highlight.setOutlineThickness(3);
         window.draw(highlight);
     }
+
+    // Draw analysis arrows and scores
+    if (analysisEnabled) {
+        drawAnalysis();
+    }
     
     // Draw UI (player info and timer) on the right side
     if (uiFontLoaded) {
         float uiX = BOARD_SIZE * SQUARE_SIZE + 2 * BORDER_SIZE + 10;
         float uiY = 20;
         
-        // Calculate material difference
-        int whiteScore = board->getMaterialScore(PieceColor::WHITE);
-        int blackScore = board->getMaterialScore(PieceColor::BLACK);
-        int diff = whiteScore - blackScore;
+        // Evaluation shown next to the player who is ahead
+        int diff = evaluationCp;
         
         // Black player info (top)
         sf::Text blackNameText(uiFont);
@@ -389,7 +438,7 @@ void Game::render() {
         // Black material score
         if (diff < 0) {
             sf::Text scoreText(uiFont);
-            scoreText.setString("+" + std::to_string(-diff));
+            scoreText.setString(evaluationText);
             scoreText.setCharacterSize(16);
             scoreText.setFillColor(sf::Color(180, 180, 180));
             scoreText.setPosition(sf::Vector2f(uiX + 130, uiY + 2));
@@ -453,7 +502,7 @@ void Game::render() {
         // White material score
         if (diff > 0) {
             sf::Text scoreText(uiFont);
-            scoreText.setString("+" + std::to_string(diff));
+            scoreText.setString(evaluationText);
             scoreText.setCharacterSize(16);
             scoreText.setFillColor(sf::Color(180, 180, 180));
             scoreText.setPosition(sf::Vector2f(uiX + 130, whiteY + 42));
@@ -538,6 +587,181 @@ void Game::render() {
     window.display();
 }
 
+// Records the result when the position is a bitbase endgame
+bool Game::adjudicateEndgame() {
+    BoardState position;
+    if (!position.setFromFEN(board->toFEN())) return false;
+
+    for (PieceColor strong : { PieceColor::WHITE, PieceColor::BLACK }) {
+        if (position.getMaterialKey() != Endgames::materialKey("KPvK", strong)) continue;
+
+        if (KpkBitbase::probe(position, strong)) {
+            std::string winner = (strong == PieceColor::WHITE ? whitePlayerName : blackPlayerName);
+            gameResult = winner + " wins (KPK adjudicated)";
+            std::cout << "\n*** ADJUDICATED! King and pawn versus king is won for " << winner << ". ***\n\n";
+            saveMatchResult("Adjudication - KPK Win", winner);
+        } else {
+            gameResult = "Game drawn by KPK adjudication";
+            std::cout << "\n*** DRAW! King and pawn versus king cannot be won. ***\n\n";
+            saveMatchResult("Draw - KPK Adjudication");
+        }
+        return true;
+    }
+    return false;
+}
+
+void Game::updateEvaluation() {
+    BoardState position;
+    evaluationCp = position.setFromFEN(board->toFEN()) ? Evaluation::evaluateWhite(position) : 0;
+
+    std::ostringstream text;
+    text << "+" << std::fixed << std::setprecision(1) << std::abs(evaluationCp) / 100.0;
+    evaluationText = text.str();
+}
+
+void Game::startAnalysis() {
+    if (!analysisEnabled || gameOver || waitingForPromotion) return;
+
+    BoardState position;
+    if (!position.setFromFEN(board->toFEN())) return;
+
+    {
+        std::lock_guard<std::mutex> lock(analysisMutex);
+        analysisLines.clear();
+        analysisDepth = 0;
+        analysisSide = position.getSideToMove();
+    }
+
+    analysisStop = false;
+    analysisThread = std::thread([this, position]() {
+        Search search(*analysisTable);
+        search.setTablebases(analysisTablebases.get());
+        SearchLimits limits;
+        limits.depth = ChessConstants::ANALYSIS_MAX_DEPTH;
+        limits.multiPV = ChessConstants::ANALYSIS_LINES;
+        limits.stopSignal = &analysisStop;
+        limits.onIteration = [this](int depth, const std::vector<PvLine>& lines) {
+            std::lock_guard<std::mutex> lock(analysisMutex);
+            analysisLines = lines;
+            analysisDepth = depth;
+        };
+        search.run(position, limits);
+    });
+}
+
+void Game::stopAnalysis() {
+    analysisStop = true;
+    if (analysisThread.joinable()) {
+        analysisThread.join();
+    }
+
+    std::lock_guard<std::mutex> lock(analysisMutex);
+    analysisLines.clear();
+    analysisDepth = 0;
+}
+
+void Game::restartAnalysis() {
+    stopAnalysis();
+    startAnalysis();
+}
+
+void Game::printBookMoves() {
+    if (!openingBook.isOpen() || gameOver || waitingForPromotion) return;
+
+    BoardState position;
+    if (!position.setFromFEN(board->toFEN())) return;
+    const std::vector<BookMove> moves = openingBook.probe(position);
+    if (moves.empty()) return;
+
+    uint64_t total = 0;
+    for (const BookMove& move : moves) total += move.weight;
+    std::cout << "Book:";
+    for (const BookMove& move : moves) {
+        std::cout << " " << move.move.toUci();
+        if (total > 0) std::cout << " (" << move.weight * 100 / total << "%)";
+    }
+    std::cout << "\n";
+}
+
+void Game::drawAnalysis() {
+    std::vector<PvLine> lines;
+    int depth;
+    PieceColor side;
+    {
+        std::lock_guard<std::mutex> lock(analysisMutex);
+        lines = analysisLines;
+        depth = analysisDepth;
+        side = analysisSide;
+    }
+
+    // Draw worse lines first so the best arrow ends up on top
+    const float headLength = SQUARE_SIZE * 0.35f;
+    const float shaftWidth = SQUARE_SIZE * ChessConstants::ANALYSIS_ARROW_WIDTH;
+    for (int i = static_cast<int>(lines.size()) - 1; i >= 0; i--) {
+        if (lines[i].moves.empty()) continue;
+        PackedMove move = lines[i].moves[0];
+
+        sf::Vector2f start(BORDER_SIZE + (move.getFrom() % 8 + 0.5f) * SQUARE_SIZE,
+                           BORDER_SIZE + (move.getFrom() / 8 + 0.5f) * SQUARE_SIZE);
+        sf::Vector2f end(BORDER_SIZE + (move.getTo() % 8 + 0.5f) * SQUARE_SIZE,
+                         BORDER_SIZE + (move.getTo() / 8 + 0.5f) * SQUARE_SIZE);
+        sf::Vector2f delta = end - start;
+        float length = std::sqrt(delta.x * delta.x + delta.y * delta.y);
+        sf::Angle angle = sf::radians(std::atan2(delta.y, delta.x));
+
+        // Best line is the most opaque
+        sf::Color color(255, 170, 0, static_cast<std::uint8_t>(std::max(220 - i * 60, 60)));
+
+        sf::RectangleShape shaft(sf::Vector2f(length - headLength, shaftWidth));
+        shaft.setOrigin(sf::Vector2f(0.f, shaftWidth / 2.f));
+        shaft.setPosition(start);
+        shaft.setRotation(angle);
+        shaft.setFillColor(color);
+        window.draw(shaft);
+
+        sf::ConvexShape head(3);
+        head.setPoint(0, sf::Vector2f(0.f, -shaftWidth * 1.5f));
+        head.setPoint(1, sf::Vector2f(headLength, 0.f));
+        head.setPoint(2, sf::Vector2f(0.f, shaftWidth * 1.5f));
+        head.setPosition(start + delta * ((length - headLength) / length));
+        head.setRotation(angle);
+        head.setFillColor(color);
+        window.draw(head);
+    }
+
+    if (!uiFontLoaded || lines.empty()) return;
+
+    // Scores in the sidebar, from White's point of view
+    float uiX = BOARD_SIZE * SQUARE_SIZE + 2 * BORDER_SIZE + 10;
+    float uiY = (BOARD_SIZE * SQUARE_SIZE + 2 * BORDER_SIZE) / 2 + 90;
+
+    sf::Text depthText(uiFont);
+    depthText.setString("Analysis depth " + std::to_string(depth));
+    depthText.setCharacterSize(14);
+    depthText.setFillColor(sf::Color(180, 180, 180));
+    depthText.setPosition(sf::Vector2f(uiX, uiY));
+    window.draw(depthText);
+
+    for (size_t i = 0; i < lines.size(); i++) {
+        int score = side == PieceColor::WHITE ? lines[i].score : -lines[i].score;
+        std::ostringstream text;
+        text << (i + 1) << ". " << lines[i].moves[0].toUci() << "  ";
+        if (Search::isMateScore(score)) {
+            int plies = Search::MATE_SCORE - std::abs(score);
+            text << (score > 0 ? "#" : "#-") << (plies + 1) / 2;
+        } else {
+            text << std::showpos << std::fixed << std::setprecision(2) << score / 100.0;
+        }
+
+        sf::Text lineText(uiFont);
+        lineText.setString(text.str());
+        lineText.setCharacterSize(14);
+        lineText.setFillColor(sf::Color(255, 170, 0));
+        lineText.setPosition(sf::Vector2f(uiX, uiY + 20 * (i + 1)));
+        window.draw(lineText);
+    }
+}
+
 // Public methods
 Game::Game() : 
     board(std::make_unique<Board>()),
@@ -551,6 +775,12 @@ Game::Game() :
     isCheck(false),
     waitingForPromotion(false),
     promotionSquare(-1, -1),
+    evaluationCp(0),
+    analysisEnabled(false),
+    analysisStop(false),
+    analysisDepth(0),
+    analysisSide(PieceColor::WHITE),
+    analysisTable(std::make_unique<TranspositionTable>(ChessConstants::ANALYSIS_HASH_MB)),
     uiFontLoaded(false)
 {
     // Load UI font
@@ -558,18 +788,36 @@ Game::Game() :
     if (!uiFontLoaded) {
         std::cout << "Warning: Could not load UI font\n";
     }
+
+    std::error_code fileError;
+    if (std::filesystem::is_directory(ChessConstants::TABLEBASE_DIRECTORY, fileError)) {
+        analysisTablebases = std::make_unique<TablebaseProber>(ChessConstants::TABLEBASE_DIRECTORY);
+        std::cout << "Analysis probes " << analysisTablebases->getTableCount() << " tablebases\n";
+    }
+
+    try {
+        Polyglot::loadDefaultRandom64();
+        if (std::filesystem::exists(ChessConstants::BOOK_FILE, fileError)) {
+            openingBook.open(ChessConstants::BOOK_FILE);
+            std::cout << "Opening book: " << openingBook.getEntryCount() << " entries\n";
+        }
+    }
+    catch (const std::exception& e) {
+        std::cout << "Warning: " << e.what() << "\n";
+    }
     
     // Get player names
     std::cout << "\n=== CHESS GAME SETUP ===\n";
     std::cout << "Enter White player name: ";
     std::getline(std::cin, whitePlayerName);
-    if (whitePlayerName.empty()) whitePlayerName = "White Player";
+    if (whitePlayerName.empty()) whitePlayerName = ChessConstants::DEFAULT_WHITE_NAME;
     
     std::cout << "Enter Black player name: ";
     std::getline(std::cin, blackPlayerName);
-    if (blackPlayerName.empty()) blackPlayerName = "Black Player";
+    if (blackPlayerName.empty()) blackPlayerName = ChessConstants::DEFAULT_BLACK_NAME;
     
     std::cout << "\n" << whitePlayerName << " (White) vs " << blackPlayerName << " (Black)\n";
+    history->setPlayers(whitePlayerName, blackPlayerName);
     std::cout << "Timer: 10 minutes per player\n\n";
     
     // Create window AFTER getting input to avoid "Not Responding" state
@@ -583,8 +831,16 @@ Game::Game() :
     gameView.setCenter(sf::Vector2f(LOGICAL_WIDTH / 2.0f, LOGICAL_HEIGHT / 2.0f));
     window.setView(gameView);
     
+    updateEvaluation();
+    printBookMoves();
+
     // Record game start time
     gameStartTime = std::time(nullptr);
+    std::tm startInfo;
+    localtime_s(&startInfo, &gameStartTime);
+    char dateBuffer[16];
+    std::strftime(dateBuffer, sizeof(dateBuffer), "%Y.%m.%d", &startInfo);
+    history->setDate(dateBuffer);
     
     // Start the clocks
     gameClock.restart();
@@ -592,9 +848,10 @@ Game::Game() :
 }
 
 Game::~Game() {
+    stopAnalysis();
+    // Moves were journaled as they were played; wait for the last sync
     try {
-        history->saveToFile();
-        std::cout << "Game history saved!\n";
+        history->closeJournal();
     }
     catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << "\n";
@@ -602,13 +859,37 @@ Game::~Game() {
 }
 
 void Game::run() {
-    // Try to load previous history
+    // Recover the previous game from the move journal
     try {
-        history->loadFromFile();
-        std::cout << "Loaded " << history->getMoveCount() << " previous moves.\n";
+        const JournalRecovery recovery = history->openJournal(ChessConstants::Assets::JOURNAL_FILE);
+        if (recovery.discardedBytes > 0) {
+            std::cout << "Journal: discarded " << recovery.discardedBytes << " bytes of an incomplete last write\n";
+        }
+        if (history->getMoveCount() > 0) {
+            // Continue the unfinished game where it stopped
+            std::cout << "Resumed unfinished game after " << history->getMoveCount() << " moves.\n";
+            board->fromFEN(history->getFinalPosition().toFEN());
+
+            // Names entered at startup replace the journaled ones; names left
+            // blank take the resumed game's, so the UI and the record agree
+            const GameHeader& recovered = history->getHeader();
+            if (whitePlayerName == ChessConstants::DEFAULT_WHITE_NAME && !recovered.white.empty()) whitePlayerName = recovered.white;
+            if (blackPlayerName == ChessConstants::DEFAULT_BLACK_NAME && !recovered.black.empty()) blackPlayerName = recovered.black;
+            history->setPlayers(whitePlayerName, blackPlayerName);
+            std::cout << whitePlayerName << " (White) vs " << blackPlayerName << " (Black)\n";
+
+            // The constructor evaluated the start position
+            isCheck = board->isPlayerInCheck(board->getCurrentTurn());
+            updateEvaluation();
+            restartAnalysis();
+            printBookMoves();
+        }
+        else {
+            std::cout << "No unfinished game found. Starting new game.\n";
+        }
     }
-    catch (const std::exception&) {
-        std::cout << "No previous history found. Starting new game.\n";
+    catch (const std::exception& e) {
+        std::cerr << "Warning: " << e.what() << ". Moves will not be saved.\n";
     }
 
     // Show piece information
@@ -1,6 +1,9 @@
 #pragma once
 #include <SFML/Graphics.hpp>
+#include <atomic>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <iostream>
 #include <fstream>
 #include <ctime>
@@ -8,7 +11,11 @@
 #include <sstream>
 #include "Board.h"
 #include "GameHistory.h"
+#include "PolyglotBook.h"
 #include "Position.h"
+#include "Search.h"
+#include "TablebaseProber.h"
+#include "TranspositionTable.h"
 
 class Game {
 private:
@@ -41,6 +48,22 @@ class Game {
     Position<int> promotionSquare;
     PieceColor promotionColor;
     
+    // Static evaluation (centipawns, White's view), refreshed once per move
+    int evaluationCp;
+    std::string evaluationText;
+
+    // Analysis mode: background multi-PV search drawn as arrows
+    bool analysisEnabled;
+    std::thread analysisThread;
+    std::atomic<bool> analysisStop;
+    std::mutex analysisMutex;
+    std::vector<PvLine> analysisLines;
+    int analysisDepth;
+    PieceColor analysisSide;
+    std::unique_ptr<TranspositionTable> analysisTable;
+    std::unique_ptr<TablebaseProber> analysisTablebases;   // nullptr without a tablebase folder
+    PolyglotBook openingBook;                              // closed without a book file
+
     // UI font
     sf::Font uiFont;
     bool uiFontLoaded;
@@ -54,10 +77,17 @@ class Game {
     Position<int> getSquareFromMouse(int mouseX, int mouseY);
     void updateTimer();
     std::string formatTime(int seconds);
-    void saveMatchResult(const std::string& resultType);
+    void saveMatchResult(const std::string& resultType, const std::string& adjudicatedWinner = "");
+    bool adjudicateEndgame();
     void handleEvents();
     void handleMouseClick(int mouseX, int mouseY);
     void render();
+    void updateEvaluation();
+    void startAnalysis();
+    void stopAnalysis();
+    void restartAnalysis();
+    void printBookMoves();
+    void drawAnalysis();
 
 public:
     Game();
@@ -0,0 +1,382 @@
+#include "GameArchive.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string_view>
+#include <zlib.h>
+#include "PgnReader.h"
+#include "WorkStealingPool.h"
+
+namespace {
+    constexpr size_t HEADER_SIZE = 32;
+    constexpr size_t INDEX_ENTRY_SIZE = 24;
+
+    uint32_t read32(const uint8_t* data) {
+        return static_cast<uint32_t>(data[0]) | (static_cast<uint32_t>(data[1]) << 8) |
+               (static_cast<uint32_t>(data[2]) << 16) | (static_cast<uint32_t>(data[3]) << 24);
+    }
+
+    uint64_t read64(const uint8_t* data) {
+        return static_cast<uint64_t>(read32(data)) | (static_cast<uint64_t>(read32(data + 4)) << 32);
+    }
+
+    void write32(uint32_t value, std::vector<uint8_t>& out) {
+        for (int i = 0; i < 4; i++) out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+
+    void write64(uint64_t value, std::vector<uint8_t>& out) {
+        for (int i = 0; i < 8; i++) out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+
+    // Games of one block, filled by the reading thread and compressed by a worker
+    struct PendingBlock {
+        std::string text;
+        std::vector<uint32_t> ends;
+        uint64_t firstGame = 0;
+        std::vector<uint8_t> compressed;
+        uint32_t rawBytes = 0;
+        bool done = false;
+    };
+
+    void compressBlock(PendingBlock& block, int level) {
+        std::vector<uint8_t> raw;
+        raw.reserve(4 + 4 * block.ends.size() + block.text.size());
+        write32(static_cast<uint32_t>(block.ends.size()), raw);
+        for (uint32_t end : block.ends) write32(end, raw);
+        raw.insert(raw.end(), block.text.begin(), block.text.end());
+        std::string().swap(block.text);
+
+        uLongf size = compressBound(static_cast<uLong>(raw.size()));
+        block.compressed.resize(size);
+        if (compress2(block.compressed.data(), &size, raw.data(), static_cast<uLong>(raw.size()), level) != Z_OK) {
+            throw std::runtime_error("zlib could not compress a block");
+        }
+        block.compressed.resize(size);
+        block.rawBytes = static_cast<uint32_t>(raw.size());
+    }
+
+    bool isSpace(char c) {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+    }
+
+    double megabytes(uint64_t bytes) {
+        return static_cast<double>(bytes) / (1024.0 * 1024.0);
+    }
+}
+
+GameArchive::GameArchive() : gameCount(0), blockCount(0), blockIndex(nullptr) {
+}
+
+GameArchive::GameArchive(const std::string& path) : GameArchive() {
+    open(path);
+}
+
+void GameArchive::open(const std::string& path) {
+    file.open(path);
+    const uint8_t* data = file.data();
+    const uint64_t size = file.size();
+    if (size < HEADER_SIZE || std::memcmp(data, "SCHZ", 4) != 0 || data[4] != VERSION) {
+        file.close();
+        throw std::runtime_error(path + " is not a game archive");
+    }
+    gameCount = read64(data + 8);
+    blockCount = read64(data + 16);
+    const uint64_t indexOffset = read64(data + 24);
+    if (indexOffset > size || blockCount > (size - indexOffset) / INDEX_ENTRY_SIZE) {
+        file.close();
+        throw std::runtime_error(path + " is truncated");
+    }
+    blockIndex = data + indexOffset;
+    file.adviseRandomAccess();
+}
+
+uint64_t GameArchive::findBlock(uint64_t game, uint64_t& firstGame) const {
+    // Last block whose first game is not past the game
+    uint64_t low = 0, high = blockCount;
+    while (low < high) {
+        const uint64_t middle = (low + high) / 2;
+        if (read64(blockIndex + middle * INDEX_ENTRY_SIZE + 16) <= game) low = middle + 1;
+        else high = middle;
+    }
+    if (low == 0) throw std::runtime_error("Damaged archive index");
+    firstGame = read64(blockIndex + (low - 1) * INDEX_ENTRY_SIZE + 16);
+    return low - 1;
+}
+
+void GameArchive::decompressBlock(uint64_t block, std::vector<uint8_t>& raw) const {
+    const uint8_t* entry = blockIndex + block * INDEX_ENTRY_SIZE;
+    const uint64_t offset = read64(entry);
+    const uint32_t compressedBytes = read32(entry + 8);
+    const uint32_t rawBytes = read32(entry + 12);
+    if (offset > file.size() || compressedBytes > file.size() - offset || rawBytes < 4) {
+        throw std::runtime_error("Archive block " + std::to_string(block) + " is out of range");
+    }
+    raw.resize(rawBytes);
+    uLongf size = rawBytes;
+    if (uncompress(raw.data(), &size, file.data() + offset, compressedBytes) != Z_OK || size != rawBytes) {
+        throw std::runtime_error("Archive block " + std::to_string(block) + " is damaged");
+    }
+}
+
+std::string GameArchive::getGame(uint64_t game) const {
+    if (game >= gameCount) {
+        throw std::runtime_error("No game " + std::to_string(game) + " in an archive of " + std::to_string(gameCount));
+    }
+    uint64_t firstGame;
+    const uint64_t block = findBlock(game, firstGame);
+    std::vector<uint8_t> raw;
+    decompressBlock(block, raw);
+
+    const uint64_t count = read32(raw.data());
+    const uint64_t position = game - firstGame;
+    if (position >= count || 4 + 4 * count > raw.size()) {
+        throw std::runtime_error("Archive block " + std::to_string(block) + " is damaged");
+    }
+    const size_t textStart = 4 + 4 * count;
+    const uint32_t begin = position == 0 ? 0 : read32(raw.data() + 4 * position);
+    const uint32_t end = read32(raw.data() + 4 + 4 * position);
+    if (begin > end || end > raw.size() - textStart) {
+        throw std::runtime_error("Archive block " + std::to_string(block) + " is damaged");
+    }
+    return std::string(reinterpret_cast<const char*>(raw.data() + textStart + begin), end - begin);
+}
+
+uint64_t GameArchive::exportPgn(const std::string& path, int threads) const {
+    // Where each block's text goes in the output
+    std::vector<uint64_t> starts(blockCount + 1, 0);
+    for (uint64_t block = 0; block < blockCount; block++) {
+        const uint8_t* entry = blockIndex + block * INDEX_ENTRY_SIZE;
+        const uint64_t next = block + 1 < blockCount ? read64(entry + INDEX_ENTRY_SIZE + 16) : gameCount;
+        const uint64_t games = next - read64(entry + 16);
+        const uint64_t rawBytes = read32(entry + 12);
+        if (next < read64(entry + 16) || 4 + 4 * games > rawBytes) throw std::runtime_error("Damaged archive index");
+        starts[block + 1] = starts[block] + rawBytes - 4 - 4 * games;
+    }
+    {
+        std::ofstream create(path, std::ios::binary | std::ios::trunc);
+        if (!create.is_open()) throw std::runtime_error("Could not write " + path);
+    }
+    std::filesystem::resize_file(path, starts[blockCount]);
+
+    threads = std::max(1, threads);
+    std::vector<std::unique_ptr<std::fstream>> outputs(static_cast<size_t>(threads));
+    std::vector<std::vector<uint8_t>> buffers(static_cast<size_t>(threads));
+    std::mutex failureMutex;
+    std::exception_ptr failure;
+    {
+        WorkStealingPool pool(threads);
+        for (uint64_t block = 0; block < blockCount; block++) {
+            pool.submit([&, block](int worker) {
+                try {
+                    std::vector<uint8_t>& raw = buffers[worker];
+                    decompressBlock(block, raw);
+                    const size_t textStart = 4 + 4 * static_cast<size_t>(read32(raw.data()));
+                    if (textStart > raw.size() || raw.size() - textStart != starts[block + 1] - starts[block]) {
+                        throw std::runtime_error("Archive block " + std::to_string(block) + " is damaged");
+                    }
+                    auto& out = outputs[worker];
+                    if (!out) out = std::make_unique<std::fstream>(path, std::ios::in | std::ios::out | std::ios::binary);
+                    out->seekp(static_cast<std::streamoff>(starts[block]));
+                    out->write(reinterpret_cast<const char*>(raw.data() + textStart), static_cast<std::streamsize>(raw.size() - textStart));
+                    if (!*out) throw std::runtime_error("Could not write " + path);
+                }
+                catch (...) {
+                    std::lock_guard<std::mutex> lock(failureMutex);
+                    if (!failure) failure = std::current_exception();
+                }
+            });
+        }
+        pool.wait();
+    }
+    for (auto& out : outputs) {
+        if (!out) continue;
+        out->close();
+        if (!*out && !failure) throw std::runtime_error("Could not write " + path);
+    }
+    if (failure) std::rethrow_exception(failure);
+    return starts[blockCount];
+}
+
+GameArchive::PackReport GameArchive::pack(const PackOptions& options) {
+    const auto start = std::chrono::steady_clock::now();
+    const int threads = std::max(1, options.threads);
+    const int level = std::clamp(options.level, 0, 9);
+    const size_t blockBytes = std::max<size_t>(options.blockBytes, 1024);
+
+    const std::string temporaryPath = options.outputPath + ".tmp";
+    std::ofstream out(temporaryPath, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) throw std::runtime_error("Could not write " + temporaryPath);
+    const std::vector<uint8_t> placeholder(HEADER_SIZE, 0);
+    out.write(reinterpret_cast<const char*>(placeholder.data()), HEADER_SIZE);
+
+    PackReport report;
+    std::vector<uint8_t> index;
+    uint64_t offset = HEADER_SIZE;
+    std::mutex mutex;
+    std::condition_variable blockDone;
+    std::deque<std::shared_ptr<PendingBlock>> pending;
+    std::exception_ptr failure;
+    {
+        WorkStealingPool pool(threads);
+        // Writes finished blocks in order, waiting for the oldest while more than keep are queued
+        auto writeFinished = [&](size_t keep) {
+            std::unique_lock<std::mutex> lock(mutex);
+            while (!pending.empty() && (pending.front()->done || pending.size() > keep)) {
+                blockDone.wait(lock, [&] { return pending.front()->done; });
+                const std::shared_ptr<PendingBlock> block = pending.front();
+                pending.pop_front();
+                if (failure) continue;
+                lock.unlock();
+                write64(offset, index);
+                write32(static_cast<uint32_t>(block->compressed.size()), index);
+                write32(block->rawBytes, index);
+                write64(block->firstGame, index);
+                out.write(reinterpret_cast<const char*>(block->compressed.data()), static_cast<std::streamsize>(block->compressed.size()));
+                offset += block->compressed.size();
+                report.blocks++;
+                lock.lock();
+            }
+        };
+        auto submit = [&](std::shared_ptr<PendingBlock> block) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                pending.push_back(block);
+            }
+            pool.submit([&, block](int) {
+                try {
+                    compressBlock(*block, level);
+                }
+                catch (...) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (!failure) failure = std::current_exception();
+                }
+                std::lock_guard<std::mutex> lock(mutex);
+                block->done = true;
+                blockDone.notify_all();
+            });
+            writeFinished(2 * static_cast<size_t>(threads));
+        };
+
+        auto block = std::make_shared<PendingBlock>();
+        for (const std::string& input : options.inputs) {
+            // Game text is taken from the mapping itself: from the first tag
+            // to the end of the movetext
+            MappedFile mapped;
+            std::error_code error;
+            if (std::filesystem::file_size(input, error) == 0 && !error) continue;
+            mapped.open(input);
+            mapped.adviseSequential();
+            const char* base = reinterpret_cast<const char*>(mapped.data());
+            PgnReader reader(std::string_view(base, mapped.size()));
+            PgnGame game;
+            while (reader.next(game)) {
+                const char* gameEnd = game.movetext.data() + game.movetext.size();
+                while (gameEnd != base + game.offset && isSpace(gameEnd[-1])) gameEnd--;
+                const std::string_view text(base + game.offset, static_cast<size_t>(gameEnd - (base + game.offset)));
+                if (block->text.size() + text.size() + 2 > UINT32_MAX) throw std::runtime_error("Game too large to archive");
+
+                if (block->ends.empty()) block->firstGame = report.games;
+                block->text.append(text);
+                block->text.append("\n\n");
+                block->ends.push_back(static_cast<uint32_t>(block->text.size()));
+                report.games++;
+                report.textBytes += text.size() + 2;
+                if (block->text.size() >= blockBytes) {
+                    submit(block);
+                    block = std::make_shared<PendingBlock>();
+                }
+            }
+        }
+        if (!block->ends.empty()) submit(block);
+        pool.wait();
+        writeFinished(0);
+    }
+    if (failure) std::rethrow_exception(failure);
+
+    out.write(reinterpret_cast<const char*>(index.data()), static_cast<std::streamsize>(index.size()));
+    std::vector<uint8_t> header = { 'S', 'C', 'H', 'Z', VERSION, 0, 0, 0 };
+    write64(report.games, header);
+    write64(report.blocks, header);
+    write64(offset, header);
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(header.data()), static_cast<std::streamsize>(header.size()));
+    out.close();
+    if (!out) throw std::runtime_error("Could not write " + temporaryPath);
+    std::filesystem::rename(temporaryPath, options.outputPath);
+
+    report.bytes = offset + index.size();
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return report;
+}
+
+int Archive::run(const std::vector<std::string>& args) {
+    const std::string command = args.empty() ? "" : args[0];
+    int threads = WorkStealingPool::defaultThreadCount();
+    if (command == "pack") {
+        GameArchive::PackOptions options;
+        bool valid = true;
+        for (size_t i = 1; i < args.size(); i++) {
+            if (args[i] == "--out" && i + 1 < args.size()) options.outputPath = args[++i];
+            else if (args[i] == "--threads" && i + 1 < args.size()) threads = std::max(1, std::stoi(args[++i]));
+            else if (args[i] == "--level" && i + 1 < args.size()) options.level = std::stoi(args[++i]);
+            else if (args[i] == "--block" && i + 1 < args.size()) options.blockBytes = std::stoull(args[++i]) * 1024;
+            else if (args[i].rfind("--", 0) != 0) options.inputs.push_back(args[i]);
+            else valid = false;
+        }
+        options.threads = threads;
+        if (valid && !options.inputs.empty()) {
+            const GameArchive::PackReport report = GameArchive::pack(options);
+            const double seconds = report.seconds > 0.0 ? report.seconds : 1e-9;
+            std::cout << "Packed " << report.games << " games (" << megabytes(report.textBytes) << " MB of PGN) into "
+                      << report.blocks << " blocks with " << threads << " threads in " << report.seconds << " s: "
+                      << megabytes(report.textBytes) / seconds << " MB/s\n"
+                      << "Wrote " << report.bytes << " bytes to " << options.outputPath << " ("
+                      << static_cast<double>(report.textBytes) / static_cast<double>(std::max<uint64_t>(report.bytes, 1))
+                      << "x smaller)\n";
+            return 0;
+        }
+    }
+    if (command == "get" && args.size() >= 3) {
+        const GameArchive archive(args[1]);
+        for (size_t i = 2; i < args.size(); i++) {
+            const uint64_t game = std::stoull(args[i]);
+            const auto start = std::chrono::steady_clock::now();
+            const std::string text = archive.getGame(game);
+            const double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            std::cout << text;
+            // Timing goes to stderr so the games can be redirected to a PGN file
+            std::cerr << "Game " << game << ": " << text.size() << " bytes in " << milliseconds << " ms\n";
+        }
+        return 0;
+    }
+    if (command == "export" && args.size() >= 3) {
+        bool valid = true;
+        for (size_t i = 3; i < args.size(); i++) {
+            if (args[i] == "--threads" && i + 1 < args.size()) threads = std::max(1, std::stoi(args[++i]));
+            else valid = false;
+        }
+        if (valid) {
+            const GameArchive archive(args[1]);
+            const auto start = std::chrono::steady_clock::now();
+            const uint64_t bytes = archive.exportPgn(args[2], threads);
+            const double seconds = std::max(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(), 1e-9);
+            std::cout << "Exported " << archive.getGameCount() << " games (" << megabytes(bytes) << " MB) from "
+                      << archive.getBlockCount() << " blocks with " << threads << " threads in " << seconds << " s: "
+                      << megabytes(bytes) / seconds << " MB/s\n";
+            return 0;
+        }
+    }
+    std::cerr << "Usage: archive pack <games.pgn>... [--out <games_archive.bin>] [--threads N] [--level 0-9] [--block KB]\n"
+              << "       archive get <games_archive.bin> <game id>...\n"
+              << "       archive export <games_archive.bin> <games.pgn> [--threads N]\n";
+    return 1;
+}
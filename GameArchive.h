@@ -0,0 +1,79 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "MappedFile.h"
+
+// Archive of PGN games packed into blocks of about 64 KB of text, each
+// compressed on its own with zlib. A sparse index holds every block's first
+// game id, so fetching one game decompresses only the block holding it,
+// and blocks can be decompressed on any number of threads at once.
+//
+// File layout, little-endian:
+//   "SCHZ", version, 3 zero bytes
+//   uint64 games, blocks, block index offset
+//   blocks
+//   block index: { uint64 offset, uint32 compressed bytes, uint32 raw bytes, uint64 first game } per block
+// A block decompresses to uint32 games, the uint32 end of each game's text,
+// then the texts: each game as it appeared in the PGN, followed by a blank line.
+class GameArchive {
+private:
+    MappedFile file;
+    uint64_t gameCount;
+    uint64_t blockCount;
+    const uint8_t* blockIndex;
+
+    // Block holding the game; its first game id goes to firstGame
+    uint64_t findBlock(uint64_t game, uint64_t& firstGame) const;
+    // Throws std::runtime_error if the block does not decompress
+    void decompressBlock(uint64_t block, std::vector<uint8_t>& raw) const;
+
+public:
+    static constexpr uint8_t VERSION = 1;
+    static constexpr size_t BLOCK_BYTES = 64 * 1024;
+
+    struct PackOptions {
+        std::vector<std::string> inputs;
+        std::string outputPath = "games_archive.bin";
+        int threads = 1;
+        int level = 6;                      // zlib compression level, 0-9
+        size_t blockBytes = BLOCK_BYTES;    // text per block before compression
+    };
+
+    struct PackReport {
+        uint64_t games = 0;
+        uint64_t blocks = 0;
+        uint64_t textBytes = 0;
+        uint64_t bytes = 0;
+        double seconds = 0.0;
+    };
+
+    GameArchive();
+    // Throws std::runtime_error if the file cannot be mapped or is not an archive
+    explicit GameArchive(const std::string& path);
+
+    void open(const std::string& path);
+    bool isOpen() const { return file.isOpen(); }
+
+    // PGN text of one game; throws std::runtime_error for an id past the
+    // end or a damaged block
+    std::string getGame(uint64_t game) const;
+    // Writes every game, in order, to one PGN file. Blocks are decompressed
+    // on all threads and written straight to their place in the output,
+    // whose size the index already gives. Returns the bytes written.
+    uint64_t exportPgn(const std::string& path, int threads) const;
+
+    uint64_t getGameCount() const { return gameCount; }
+    uint64_t getBlockCount() const { return blockCount; }
+    uint64_t getSize() const { return file.size(); }
+
+    // Blocks are compressed on all threads and written in order.
+    // Throws std::runtime_error.
+    static PackReport pack(const PackOptions& options);
+};
+
+namespace Archive {
+    // Command archive: pack PGN files, fetch games by id, export
+    int run(const std::vector<std::string>& args);
+}
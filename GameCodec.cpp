@@ -0,0 +1,550 @@
+#include "GameCodec.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include "Checksum.h"
+#include "MappedFile.h"
+#include "PgnReader.h"
+
+using namespace Bitboards;
+
+namespace {
+    constexpr uint8_t MAGIC[4] = { 'S', 'C', 'H', 'G' };
+    constexpr uint8_t FLAG_FEN = 1;
+    constexpr size_t MAX_STRING = 255;
+
+    void writeLittleEndian(uint32_t value, std::vector<uint8_t>& out) {
+        for (int i = 0; i < 4; i++) out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+
+    uint32_t readLittleEndian(const uint8_t* data) {
+        return static_cast<uint32_t>(data[0]) | (static_cast<uint32_t>(data[1]) << 8) |
+               (static_cast<uint32_t>(data[2]) << 16) | (static_cast<uint32_t>(data[3]) << 24);
+    }
+
+    void writeString(const std::string& text, std::vector<uint8_t>& out) {
+        const size_t length = std::min(text.size(), MAX_STRING);
+        out.push_back(static_cast<uint8_t>(length));
+        out.insert(out.end(), text.begin(), text.begin() + static_cast<std::ptrdiff_t>(length));
+    }
+
+    // Reads a length-prefixed string at cursor; false if it runs past end
+    bool readString(const uint8_t*& cursor, const uint8_t* end, std::string& text) {
+        if (cursor == end || end - cursor - 1 < *cursor) return false;
+        text.assign(reinterpret_cast<const char*>(cursor + 1), *cursor);
+        cursor += 1 + *cursor;
+        return true;
+    }
+
+    constexpr int PAWN_SETS = 7;
+    // from = to - offset for each pawn set, White then Black
+    constexpr int PAWN_OFFSETS[2][PAWN_SETS] = { { -8, -16, -9, -7, -8, -9, -7 }, { 8, 16, 7, 9, 8, 7, 9 } };
+
+    // Legal moves of a position in codec order:
+    //   1. moves of pawns that are not pinned, as destination sets in the
+    //      order single pushes, double pushes, captures towards the a-file,
+    //      captures towards the h-file, then the promoting push and the two
+    //      promoting captures with four entries each (N, B, R, Q); each set
+    //      by to-square
+    //   2. en passant captures by those pawns, by from-square
+    //   3. every other piece (pawns that may be pinned, all pawns when in
+    //      check), the mover's back rank last (White a8 to h1, Black h1 to
+    //      a8) so the king usually comes last; each by to-square
+    // Counting moves up to an index is then a few shifts and popcounts for
+    // the pawns and one attack set per piece; only king moves, pieces that
+    // may be pinned, evasions and en passant are tested square by square.
+    class MoveIndexer {
+    private:
+        const BoardState& state;
+        PieceColor us;
+        Bitboard own;
+        Bitboard enemies;
+        Bitboard occupied;
+        int kingSquare;
+        Bitboard rookSliders;       // enemy rooks and queens
+        Bitboard bishopSliders;     // enemy bishops and queens
+        bool inCheck;
+        Bitboard maybePinned;       // ours and alone between the king and an enemy slider
+        int enPassant;
+        Bitboard enPassantBit;
+        Bitboard promotionSources;  // the row pawns promote from
+        int forward;
+
+        Bitboard freePawns;         // pawns counted as sets
+        Bitboard pawnTargets[PAWN_SETS];
+        int pawnCounts[PAWN_SETS];  // moves in each set
+        Bitboard enPassantPawns;    // free pawns with a legal en passant capture
+        int setMoves;               // moves in parts 1 and 2
+
+        // Whether an enemy piece off the removed squares attacks square. Only
+        // sliders on the square's empty-board lines are looked at, so this
+        // is cheaper than BoardState::attackersTo for both colors.
+        bool attacked(int square, Bitboard occupancy, Bitboard removed) const {
+            const PieceColor them = oppositeColor(us);
+            if ((knightAttacks(square) & state.getPieces(them, PieceType::KNIGHT) & ~removed) ||
+                (pawnAttacks(us, square) & state.getPieces(them, PieceType::PAWN) & ~removed) ||
+                (kingAttacks(square) & state.getPieces(them, PieceType::KING))) {
+                return true;
+            }
+            Bitboard snipers = ((rookAttacks(square, 0) & rookSliders) | (bishopAttacks(square, 0) & bishopSliders)) & ~removed;
+            while (snipers) {
+                if (!(between(square, popLsb(snipers)) & occupancy)) return true;
+            }
+            return false;
+        }
+
+        bool keepsKingSafe(int from, int to, bool enPassantCapture) const {
+            Bitboard removed = squareBit(to);
+            Bitboard occupancy = (occupied ^ squareBit(from)) | squareBit(to);
+            if (enPassantCapture) {
+                const Bitboard captured = squareBit(to - forward);
+                occupancy ^= captured;
+                removed |= captured;
+            }
+            return !attacked(kingSquare, occupancy, removed);
+        }
+
+        bool kingSafeOn(int to) const {
+            return !attacked(to, occupied ^ squareBit(kingSquare), 0);
+        }
+
+        bool canCastle(uint8_t right, int rookSquare, Bitboard path, int step) const {
+            return (state.getCastlingRights() & right) && !inCheck &&
+                   state.getPieceAt(rookSquare) == makePieceCode(us, PieceType::ROOK) &&
+                   !(occupied & path) && kingSafeOn(kingSquare + step) && kingSafeOn(kingSquare + 2 * step);
+        }
+
+        Bitboard kingTargets() const {
+            Bitboard legal = 0;
+            for (Bitboard candidates = kingAttacks(kingSquare) & ~own; candidates;) {
+                const int to = popLsb(candidates);
+                if (kingSafeOn(to)) legal |= squareBit(to);
+            }
+            if (kingSquare == makeSquare(us == PieceColor::WHITE ? 7 : 0, 4)) {
+                const bool white = us == PieceColor::WHITE;
+                if (canCastle(white ? WHITE_KINGSIDE : BLACK_KINGSIDE, kingSquare + 3,
+                              squareBit(kingSquare + 1) | squareBit(kingSquare + 2), 1)) {
+                    legal |= squareBit(kingSquare + 2);
+                }
+                if (canCastle(white ? WHITE_QUEENSIDE : BLACK_QUEENSIDE, kingSquare - 4,
+                              squareBit(kingSquare - 1) | squareBit(kingSquare - 2) | squareBit(kingSquare - 3), -1)) {
+                    legal |= squareBit(kingSquare - 2);
+                }
+            }
+            return legal;
+        }
+
+        void buildPawnSets() {
+            const bool white = us == PieceColor::WHITE;
+            const Bitboard empty = ~occupied;
+            const Bitboard promotionRow = rowMask(white ? 0 : 7);
+            const Bitboard push = (white ? freePawns >> 8 : freePawns << 8) & empty;
+            const Bitboard doublePush = (white ? (push & rowMask(5)) >> 8 : (push & rowMask(2)) << 8) & empty;
+            const Bitboard westCaptures = (white ? (freePawns & ~COL_A) >> 9 : (freePawns & ~COL_A) << 7) & enemies;
+            const Bitboard eastCaptures = (white ? (freePawns & ~COL_H) >> 7 : (freePawns & ~COL_H) << 9) & enemies;
+            const Bitboard targets[PAWN_SETS] = {
+                push & ~promotionRow, doublePush, westCaptures & ~promotionRow, eastCaptures & ~promotionRow,
+                push & promotionRow, westCaptures & promotionRow, eastCaptures & promotionRow };
+            // The promotion sets are empty unless a pawn is about to promote
+            const int sets = (push | westCaptures | eastCaptures) & promotionRow ? PAWN_SETS : 4;
+            setMoves = 0;
+            for (int set = 0; set < PAWN_SETS; set++) {
+                pawnTargets[set] = targets[set];
+                pawnCounts[set] = set < sets ? popCount(targets[set]) * pawnSetEntries(set) : 0;
+                setMoves += pawnCounts[set];
+            }
+
+            enPassantPawns = 0;
+            for (Bitboard capturers = enPassant >= 0 ? pawnAttacks(oppositeColor(us), enPassant) & freePawns : 0; capturers;) {
+                const int from = popLsb(capturers);
+                if (keepsKingSafe(from, enPassant, true)) enPassantPawns |= squareBit(from);
+            }
+            setMoves += popCount(enPassantPawns);
+        }
+
+    public:
+        explicit MoveIndexer(const BoardState& position)
+            : state(position), us(position.getSideToMove()), own(position.getPieces(us)),
+              enemies(position.getPieces(oppositeColor(us))), occupied(position.getOccupied()),
+              kingSquare(position.getKingSquare(us)),
+              rookSliders(position.getPieces(oppositeColor(us), PieceType::ROOK) | position.getPieces(oppositeColor(us), PieceType::QUEEN)),
+              bishopSliders(position.getPieces(oppositeColor(us), PieceType::BISHOP) | position.getPieces(oppositeColor(us), PieceType::QUEEN)),
+              inCheck(false), maybePinned(0),
+              enPassant(position.getEnPassantSquare()), enPassantBit(enPassant >= 0 ? squareBit(enPassant) : 0),
+              promotionSources(rowMask(us == PieceColor::WHITE ? 1 : 6)), forward(us == PieceColor::WHITE ? -8 : 8) {
+            // Enemy sliders on the king's empty-board lines either give check
+            // (nothing between) or pin a lone piece of ours between them
+            const PieceColor them = oppositeColor(us);
+            Bitboard snipers = (rookAttacks(kingSquare, 0) & rookSliders) | (bishopAttacks(kingSquare, 0) & bishopSliders);
+            inCheck = ((knightAttacks(kingSquare) & state.getPieces(them, PieceType::KNIGHT)) |
+                       (pawnAttacks(us, kingSquare) & state.getPieces(them, PieceType::PAWN))) != 0;
+            while (snipers) {
+                const Bitboard blockers = between(kingSquare, popLsb(snipers)) & occupied;
+                if (!blockers) inCheck = true;
+                else if (!(blockers & (blockers - 1)) && (blockers & own)) maybePinned |= blockers;
+            }
+            freePawns = inCheck ? 0 : state.getPieces(us, PieceType::PAWN) & ~maybePinned;
+            buildPawnSets();
+        }
+
+        static int pawnSetEntries(int set) { return set >= 4 ? 4 : 1; }
+
+        Bitboard getFreePawns() const { return freePawns; }
+        Bitboard getPawnTargets(int set) const { return pawnTargets[set]; }
+        int getPawnOffset(int set) const { return PAWN_OFFSETS[static_cast<int>(us)][set]; }
+        int getPawnCount(int set) const { return pawnCounts[set]; }
+        Bitboard getEnPassantPawns() const { return enPassantPawns; }
+        int getSetMoves() const { return setMoves; }
+        // Pieces of part 3
+        Bitboard getOtherPieces() const { return own & ~freePawns; }
+
+        // Part 3 pieces ahead of from
+        Bitboard piecesBefore(int from) const {
+            const Bitboard below = squareBit(from) - 1;
+            return getOtherPieces() & (us == PieceColor::WHITE ? below : ~below & ~squareBit(from));
+        }
+
+        // Removes and returns the first piece of a set in part 3 order
+        int popFirst(Bitboard& pieces) const {
+            if (us == PieceColor::WHITE) return popLsb(pieces);
+            const int square = msb(pieces);
+            pieces ^= squareBit(square);
+            return square;
+        }
+
+        // Legal destinations of a part 3 piece; entries is 4 for a pawn about to promote
+        Bitboard targets(int from, int& entries) const {
+            entries = 1;
+            if (from == kingSquare) return kingTargets();
+
+            const PieceType type = pieceCodeType(state.getPieceAt(from));
+            Bitboard pseudo;
+            Bitboard special = 0;       // en passant, always tested on its own
+            if (type == PieceType::PAWN) {
+                const Bitboard attacks = pawnAttacks(us, from);
+                pseudo = attacks & enemies;
+                special = attacks & enPassantBit;
+                if (!(occupied & squareBit(from + forward))) {
+                    pseudo |= squareBit(from + forward);
+                    if (rowOf(from) == (us == PieceColor::WHITE ? 6 : 1) && !(occupied & squareBit(from + 2 * forward))) {
+                        pseudo |= squareBit(from + 2 * forward);
+                    }
+                }
+                if (promotionSources & squareBit(from)) entries = 4;
+            } else {
+                pseudo = pieceAttacks(type, from, occupied) & ~own;
+            }
+
+            if (!inCheck && !(maybePinned & squareBit(from))) {
+                if (special && keepsKingSafe(from, enPassant, true)) pseudo |= special;
+                return pseudo;
+            }
+            Bitboard legal = 0;
+            for (Bitboard candidates = pseudo | special; candidates;) {
+                const int to = popLsb(candidates);
+                if (keepsKingSafe(from, to, to == enPassant && type == PieceType::PAWN)) legal |= squareBit(to);
+            }
+            return legal;
+        }
+
+        // The engine move for a legal destination; promotion is 0-3 (N, B, R, Q)
+        PackedMove makeMove(int from, int to, int promotion) const {
+            const PieceType type = pieceCodeType(state.getPieceAt(from));
+            const bool capture = state.getPieceAt(to) != NO_PIECE;
+            if (type == PieceType::KING && (to - from == 2 || from - to == 2)) {
+                return PackedMove(from, to, to > from ? PackedMove::KING_CASTLE : PackedMove::QUEEN_CASTLE);
+            }
+            if (type == PieceType::PAWN) {
+                if (to == enPassant) return PackedMove(from, to, PackedMove::EN_PASSANT);
+                if (promotionSources & squareBit(from)) {
+                    return PackedMove(from, to, PackedMove::PROMOTION + promotion + (capture ? PackedMove::CAPTURE : 0));
+                }
+                if (to - from == 2 * forward) return PackedMove(from, to, PackedMove::DOUBLE_PUSH);
+            }
+            return PackedMove(from, to, capture ? PackedMove::CAPTURE : PackedMove::QUIET);
+        }
+    };
+
+    // Index of a move among the legal moves, -1 if it is not one of them
+    int legalIndex(const BoardState& state, PackedMove move) {
+        const MoveIndexer indexer(state);
+        const int from = move.getFrom();
+        const int to = move.getTo();
+        const int promotion = move.isPromotion() ? (move.getFlags() & 3) : 0;
+        if (indexer.makeMove(from, to, promotion) != move) return -1;
+
+        if (indexer.getFreePawns() & squareBit(from)) {
+            const Bitboard enPassantPawns = indexer.getEnPassantPawns();
+            if (move.isEnPassant()) {
+                if (!(enPassantPawns & squareBit(from))) return -1;
+                return indexer.getSetMoves() - popCount(enPassantPawns & ~(squareBit(from) - 1));
+            }
+            int index = 0;
+            for (int set = 0; set < PAWN_SETS; set++) {
+                const Bitboard targets = indexer.getPawnTargets(set);
+                const int entries = MoveIndexer::pawnSetEntries(set);
+                if (to - from == indexer.getPawnOffset(set) && (targets & squareBit(to)) && (entries == 4) == move.isPromotion()) {
+                    return index + popCount(targets & (squareBit(to) - 1)) * entries + promotion;
+                }
+                index += indexer.getPawnCount(set);
+            }
+            return -1;
+        }
+
+        if (!(indexer.getOtherPieces() & squareBit(from))) return -1;
+        int entries;
+        const Bitboard fromTargets = indexer.targets(from, entries);
+        if (!(fromTargets & squareBit(to))) return -1;
+        int index = indexer.getSetMoves() + popCount(fromTargets & (squareBit(to) - 1)) * entries + promotion;
+        for (Bitboard earlier = indexer.piecesBefore(from); earlier;) {
+            const int square = popLsb(earlier);
+            const Bitboard targets = indexer.targets(square, entries);
+            index += popCount(targets) * entries;
+        }
+        return index;
+    }
+
+    // Legal move with the given index, none() if there are not that many
+    PackedMove legalMoveAt(const BoardState& state, int index) {
+        const MoveIndexer indexer(state);
+        if (index < indexer.getSetMoves()) {
+            for (int set = 0; set < PAWN_SETS; set++) {
+                const int count = indexer.getPawnCount(set);
+                if (index >= count) {
+                    index -= count;
+                    continue;
+                }
+                Bitboard targets = indexer.getPawnTargets(set);
+                const int entries = MoveIndexer::pawnSetEntries(set);
+                for (int skip = index / entries; skip > 0; skip--) targets &= targets - 1;
+                const int to = lsb(targets);
+                return indexer.makeMove(to - indexer.getPawnOffset(set), to, index % entries);
+            }
+            Bitboard enPassantPawns = indexer.getEnPassantPawns();
+            for (; index > 0; index--) enPassantPawns &= enPassantPawns - 1;
+            return indexer.makeMove(lsb(enPassantPawns), state.getEnPassantSquare(), 0);
+        }
+
+        index -= indexer.getSetMoves();
+        for (Bitboard pieces = indexer.getOtherPieces(); pieces;) {
+            const int from = indexer.popFirst(pieces);
+            int entries;
+            Bitboard targets = indexer.targets(from, entries);
+            const int count = popCount(targets) * entries;
+            if (index >= count) {
+                index -= count;
+                continue;
+            }
+            for (int skip = index / entries; skip > 0; skip--) targets &= targets - 1;
+            return targets ? indexer.makeMove(from, lsb(targets), index % entries) : PackedMove::none();
+        }
+        return PackedMove::none();
+    }
+
+    GameResult parseResult(std::string_view text) {
+        if (text == "1-0") return GameResult::WHITE_WINS;
+        if (text == "0-1") return GameResult::BLACK_WINS;
+        if (text == "1/2-1/2") return GameResult::DRAW;
+        return GameResult::UNKNOWN;
+    }
+}
+
+bool GameCodec::startPosition(const GameHeader& header, BoardState& state) {
+    if (header.fen.empty()) {
+        // Copied rather than parsed from FEN: decoding sets up one per game
+        static const BoardState start = [] {
+            BoardState position;
+            position.setStartPosition();
+            return position;
+        }();
+        state = start;
+        return true;
+    }
+    return state.setFromFEN(header.fen);
+}
+
+void GameCodec::encode(const GameHeader& header, const std::vector<PackedMove>& moves, std::vector<uint8_t>& out) {
+    BoardState state;
+    if (!startPosition(header, state)) throw std::runtime_error("Bad FEN in game header: " + header.fen);
+
+    const size_t start = out.size();
+    out.insert(out.end(), MAGIC, MAGIC + 4);
+    out.push_back(VERSION);
+    out.push_back(static_cast<uint8_t>(header.result));
+    out.push_back(header.fen.empty() ? 0 : FLAG_FEN);
+    out.push_back(0);
+    writeLittleEndian(static_cast<uint32_t>(moves.size()), out);
+    writeString(header.white, out);
+    writeString(header.black, out);
+    writeString(header.date, out);
+    if (!header.fen.empty()) writeString(header.fen, out);
+    writeLittleEndian(Checksum::crc32(out.data() + start, out.size() - start), out);
+
+    const size_t movesStart = out.size();
+    for (size_t ply = 0; ply < moves.size(); ply++) {
+        const int index = legalIndex(state, moves[ply]);
+        if (index < 0) {
+            out.resize(start);
+            throw std::runtime_error("Move " + std::to_string(ply + 1) + " (" + moves[ply].toUci() + ") is not legal");
+        }
+        out.push_back(static_cast<uint8_t>(index));
+        UndoInfo undo;
+        state.makeMove(moves[ply], undo);
+    }
+    writeLittleEndian(Checksum::crc32(out.data() + movesStart, moves.size()), out);
+}
+
+size_t GameCodec::decode(const uint8_t* data, size_t size, GameHeader& header, std::vector<PackedMove>& moves) {
+    const uint8_t* const end = data + size;
+    if (size < 12 || std::memcmp(data, MAGIC, 4) != 0) throw std::runtime_error("Not a game record");
+    if (data[4] != VERSION) throw std::runtime_error("Unsupported game record version " + std::to_string(data[4]));
+    if (data[5] > static_cast<uint8_t>(GameResult::DRAW)) throw std::runtime_error("Bad game result in record");
+    header.result = static_cast<GameResult>(data[5]);
+    const bool hasFen = (data[6] & FLAG_FEN) != 0;
+    const uint32_t count = readLittleEndian(data + 8);
+
+    const uint8_t* cursor = data + 12;
+    if (!readString(cursor, end, header.white) || !readString(cursor, end, header.black) ||
+        !readString(cursor, end, header.date)) {
+        throw std::runtime_error("Truncated game record");
+    }
+    header.fen.clear();
+    if (hasFen && !readString(cursor, end, header.fen)) throw std::runtime_error("Truncated game record");
+    if (end - cursor < 4 || readLittleEndian(cursor) != Checksum::crc32(data, static_cast<size_t>(cursor - data))) {
+        throw std::runtime_error("Game record header checksum mismatch");
+    }
+    cursor += 4;
+    if (static_cast<uint64_t>(end - cursor) < static_cast<uint64_t>(count) + 4) throw std::runtime_error("Truncated game record");
+    if (readLittleEndian(cursor + count) != Checksum::crc32(cursor, count)) {
+        throw std::runtime_error("Game record move checksum mismatch");
+    }
+
+    BoardState state;
+    if (!startPosition(header, state)) throw std::runtime_error("Bad FEN in game record");
+    moves.clear();
+    moves.reserve(count);
+    for (uint32_t ply = 0; ply < count; ply++) {
+        const PackedMove move = legalMoveAt(state, cursor[ply]);
+        if (move.isNone()) throw std::runtime_error("Bad move index at ply " + std::to_string(ply + 1));
+        moves.push_back(move);
+        UndoInfo undo;
+        state.makeMove(move, undo);
+    }
+    return static_cast<size_t>(cursor + count + 4 - data);
+}
+
+int GameCodec::run(const std::vector<std::string>& args) {
+    std::vector<std::string> inputs;
+    std::string outputPath = "games.bin";
+    bool usageError = false;
+    for (size_t i = 0; i < args.size(); i++) {
+        if (args[i] == "--out" && i + 1 < args.size()) outputPath = args[++i];
+        else if (args[i].rfind("--", 0) != 0) inputs.push_back(args[i]);
+        else usageError = true;
+    }
+    if (inputs.empty() || usageError) {
+        std::cerr << "Usage: gamepack <games.pgn>... [--out <games.bin>]\n";
+        return 1;
+    }
+
+    // Convert, writing the archive in large pieces
+    std::ofstream out(outputPath, std::ios::binary);
+    if (!out.is_open()) {
+        std::cerr << "Could not open " << outputPath << "\n";
+        return 1;
+    }
+    uint64_t games = 0, moves = 0, skipped = 0, pgnBytes = 0, archiveBytes = 0;
+    uint32_t movesCrc = 0;
+    std::vector<uint8_t> buffer;
+    std::vector<PackedMove> gameMoves;
+    GameHeader header;
+    PgnGame game;
+    BoardState state;
+    auto start = std::chrono::steady_clock::now();
+    for (const std::string& input : inputs) {
+        PgnReader reader(input);
+        while (reader.next(game)) {
+            header.white = game.getTag("White");
+            header.black = game.getTag("Black");
+            header.date = game.getTag("Date");
+            header.fen = game.getTag("FEN");
+            header.result = parseResult(game.getTag("Result"));
+            gameMoves.clear();
+            const bool legal = Pgn::replay(game, state, [&](const BoardState&, PackedMove move) {
+                gameMoves.push_back(move);
+                return true;
+            });
+            if (!legal) {
+                skipped++;
+                continue;
+            }
+            GameCodec::encode(header, gameMoves, buffer);
+            movesCrc = Checksum::crc32(gameMoves.data(), gameMoves.size() * sizeof(PackedMove), movesCrc);
+            games++;
+            moves += gameMoves.size();
+            if (buffer.size() >= (1u << 20)) {
+                out.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+                archiveBytes += buffer.size();
+                buffer.clear();
+            }
+        }
+        pgnBytes += reader.getSize();
+    }
+    out.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+    archiveBytes += buffer.size();
+    out.close();
+    if (!out) {
+        std::cerr << "Could not write " << outputPath << "\n";
+        return 1;
+    }
+    const double convertSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // Load both forms: PGN through SAN replay, the archive through the move generator
+    start = std::chrono::steady_clock::now();
+    uint64_t pgnMoves = 0;
+    for (const std::string& input : inputs) {
+        PgnReader reader(input);
+        while (reader.next(game)) {
+            Pgn::replay(game, state, [&](const BoardState&, PackedMove) {
+                pgnMoves++;
+                return true;
+            });
+        }
+    }
+    const double pgnSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    uint64_t decodedGames = 0;
+    uint32_t decodedCrc = 0;
+    try {
+        MappedFile archive;
+        if (archiveBytes > 0) archive.open(outputPath);
+        for (size_t offset = 0; offset < archive.size(); decodedGames++) {
+            offset += GameCodec::decode(archive.data() + offset, archive.size() - offset, header, gameMoves);
+            decodedCrc = Checksum::crc32(gameMoves.data(), gameMoves.size() * sizeof(PackedMove), decodedCrc);
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Reading " << outputPath << " back failed: " << e.what() << "\n";
+        return 1;
+    }
+    const double binarySeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (decodedGames != games || decodedCrc != movesCrc) {
+        std::cerr << "Reading " << outputPath << " back gave different games\n";
+        return 1;
+    }
+
+    const double perMove = moves > 0 ? static_cast<double>(archiveBytes) / static_cast<double>(moves) : 0.0;
+    std::cout << "Packed " << games << " games, " << moves << " moves (" << skipped << " unreadable games skipped) in "
+              << convertSeconds << " s\n";
+    std::cout << "Size: " << pgnBytes << " bytes of PGN -> " << archiveBytes << " bytes (" << perMove
+              << " bytes/move, " << static_cast<double>(pgnBytes) / std::max<double>(static_cast<double>(archiveBytes), 1.0)
+              << "x smaller)\n";
+    std::cout << "Load: PGN with SAN replay " << pgnSeconds << " s (" << pgnMoves << " moves), archive " << binarySeconds
+              << " s (" << static_cast<uint64_t>(static_cast<double>(moves) / std::max(binarySeconds, 1e-9))
+              << " moves/s), read back and verified\n";
+    return 0;
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "BoardState.h"
+#include "PackedMove.h"
+
+enum class GameResult : uint8_t {
+    UNKNOWN,
+    WHITE_WINS,
+    BLACK_WINS,
+    DRAW
+};
+
+struct GameHeader {
+    std::string white;
+    std::string black;
+    std::string date;           // "YYYY.MM.DD" as in PGN
+    std::string fen;            // empty for the standard start position
+    GameResult result = GameResult::UNKNOWN;
+};
+
+// Binary game records. A move is stored as its index among the legal moves
+// of the position, ordered by piece (the mover's back rank last), then
+// to-square, then promotion piece; one byte, since no position has more
+// than 218 moves. Decoding replays the moves, counting legal destinations
+// per piece with bitboards instead of generating move lists.
+//
+// Record layout, little-endian:
+//   "SCHG", version, result, flags (1 = FEN present), 0
+//   uint32 move count
+//   white, black, date[, fen]: uint8 length + bytes each (at most 255)
+//   uint32 CRC-32 of the bytes above
+//   one byte per move
+//   uint32 CRC-32 of the move bytes
+// Records can be concatenated into an archive.
+namespace GameCodec {
+    constexpr uint8_t VERSION = 1;
+
+    // Appends one record; throws std::runtime_error at a bad FEN or a move
+    // that is not legal in its position
+    void encode(const GameHeader& header, const std::vector<PackedMove>& moves, std::vector<uint8_t>& out);
+
+    // Decodes the record starting at data and returns its size in bytes.
+    // Throws std::runtime_error if the record is truncated, a checksum does
+    // not match or a move index is out of range.
+    size_t decode(const uint8_t* data, size_t size, GameHeader& header, std::vector<PackedMove>& moves);
+
+    // Start position of a header: its FEN, or the standard one
+    bool startPosition(const GameHeader& header, BoardState& state);
+
+    // Command gamepack: PGN to a record archive, with size and load-time comparison
+    int run(const std::vector<std::string>& args);
+}
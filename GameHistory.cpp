@@ -1,38 +1,194 @@
 #include "GameHistory.h"
+#include <algorithm>
+
+namespace {
+    // Journal record types
+    constexpr uint8_t RECORD_NEW_GAME = 1;      // header; drops moves and result
+    constexpr uint8_t RECORD_HEADER = 2;        // header
+    constexpr uint8_t RECORD_MOVE = 3;          // from, to, flags (1 capture, 2 castling), promotion
+    constexpr uint8_t RECORD_PROMOTION = 4;     // piece type chosen for the last move
+    constexpr uint8_t RECORD_RESULT = 5;        // GameResult
+
+    constexpr uint8_t MOVE_CAPTURE = 1;
+    constexpr uint8_t MOVE_CASTLING = 2;
+
+    void writeString(const std::string& text, std::vector<uint8_t>& out) {
+        const size_t length = std::min<size_t>(text.size(), 255);
+        out.push_back(static_cast<uint8_t>(length));
+        out.insert(out.end(), text.begin(), text.begin() + static_cast<std::ptrdiff_t>(length));
+    }
+
+    bool readString(const uint8_t*& cursor, const uint8_t* end, std::string& text) {
+        if (cursor == end || end - cursor - 1 < *cursor) return false;
+        text.assign(reinterpret_cast<const char*>(cursor + 1), *cursor);
+        cursor += 1 + *cursor;
+        return true;
+    }
+
+    bool readHeader(const uint8_t* payload, size_t size, GameHeader& header) {
+        const uint8_t* end = payload + size;
+        GameHeader read = header;
+        if (!readString(payload, end, read.white) || !readString(payload, end, read.black) ||
+            !readString(payload, end, read.date) || !readString(payload, end, read.fen)) {
+            return false;
+        }
+        header = read;
+        return true;
+    }
+
+    bool isPieceType(uint8_t value) {
+        return value <= static_cast<uint8_t>(PieceType::PAWN);
+    }
+
+    int squareOf(Position<int> position) {
+        return position.getRow() * 8 + position.getCol();
+    }
+
+    Position<int> positionOf(int square) {
+        return Position<int>(square >> 3, square & 7);
+    }
+
+    // A promotion still waiting for the player's choice counts as a queen
+    bool samePromotion(PackedMove move, PieceType promotion) {
+        if (!move.isPromotion()) return promotion == PieceType::PAWN;
+        return move.getPromotionType() == (promotion == PieceType::PAWN ? PieceType::QUEEN : promotion);
+    }
+}
 
 GameHistory::GameHistory(const std::string& file) 
     : filename(file) {}
 
 void GameHistory::addMove(const Move& move) {
     moves.push_back(move);
+    if (journal.isOpen()) {
+        const uint8_t record[4] = {
+            static_cast<uint8_t>(squareOf(move.getFrom())), static_cast<uint8_t>(squareOf(move.getTo())),
+            static_cast<uint8_t>((move.getIsCapture() ? MOVE_CAPTURE : 0) | (move.getIsCastling() ? MOVE_CASTLING : 0)),
+            static_cast<uint8_t>(move.getPromotion()) };
+        journal.append(RECORD_MOVE, record, sizeof(record));
+    }
+}
+
+void GameHistory::setLastPromotion(PieceType type) {
+    if (moves.empty()) return;
+    moves.back().setPromotion(type);
+    if (journal.isOpen()) {
+        const uint8_t record = static_cast<uint8_t>(type);
+        journal.append(RECORD_PROMOTION, &record, 1);
+    }
+}
+
+void GameHistory::setPlayers(const std::string& white, const std::string& black) {
+    header.white = white;
+    header.black = black;
+    journalHeader(RECORD_HEADER);
+}
+
+void GameHistory::setDate(const std::string& date) {
+    header.date = date;
+    journalHeader(RECORD_HEADER);
+}
+
+void GameHistory::setResult(GameResult result) {
+    header.result = result;
+    if (journal.isOpen()) {
+        const uint8_t record = static_cast<uint8_t>(result);
+        journal.append(RECORD_RESULT, &record, 1);
+    }
+}
+
+void GameHistory::journalHeader(uint8_t type) {
+    if (!journal.isOpen()) return;
+    std::vector<uint8_t> record;
+    writeString(header.white, record);
+    writeString(header.black, record);
+    writeString(header.date, record);
+    writeString(header.fen, record);
+    journal.append(type, record.data(), record.size());
+}
+
+JournalRecovery GameHistory::openJournal(const std::string& path) {
+    const GameHeader current = header;
+    moves.clear();
+    const JournalRecovery recovery = journal.open(path, [&](uint8_t type, const uint8_t* payload, size_t size) {
+        // Records that do not parse are skipped; their checksum was fine,
+        // so they come from a newer version rather than a crash
+        if (type == RECORD_NEW_GAME && readHeader(payload, size, header)) {
+            header.result = GameResult::UNKNOWN;
+            moves.clear();
+        } else if (type == RECORD_HEADER) {
+            readHeader(payload, size, header);
+        } else if (type == RECORD_MOVE && size == 4 && payload[0] < 64 && payload[1] < 64 && isPieceType(payload[3])) {
+            moves.push_back(Move(positionOf(payload[0]), positionOf(payload[1]), (payload[2] & MOVE_CAPTURE) != 0,
+                                 (payload[2] & MOVE_CASTLING) != 0, static_cast<PieceType>(payload[3])));
+        } else if (type == RECORD_PROMOTION && size == 1 && isPieceType(payload[0]) && !moves.empty()) {
+            moves.back().setPromotion(static_cast<PieceType>(payload[0]));
+        } else if (type == RECORD_RESULT && size == 1 && payload[0] <= static_cast<uint8_t>(GameResult::DRAW)) {
+            header.result = static_cast<GameResult>(payload[0]);
+        }
+    });
+
+    bool resume = header.result == GameResult::UNKNOWN && !moves.empty();
+    if (resume) {
+        try {
+            BoardState state;
+            toPackedMoves(state);
+        }
+        catch (const std::exception&) {
+            resume = false;
+        }
+    }
+    if (!resume) {
+        header = current;
+        header.result = GameResult::UNKNOWN;
+        moves.clear();
+        journal.restart();
+        journalHeader(RECORD_NEW_GAME);
+    }
+    return recovery;
+}
+
+void GameHistory::closeJournal() {
+    journal.close();
+}
+
+std::vector<PackedMove> GameHistory::toPackedMoves(BoardState& state) const {
+    if (!GameCodec::startPosition(header, state)) throw std::runtime_error("Bad start position: " + header.fen);
+    std::vector<PackedMove> packed;
+    packed.reserve(moves.size());
+    MoveList legal;
+    for (const Move& move : moves) {
+        const int from = squareOf(move.getFrom());
+        const int to = squareOf(move.getTo());
+        state.generateLegalMoves(legal);
+        const PackedMove* found = std::find_if(legal.begin(), legal.end(), [&](PackedMove candidate) {
+            return candidate.getFrom() == from && candidate.getTo() == to && samePromotion(candidate, move.getPromotion());
+        });
+        if (found == legal.end()) {
+            throw std::runtime_error("Move " + std::to_string(packed.size() + 1) + " is not legal");
+        }
+        packed.push_back(*found);
+        UndoInfo undo;
+        state.makeMove(*found, undo);
+    }
+    return packed;
 }
 
 void GameHistory::saveToFile() {
     try {
-        std::ofstream file(filename);
+        BoardState state;
+        std::vector<uint8_t> record;
+        GameCodec::encode(header, toPackedMoves(state), record);
+
+        std::ofstream file(filename, std::ios::binary);
         if (!file.is_open()) {
             throw std::runtime_error("Could not open file for writing: " + filename);
         }
-
-        file << "Chess Game History\n";
-        file << "==================\n\n";
-
-        int moveNumber = 1;
-        for (const auto& move : moves) {
-            file << "Move " << moveNumber++ << ": "
-                 << "(" << move.getFrom().getRow() << "," << move.getFrom().getCol() << ") -> "
-                 << "(" << move.getTo().getRow() << "," << move.getTo().getCol() << ")";
-            
-            if (move.getIsCapture()) {
-                file << " [Capture]";
-            }
-            if (move.getIsCastling()) {
-                file << " [Castling]";
-            }
-            file << "\n";
-        }
-
+        file.write(reinterpret_cast<const char*>(record.data()), static_cast<std::streamsize>(record.size()));
         file.close();
+        if (!file) {
+            throw std::runtime_error("Could not write " + filename);
+        }
     }
     catch (const std::exception& e) {
         throw std::runtime_error(std::string("Error saving history: ") + e.what());
@@ -41,60 +197,48 @@ void GameHistory::saveToFile() {
 
 void GameHistory::loadFromFile() {
     try {
-        std::ifstream file(filename);
+        std::ifstream file(filename, std::ios::binary | std::ios::ate);
         if (!file.is_open()) {
             throw std::runtime_error("Could not open file for reading: " + filename);
         }
+        std::vector<uint8_t> record(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        file.read(reinterpret_cast<char*>(record.data()), static_cast<std::streamsize>(record.size()));
 
+        GameHeader loadedHeader;
+        std::vector<PackedMove> packed;
+        GameCodec::decode(record.data(), record.size(), loadedHeader, packed);
+
+        header = loadedHeader;
         moves.clear();
-        std::string line;
-        
-        // Skip header
-        std::getline(file, line); // Title
-        std::getline(file, line); // ===
-        std::getline(file, line); // Empty line
-
-        while (std::getline(file, line)) {
-            if (line.empty()) continue;
-
-            // Simple parsing of moves
-            // Format: "Move X: (r1,c1) -> (r2,c2) [optional flags]"
-            size_t fromStart = line.find('(');
-            size_t fromEnd = line.find(')');
-            size_t toStart = line.find('(', fromEnd);
-            size_t toEnd = line.find(')', toStart);
-
-            if (fromStart != std::string::npos && toStart != std::string::npos) {
-                std::string fromStr = line.substr(fromStart + 1, fromEnd - fromStart - 1);
-                std::string toStr = line.substr(toStart + 1, toEnd - toStart - 1);
-
-                int r1, c1, r2, c2;
-                char comma;
-                std::stringstream ss1(fromStr), ss2(toStr);
-                ss1 >> r1 >> comma >> c1;
-                ss2 >> r2 >> comma >> c2;
-
-                bool isCapture = line.find("[Capture]") != std::string::npos;
-                bool isCastling = line.find("[Castling]") != std::string::npos;
-
-                moves.push_back(Move(Position<int>(r1, c1), Position<int>(r2, c2), 
-                                    isCapture, isCastling));
-            }
+        moves.reserve(packed.size());
+        for (PackedMove move : packed) {
+            moves.push_back(Move(positionOf(move.getFrom()), positionOf(move.getTo()), move.isCapture(), move.isCastling(),
+                                 move.isPromotion() ? move.getPromotionType() : PieceType::PAWN));
         }
-
-        file.close();
     }
     catch (const std::exception& e) {
         throw std::runtime_error(std::string("Error loading history: ") + e.what());
     }
 }
 
+BoardState GameHistory::getFinalPosition() const {
+    BoardState state;
+    toPackedMoves(state);
+    return state;
+}
+
 const std::vector<Move>& GameHistory::getMoves() const {
     return moves;
 }
 
 void GameHistory::clear() {
     moves.clear();
+    header.result = GameResult::UNKNOWN;
+    if (journal.isOpen()) {
+        journal.restart();
+        journalHeader(RECORD_NEW_GAME);
+    }
 }
 
 size_t GameHistory::getMoveCount() const {
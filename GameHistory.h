@@ -1,23 +1,55 @@
 #pragma once
 #include <fstream>
-#include <sstream>
 #include <string>
 #include <vector>
 #include <stdexcept>
+#include "BoardState.h"
+#include "GameCodec.h"
 #include "Move.h"
+#include "MoveJournal.h"
 #include "Enums.h"
 
+// Moves of the game being played, saved as one binary GameCodec record
+// (about one byte per move plus the header). With a journal open, every
+// change is also appended to it as it happens, so a crash loses at most the
+// last few milliseconds of play.
 class GameHistory {
 private:
     std::vector<Move> moves;
+    GameHeader header;
     std::string filename;
+    MoveJournal journal;
+
+    void journalHeader(uint8_t type);
+
+    // Engine moves of the game; leaves state at the final position.
+    // Throws std::runtime_error at a move that is not legal.
+    std::vector<PackedMove> toPackedMoves(BoardState& state) const;
 
 public:
-    GameHistory(const std::string& file = "game_history.txt");
+    GameHistory(const std::string& file = "game_history.bin");
 
     void addMove(const Move& move);
+    // Promotions are chosen after the pawn has moved
+    void setLastPromotion(PieceType type);
+    void setPlayers(const std::string& white, const std::string& black);
+    void setDate(const std::string& date);
+    void setResult(GameResult result);
+    const GameHeader& getHeader() const { return header; }
+
     void saveToFile();
     void loadFromFile();
+
+    // Recovers the game recorded in the journal at path and journals every
+    // later change. An unfinished game is resumed; otherwise the journal
+    // restarts with the current header and no moves. Throws
+    // std::runtime_error if the journal cannot be opened.
+    JournalRecovery openJournal(const std::string& path);
+    // Waits until everything journaled is on disk; throws if a write failed
+    void closeJournal();
+
+    // Position after the recorded moves
+    BoardState getFinalPosition() const;
     const std::vector<Move>& getMoves() const;
     void clear();
     size_t getMoveCount() const;
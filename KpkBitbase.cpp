@@ -0,0 +1,176 @@
+#include "KpkBitbase.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+    using Bitboards::colOf;
+    using Bitboards::rowOf;
+
+    // Bit flags so successor results can be OR-ed together
+    enum Result : uint8_t {
+        INVALID = 0,
+        UNKNOWN = 1,
+        DRAW = 2,
+        WIN = 4,
+    };
+
+    using Table = std::array<uint64_t, KpkBitbase::MAX_INDEX / 64>;
+
+    std::atomic<double> generationMilliseconds{ 0.0 };
+
+    // Pawn on rows 1-6 (ranks 7-2) and files a-d
+    int indexOf(PieceColor sideToMove, int whiteKing, int blackKing, int pawn) {
+        return whiteKing | (blackKing << 6) | (static_cast<int>(sideToMove) << 12) |
+               (colOf(pawn) << 13) | ((rowOf(pawn) - 1) << 15);
+    }
+
+    struct Decoded {
+        PieceColor sideToMove;
+        int whiteKing;
+        int blackKing;
+        int pawn;
+    };
+
+    Decoded decode(int index) {
+        return Decoded{
+            static_cast<PieceColor>((index >> 12) & 1),
+            index & 63,
+            (index >> 6) & 63,
+            Bitboards::makeSquare((index >> 15) + 1, (index >> 13) & 3),
+        };
+    }
+
+    int distance(int a, int b) {
+        return std::max(std::abs(rowOf(a) - rowOf(b)), std::abs(colOf(a) - colOf(b)));
+    }
+
+    // Positions decided without looking at successors
+    Result classifyInitial(int index) {
+        const Decoded p = decode(index);
+        if (distance(p.whiteKing, p.blackKing) <= 1 || p.whiteKing == p.pawn || p.blackKing == p.pawn) {
+            return INVALID;
+        }
+        const Bitboard pawnAttacks = Bitboards::pawnAttacks(PieceColor::WHITE, p.pawn);
+        if (p.sideToMove == PieceColor::WHITE) {
+            if (pawnAttacks & Bitboards::squareBit(p.blackKing)) return INVALID;
+
+            // Safe promotion: the queen cannot be taken
+            const int promotion = p.pawn - 8;
+            if (rowOf(p.pawn) == 1 && promotion != p.whiteKing && promotion != p.blackKing &&
+                (distance(p.blackKing, promotion) > 1 || distance(p.whiteKing, promotion) <= 1)) {
+                return WIN;
+            }
+            return UNKNOWN;
+        }
+
+        const Bitboard blackMoves = Bitboards::kingAttacks(p.blackKing);
+        const Bitboard whiteKingAttacks = Bitboards::kingAttacks(p.whiteKing);
+        if ((blackMoves & ~(whiteKingAttacks | pawnAttacks)) == 0) return DRAW;                   // stalemate
+        if (blackMoves & ~whiteKingAttacks & Bitboards::squareBit(p.pawn)) return DRAW;           // pawn falls
+        return UNKNOWN;
+    }
+
+    // White needs one winning move, Black one drawing move
+    Result classify(const std::vector<uint8_t>& results, int index) {
+        const Decoded p = decode(index);
+        int found = INVALID;
+        if (p.sideToMove == PieceColor::WHITE) {
+            Bitboard moves = Bitboards::kingAttacks(p.whiteKing);
+            while (moves) {
+                found |= results[indexOf(PieceColor::BLACK, Bitboards::popLsb(moves), p.blackKing, p.pawn)];
+            }
+            // Promotion is settled by classifyInitial; a push onto a king is INVALID
+            if (rowOf(p.pawn) > 1) {
+                const int push = p.pawn - 8;
+                found |= results[indexOf(PieceColor::BLACK, p.whiteKing, p.blackKing, push)];
+                if (rowOf(p.pawn) == 6 && push != p.whiteKing && push != p.blackKing) {
+                    found |= results[indexOf(PieceColor::BLACK, p.whiteKing, p.blackKing, push - 8)];
+                }
+            }
+            return (found & WIN) ? WIN : (found & UNKNOWN) ? UNKNOWN : DRAW;
+        }
+
+        Bitboard moves = Bitboards::kingAttacks(p.blackKing);
+        while (moves) {
+            found |= results[indexOf(PieceColor::WHITE, p.whiteKing, Bitboards::popLsb(moves), p.pawn)];
+        }
+        return (found & DRAW) ? DRAW : (found & UNKNOWN) ? UNKNOWN : WIN;
+    }
+
+    Table generate() {
+        const auto start = std::chrono::steady_clock::now();
+
+        std::vector<uint8_t> results(KpkBitbase::MAX_INDEX);
+        for (int index = 0; index < KpkBitbase::MAX_INDEX; index++) {
+            results[index] = classifyInitial(index);
+        }
+
+        // Iterate until no UNKNOWN position can be resolved; whatever is left cannot be won
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            for (int index = 0; index < KpkBitbase::MAX_INDEX; index++) {
+                if (results[index] != UNKNOWN) continue;
+                const Result result = classify(results, index);
+                if (result != UNKNOWN) {
+                    results[index] = result;
+                    changed = true;
+                }
+            }
+        }
+
+        Table table{};
+        for (int index = 0; index < KpkBitbase::MAX_INDEX; index++) {
+            if (results[index] == WIN) table[index >> 6] |= 1ULL << (index & 63);
+        }
+
+        generationMilliseconds = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+        return table;
+    }
+
+    const Table& table() {
+        static const Table bits = generate();
+        return bits;
+    }
+}
+
+void KpkBitbase::init() {
+    table();
+}
+
+double KpkBitbase::getGenerationMilliseconds() {
+    return generationMilliseconds;
+}
+
+bool KpkBitbase::probe(PieceColor sideToMove, int whiteKing, int whitePawn, int blackKing) {
+    // Files e-h mirror onto a-d
+    if (colOf(whitePawn) >= 4) {
+        whiteKing ^= 7;
+        whitePawn ^= 7;
+        blackKing ^= 7;
+    }
+    const int index = indexOf(sideToMove, whiteKing, blackKing, whitePawn);
+    return (table()[index >> 6] >> (index & 63)) & 1;
+}
+
+bool KpkBitbase::probe(const BoardState& state, PieceColor strong) {
+    const PieceColor weak = oppositeColor(strong);
+    int strongKing = state.getKingSquare(strong);
+    int pawn = Bitboards::lsb(state.getPieces(strong, PieceType::PAWN));
+    int weakKing = state.getKingSquare(weak);
+    PieceColor sideToMove = state.getSideToMove();
+
+    // Black's pawn: flip the board so the pawn runs towards row 0
+    if (strong == PieceColor::BLACK) {
+        strongKing ^= 56;
+        pawn ^= 56;
+        weakKing ^= 56;
+        sideToMove = oppositeColor(sideToMove);
+    }
+    return probe(sideToMove, strongKing, pawn, weakKing);
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include <cstddef>
+#include "BoardState.h"
+
+// Exact win/draw knowledge for king and pawn versus king. Every position
+// with White holding the pawn on files a-d is classified by retrograde
+// iteration and stored as one bit (set = White wins), 24 KB in total.
+// Other positions are mapped onto that half by mirroring. The table is
+// built on first use; init() lets startup pay the cost up front.
+namespace KpkBitbase {
+    // Side to move x pawn square (files a-d, ranks 2-7) x white king x black king
+    constexpr int MAX_INDEX = 2 * 24 * 64 * 64;
+    constexpr size_t SIZE_BYTES = MAX_INDEX / 8;
+
+    void init();
+
+    // Time spent generating the table, 0 before init
+    double getGenerationMilliseconds();
+
+    // True when White, who has the pawn, wins with best play
+    bool probe(PieceColor sideToMove, int whiteKing, int whitePawn, int blackKing);
+
+    // Same for a KPvK position with the pawn belonging to strong
+    bool probe(const BoardState& state, PieceColor strong);
+}
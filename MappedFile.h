@@ -0,0 +1,41 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Read-only memory mapping of a whole file (MapViewOfFile on Windows, mmap
+// elsewhere). The mapping stays valid until close() or destruction.
+class MappedFile {
+private:
+    const uint8_t* mappedData;
+    size_t mappedSize;
+#ifdef _WIN32
+    void* fileHandle;
+    void* mappingHandle;
+#else
+    int fileDescriptor;
+#endif
+
+public:
+    MappedFile();
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    // Throws std::runtime_error if the file cannot be opened or mapped
+    void open(const std::string& path);
+    void close();
+
+    bool isOpen() const { return mappedData != nullptr; }
+    const uint8_t* data() const { return mappedData; }
+    size_t size() const { return mappedSize; }
+
+    // Access pattern hints for the kernel (madvise); no-ops on Windows
+    void adviseRandomAccess() const;
+    void adviseSequential() const;
+    void adviseWillNeed(size_t offset, size_t length) const;
+};
@@ -0,0 +1,279 @@
+#include "MateSolver.h"
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+namespace {
+    uint32_t saturatingAdd(uint32_t a, uint32_t b, uint32_t limit) {
+        uint64_t sum = static_cast<uint64_t>(a) + b;
+        return sum >= limit ? limit : static_cast<uint32_t>(sum);
+    }
+}
+
+MateSolver::MateSolver(size_t tableMegabytes) : indexMask(0), generation(0), attacker(PieceColor::WHITE),
+    nodes(0), aborted(false) {
+    size_t count = std::max<size_t>(1, tableMegabytes * 1024 * 1024 / sizeof(TableEntry));
+    size_t size = 1;
+    while (size * 2 <= count) size *= 2;
+    table.assign(size, TableEntry{});
+    indexMask = size - 1;
+}
+
+MateResult MateSolver::solve(const std::string& fen, int maxMoves) {
+    BoardState position;
+    if (!position.setFromFEN(fen)) {
+        throw std::runtime_error("Invalid FEN: " + fen);
+    }
+    Options solveOptions;
+    solveOptions.maxMoves = maxMoves;
+    return solve(position, solveOptions);
+}
+
+MateResult MateSolver::solve(const BoardState& position, const Options& solveOptions) {
+    auto start = std::chrono::steady_clock::now();
+    board = position;
+    attacker = position.getSideToMove();
+    options = solveOptions;
+    nodes = 0;
+    aborted = false;
+
+    // Bumping the generation invalidates all entries without clearing memory
+    if (++generation == 0) {
+        std::fill(table.begin(), table.end(), TableEntry{});
+        generation = 1;
+    }
+
+    MateResult result;
+    for (int n = 1; n <= options.maxMoves && !aborted; n++) {
+        if (isProven(n)) {
+            result.found = true;
+            result.mateIn = n;
+            break;
+        }
+    }
+
+    if (result.found) {
+        extractLine(result.mateIn, result.line);
+        std::unordered_set<uint64_t> visited;
+        result.proofSize = countProofTree(result.mateIn, visited);
+    }
+
+    result.nodes = nodes;
+    result.aborted = aborted && !result.found;
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+uint64_t MateSolver::nodeKey(int movesLeft) const {
+    return board.getKey() ^ (static_cast<uint64_t>(movesLeft + 1) * 0x9E3779B97F4A7C15ULL);
+}
+
+bool MateSolver::lookup(uint64_t key, ProofNumbers& numbers) const {
+    const TableEntry& entry = table[key & indexMask];
+    if (entry.generation != generation || entry.key != key) return false;
+    numbers = { entry.proof, entry.disproof };
+    return true;
+}
+
+void MateSolver::store(uint64_t key, const ProofNumbers& numbers) {
+    table[key & indexMask] = { key, numbers.proof, numbers.disproof, generation };
+}
+
+void MateSolver::generateNodeMoves(MoveList& moves) {
+    MoveList pseudo;
+    if (board.getSideToMove() == attacker && options.checksOnly) {
+        board.generateChecks(pseudo);
+    } else {
+        board.generateMoves(pseudo);
+    }
+
+    moves.count = 0;
+    for (PackedMove move : pseudo) {
+        UndoInfo undo;
+        board.makeMove(move, undo);
+        if (board.wasLegalMove()) moves.add(move);
+        board.unmakeMove(move, undo);
+    }
+}
+
+MateSolver::ProofNumbers MateSolver::initialNumbers(int movesLeft) {
+    ProofNumbers numbers;
+    const uint64_t key = nodeKey(movesLeft);
+    if (lookup(key, numbers)) return numbers;
+
+    MoveList moves;
+    generateNodeMoves(moves);
+    const uint32_t count = static_cast<uint32_t>(moves.size());
+
+    if (board.getSideToMove() == attacker) {
+        // Fewer attacking options make a disproof easier
+        numbers = count == 0 ? ProofNumbers{ INFINITE_PN, 0 } : ProofNumbers{ 1, count };
+    } else if (count == 0) {
+        numbers = board.isInCheck() ? ProofNumbers{ 0, INFINITE_PN } : ProofNumbers{ INFINITE_PN, 0 };
+    } else if (movesLeft == 0) {
+        numbers = { INFINITE_PN, 0 };
+    } else {
+        // Fewer defender replies make a proof easier
+        numbers = { count, 1 };
+    }
+
+    if (numbers.proof == 0 || numbers.disproof == 0) store(key, numbers);
+    return numbers;
+}
+
+MateSolver::ProofNumbers MateSolver::mid(int movesLeft, uint32_t proofThreshold, uint32_t disproofThreshold) {
+    if (++nodes >= options.maxNodes) aborted = true;
+
+    const uint64_t key = nodeKey(movesLeft);
+    const bool attackerNode = board.getSideToMove() == attacker;
+
+    MoveList moves;
+    generateNodeMoves(moves);
+
+    ProofNumbers numbers;
+    if (moves.empty()) {
+        if (attackerNode) numbers = { INFINITE_PN, 0 };
+        else numbers = board.isInCheck() ? ProofNumbers{ 0, INFINITE_PN } : ProofNumbers{ INFINITE_PN, 0 };
+        store(key, numbers);
+        return numbers;
+    }
+    if (!attackerNode && movesLeft == 0) {
+        numbers = { INFINITE_PN, 0 };
+        store(key, numbers);
+        return numbers;
+    }
+
+    const int childMovesLeft = attackerNode ? movesLeft - 1 : movesLeft;
+    ProofNumbers children[MAX_CHILDREN];
+    for (int i = 0; i < moves.size(); i++) {
+        UndoInfo undo;
+        board.makeMove(moves[i], undo);
+        children[i] = initialNumbers(childMovesLeft);
+        board.unmakeMove(moves[i], undo);
+    }
+
+    while (true) {
+        // OR node (attacker): proof = min, disproof = sum. AND node: the reverse.
+        uint32_t minimum = INFINITE_PN, sum = 0, second = INFINITE_PN;
+        int best = 0;
+        for (int i = 0; i < moves.size(); i++) {
+            uint32_t selected = attackerNode ? children[i].proof : children[i].disproof;
+            uint32_t summed = attackerNode ? children[i].disproof : children[i].proof;
+            sum = saturatingAdd(sum, summed, INFINITE_PN);
+            if (selected < minimum) {
+                second = minimum;
+                minimum = selected;
+                best = i;
+            } else if (selected < second) {
+                second = selected;
+            }
+        }
+        numbers = attackerNode ? ProofNumbers{ minimum, sum } : ProofNumbers{ sum, minimum };
+
+        if (numbers.proof >= proofThreshold || numbers.disproof >= disproofThreshold || aborted) break;
+
+        uint32_t childProof, childDisproof;
+        const uint32_t secondPlusOne = saturatingAdd(second, 1, INFINITE_PN);
+        if (attackerNode) {
+            childProof = std::min(proofThreshold, secondPlusOne);
+            childDisproof = disproofThreshold >= INFINITE_PN ? INFINITE_PN
+                : disproofThreshold - numbers.disproof + children[best].disproof;
+        } else {
+            childDisproof = std::min(disproofThreshold, secondPlusOne);
+            childProof = proofThreshold >= INFINITE_PN ? INFINITE_PN
+                : proofThreshold - numbers.proof + children[best].proof;
+        }
+
+        UndoInfo undo;
+        board.makeMove(moves[best], undo);
+        children[best] = mid(childMovesLeft, childProof, childDisproof);
+        board.unmakeMove(moves[best], undo);
+    }
+
+    store(key, numbers);
+    return numbers;
+}
+
+bool MateSolver::isProven(int movesLeft) {
+    ProofNumbers numbers;
+    if (lookup(nodeKey(movesLeft), numbers) && (numbers.proof == 0 || numbers.disproof == 0)) {
+        return numbers.proof == 0;
+    }
+    return mid(movesLeft, INFINITE_PN, INFINITE_PN).proof == 0;
+}
+
+int MateSolver::shortestProof(int maxMovesLeft) {
+    for (int n = 1; n <= maxMovesLeft; n++) {
+        if (isProven(n)) return n;
+    }
+    return 0;
+}
+
+void MateSolver::extractLine(int movesLeft, std::vector<PackedMove>& line) {
+    MoveList moves;
+    generateNodeMoves(moves);
+
+    // Attacker: first move that mates within the remaining moves
+    for (PackedMove move : moves) {
+        UndoInfo undo;
+        board.makeMove(move, undo);
+        if (isProven(movesLeft - 1)) {
+            line.push_back(move);
+
+            // Defender: the reply that postpones the mate the longest
+            MoveList replies;
+            generateNodeMoves(replies);
+            PackedMove bestReply = PackedMove::none();
+            int longest = 0;
+            for (PackedMove reply : replies) {
+                UndoInfo replyUndo;
+                board.makeMove(reply, replyUndo);
+                int length = shortestProof(movesLeft - 1);
+                board.unmakeMove(reply, replyUndo);
+                if (length > longest) {
+                    longest = length;
+                    bestReply = reply;
+                }
+            }
+            if (!bestReply.isNone()) {
+                UndoInfo replyUndo;
+                line.push_back(bestReply);
+                board.makeMove(bestReply, replyUndo);
+                extractLine(longest, line);
+                board.unmakeMove(bestReply, replyUndo);
+            }
+            board.unmakeMove(move, undo);
+            return;
+        }
+        board.unmakeMove(move, undo);
+    }
+}
+
+uint64_t MateSolver::countProofTree(int movesLeft, std::unordered_set<uint64_t>& visited) {
+    if (!visited.insert(nodeKey(movesLeft)).second) return 0;
+
+    MoveList moves;
+    generateNodeMoves(moves);
+    uint64_t size = 1;
+
+    if (board.getSideToMove() == attacker) {
+        // One proven child is enough
+        for (PackedMove move : moves) {
+            UndoInfo undo;
+            board.makeMove(move, undo);
+            bool proven = isProven(movesLeft - 1);
+            if (proven) size += countProofTree(movesLeft - 1, visited);
+            board.unmakeMove(move, undo);
+            if (proven) break;
+        }
+    } else {
+        // Every defence has to be refuted
+        for (PackedMove move : moves) {
+            UndoInfo undo;
+            board.makeMove(move, undo);
+            size += countProofTree(movesLeft, visited);
+            board.unmakeMove(move, undo);
+        }
+    }
+    return size;
+}
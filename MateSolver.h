@@ -0,0 +1,74 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "BoardState.h"
+#include "PackedMove.h"
+
+struct MateResult {
+    bool found = false;
+    int mateIn = 0;                  // full moves for the attacker
+    std::vector<PackedMove> line;    // shortest mate, defender resisting longest
+    uint64_t proofSize = 0;          // distinct nodes in the proof tree
+    uint64_t nodes = 0;              // nodes expanded by the search
+    bool aborted = false;            // node budget exhausted
+    double seconds = 0.0;
+};
+
+// Forced-mate prover based on depth-first proof-number search (df-pn).
+// The side to move is the attacker; by default it only considers checking
+// moves. Proof and disproof numbers are kept in a hash table keyed by
+// position and remaining moves, so iterating N = 1, 2, ... reuses work.
+class MateSolver {
+public:
+    struct Options {
+        int maxMoves = 5;
+        bool checksOnly = true;
+        uint64_t maxNodes = 5000000;
+    };
+
+private:
+    struct ProofNumbers {
+        uint32_t proof;
+        uint32_t disproof;
+    };
+
+    struct TableEntry {
+        uint64_t key;
+        uint32_t proof;
+        uint32_t disproof;
+        uint32_t generation;
+    };
+
+    static constexpr uint32_t INFINITE_PN = 1u << 30;
+    static constexpr int MAX_CHILDREN = MoveList::CAPACITY;
+
+    std::vector<TableEntry> table;
+    uint64_t indexMask;
+    uint32_t generation;
+
+    BoardState board;
+    PieceColor attacker;
+    Options options;
+    uint64_t nodes;
+    bool aborted;
+
+    uint64_t nodeKey(int movesLeft) const;
+    bool lookup(uint64_t key, ProofNumbers& numbers) const;
+    void store(uint64_t key, const ProofNumbers& numbers);
+
+    void generateNodeMoves(MoveList& moves);
+    ProofNumbers initialNumbers(int movesLeft);
+    ProofNumbers mid(int movesLeft, uint32_t proofThreshold, uint32_t disproofThreshold);
+    bool isProven(int movesLeft);
+    int shortestProof(int maxMovesLeft);
+    void extractLine(int movesLeft, std::vector<PackedMove>& line);
+    uint64_t countProofTree(int movesLeft, std::unordered_set<uint64_t>& visited);
+
+public:
+    explicit MateSolver(size_t tableMegabytes = 16);
+
+    MateResult solve(const std::string& fen, int maxMoves);
+    MateResult solve(const BoardState& position, const Options& solveOptions);
+};
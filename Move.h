@@ -1,4 +1,5 @@
 #pragma once
+#include "Enums.h"
 #include "Position.h"
 
 class Move {
@@ -7,13 +8,17 @@ class Move {
     Position<int> to;
     bool isCapture;
     bool isCastling;
+    PieceType promotion;    // PAWN when the move is not a promotion
 
 public:
-    Move(Position<int> f, Position<int> t, bool capture = false, bool castling = false)
-        : from(f), to(t), isCapture(capture), isCastling(castling) {}
+    Move(Position<int> f, Position<int> t, bool capture = false, bool castling = false,
+         PieceType promoted = PieceType::PAWN)
+        : from(f), to(t), isCapture(capture), isCastling(castling), promotion(promoted) {}
 
     Position<int> getFrom() const { return from; }
     Position<int> getTo() const { return to; }
     bool getIsCapture() const { return isCapture; }
     bool getIsCastling() const { return isCastling; }
+    PieceType getPromotion() const { return promotion; }
+    void setPromotion(PieceType type) { promotion = type; }
 };
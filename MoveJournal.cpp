@@ -0,0 +1,301 @@
+#include "MoveJournal.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+#include "Checksum.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    constexpr uint8_t MAGIC[4] = { 'S', 'C', 'H', 'J' };
+    constexpr size_t FILE_HEADER_SIZE = 8;
+    constexpr size_t RECORD_OVERHEAD = 3 + 4;   // type and length, CRC
+
+    uint32_t readUint32(const uint8_t* bytes) {
+        return static_cast<uint32_t>(bytes[0]) | (static_cast<uint32_t>(bytes[1]) << 8) |
+               (static_cast<uint32_t>(bytes[2]) << 16) | (static_cast<uint32_t>(bytes[3]) << 24);
+    }
+
+    std::vector<uint8_t> readWholeFile(const std::string& path) {
+        std::vector<uint8_t> bytes;
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file.is_open()) return bytes;
+        bytes.resize(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        file.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        if (!file) throw std::runtime_error("Could not read " + path);
+        return bytes;
+    }
+}
+
+MoveJournal::MoveJournal()
+    :
+#ifdef _WIN32
+      fileHandle(nullptr),
+#else
+      fileDescriptor(-1),
+#endif
+      truncatePending(false), stopping(false), appendedBatches(0), durableBatches(0), syncCount(0) {
+}
+
+MoveJournal::~MoveJournal() {
+    try {
+        close();
+    }
+    catch (const std::exception&) {
+        // Already reported by the writer thread
+    }
+}
+
+JournalRecovery MoveJournal::open(const std::string& file, const RecordVisitor& visit) {
+    close();
+    path = file;
+    writeError.clear();
+    pending.clear();
+    truncatePending = false;
+    appendedBatches = durableBatches = syncCount = 0;
+
+    // Replay the valid prefix
+    const std::vector<uint8_t> bytes = readWholeFile(path);
+    JournalRecovery recovery;
+    size_t validEnd = 0;
+    if (bytes.size() >= FILE_HEADER_SIZE) {
+        if (std::memcmp(bytes.data(), MAGIC, sizeof(MAGIC)) != 0) throw std::runtime_error(path + " is not a move journal");
+        if (bytes[4] != VERSION) throw std::runtime_error(path + ": unsupported journal version " + std::to_string(bytes[4]));
+        validEnd = FILE_HEADER_SIZE;
+        while (bytes.size() - validEnd >= RECORD_OVERHEAD) {
+            const uint8_t* record = bytes.data() + validEnd;
+            const size_t length = static_cast<size_t>(record[1]) | (static_cast<size_t>(record[2]) << 8);
+            if (bytes.size() - validEnd - RECORD_OVERHEAD < length) break;
+            if (Checksum::crc32(record, 3 + length) != readUint32(record + 3 + length)) break;
+            if (visit) visit(record[0], record + 3, length);
+            recovery.records++;
+            validEnd += RECORD_OVERHEAD + length;
+        }
+    } else if (!bytes.empty() && std::memcmp(bytes.data(), MAGIC, std::min(bytes.size(), sizeof(MAGIC))) != 0) {
+        throw std::runtime_error(path + " is not a move journal");
+    }
+    recovery.discardedBytes = bytes.size() - validEnd;
+
+    // Cut the tail and continue appending after the last good record
+#ifdef _WIN32
+    HANDLE handle = CreateFileA(path.c_str(), GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+                                OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) throw std::runtime_error("Could not open " + path + " for writing");
+    fileHandle = handle;
+    LARGE_INTEGER end;
+    end.QuadPart = static_cast<LONGLONG>(validEnd);
+    if (!SetFilePointerEx(handle, end, nullptr, FILE_BEGIN) || !SetEndOfFile(handle)) {
+        closeFile();
+        throw std::runtime_error("Could not truncate " + path);
+    }
+#else
+    const bool created = bytes.empty() && !std::filesystem::exists(path);
+    fileDescriptor = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (fileDescriptor < 0) throw std::runtime_error("Could not open " + path + " for writing");
+    if (ftruncate(fileDescriptor, static_cast<off_t>(validEnd)) != 0) {
+        closeFile();
+        throw std::runtime_error("Could not truncate " + path);
+    }
+#endif
+    try {
+        if (validEnd == 0) {
+            const uint8_t header[FILE_HEADER_SIZE] = { MAGIC[0], MAGIC[1], MAGIC[2], MAGIC[3], VERSION, 0, 0, 0 };
+            writeAll(std::vector<uint8_t>(header, header + FILE_HEADER_SIZE));
+        }
+        sync();
+#ifndef _WIN32
+        // A new file is only durable once its directory entry is
+        if (created) {
+            const std::filesystem::path parent = std::filesystem::path(path).parent_path();
+            const int directory = ::open(parent.empty() ? "." : parent.string().c_str(), O_RDONLY);
+            if (directory >= 0) {
+                fsync(directory);
+                ::close(directory);
+            }
+        }
+#endif
+    }
+    catch (const std::exception&) {
+        closeFile();
+        throw;
+    }
+
+    stopping = false;
+    writer = std::thread(&MoveJournal::writerLoop, this);
+    return recovery;
+}
+
+void MoveJournal::append(uint8_t type, const void* payload, size_t size) {
+    if (size > MAX_PAYLOAD) throw std::runtime_error("Journal record too large");
+    const uint8_t prefix[3] = { type, static_cast<uint8_t>(size), static_cast<uint8_t>(size >> 8) };
+    const uint32_t crc = Checksum::crc32(payload, size, Checksum::crc32(prefix, sizeof(prefix)));
+    const uint8_t suffix[4] = { static_cast<uint8_t>(crc), static_cast<uint8_t>(crc >> 8),
+                                static_cast<uint8_t>(crc >> 16), static_cast<uint8_t>(crc >> 24) };
+    const uint8_t* bytes = static_cast<const uint8_t*>(payload);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!isOpen()) throw std::runtime_error("Journal is not open");
+        pending.insert(pending.end(), prefix, prefix + sizeof(prefix));
+        pending.insert(pending.end(), bytes, bytes + size);
+        pending.insert(pending.end(), suffix, suffix + sizeof(suffix));
+        appendedBatches++;
+    }
+    workAvailable.notify_one();
+}
+
+void MoveJournal::restart() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!isOpen()) throw std::runtime_error("Journal is not open");
+        pending.clear();
+        truncatePending = true;
+        appendedBatches++;
+    }
+    workAvailable.notify_one();
+}
+
+void MoveJournal::flush() {
+    std::unique_lock<std::mutex> lock(mutex);
+    const uint64_t target = appendedBatches;
+    committed.wait(lock, [&]() { return durableBatches >= target || !writeError.empty(); });
+    if (!writeError.empty()) throw std::runtime_error("Journal write failed: " + writeError);
+}
+
+void MoveJournal::close() {
+    if (!isOpen()) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    workAvailable.notify_one();
+    writer.join();
+    closeFile();
+    if (!writeError.empty()) throw std::runtime_error("Journal write failed: " + writeError);
+}
+
+uint64_t MoveJournal::getSyncCount() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return syncCount;
+}
+
+void MoveJournal::writerLoop() {
+    std::vector<uint8_t> batch;
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        workAvailable.wait(lock, [&]() { return stopping || truncatePending || !pending.empty(); });
+        if (!truncatePending && pending.empty()) break;
+
+        // Everything queued so far becomes one write and one sync
+        batch.clear();
+        batch.swap(pending);
+        const bool truncate = std::exchange(truncatePending, false);
+        const uint64_t batchEnd = appendedBatches;
+        const bool failed = !writeError.empty();
+        lock.unlock();
+
+        std::string error;
+        if (!failed) {
+            try {
+                if (truncate) truncateRecords();
+                writeAll(batch);
+                sync();
+            }
+            catch (const std::exception& e) {
+                error = e.what();
+            }
+        }
+
+        lock.lock();
+        if (!error.empty()) {
+            writeError = error;
+            std::cerr << "Journal write failed, later moves are not saved: " << error << "\n";
+        } else if (!failed) {
+            syncCount++;
+        }
+        durableBatches = batchEnd;
+        committed.notify_all();
+    }
+}
+
+#ifdef _WIN32
+
+void MoveJournal::writeAll(const std::vector<uint8_t>& bytes) {
+    size_t written = 0;
+    while (written < bytes.size()) {
+        DWORD count = 0;
+        const DWORD chunk = static_cast<DWORD>(std::min<size_t>(bytes.size() - written, 1u << 30));
+        if (!WriteFile(static_cast<HANDLE>(fileHandle), bytes.data() + written, chunk, &count, nullptr)) {
+            throw std::runtime_error("Could not write " + path);
+        }
+        written += count;
+    }
+}
+
+void MoveJournal::sync() {
+    if (!FlushFileBuffers(static_cast<HANDLE>(fileHandle))) throw std::runtime_error("Could not sync " + path);
+}
+
+void MoveJournal::truncateRecords() {
+    LARGE_INTEGER end;
+    end.QuadPart = static_cast<LONGLONG>(FILE_HEADER_SIZE);
+    if (!SetFilePointerEx(static_cast<HANDLE>(fileHandle), end, nullptr, FILE_BEGIN) ||
+        !SetEndOfFile(static_cast<HANDLE>(fileHandle))) {
+        throw std::runtime_error("Could not truncate " + path);
+    }
+}
+
+void MoveJournal::closeFile() {
+    if (fileHandle != nullptr) CloseHandle(static_cast<HANDLE>(fileHandle));
+    fileHandle = nullptr;
+}
+
+#else
+
+void MoveJournal::writeAll(const std::vector<uint8_t>& bytes) {
+    size_t written = 0;
+    while (written < bytes.size()) {
+        const ssize_t count = ::write(fileDescriptor, bytes.data() + written, bytes.size() - written);
+        if (count < 0) {
+            if (errno == EINTR) continue;
+            throw std::runtime_error("Could not write " + path);
+        }
+        written += static_cast<size_t>(count);
+    }
+}
+
+void MoveJournal::sync() {
+#ifdef __APPLE__
+    const int result = fsync(fileDescriptor);
+#else
+    const int result = fdatasync(fileDescriptor);
+#endif
+    if (result != 0) throw std::runtime_error("Could not sync " + path);
+}
+
+void MoveJournal::truncateRecords() {
+    // O_APPEND puts the next write at the new end
+    if (ftruncate(fileDescriptor, static_cast<off_t>(FILE_HEADER_SIZE)) != 0) {
+        throw std::runtime_error("Could not truncate " + path);
+    }
+}
+
+void MoveJournal::closeFile() {
+    if (fileDescriptor >= 0) ::close(fileDescriptor);
+    fileDescriptor = -1;
+}
+
+#endif
@@ -0,0 +1,85 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct JournalRecovery {
+    uint64_t records = 0;           // valid records replayed
+    uint64_t discardedBytes = 0;    // torn or corrupt tail cut off
+};
+
+// Append-only, crash-safe record log. append() only copies the record into
+// a queue and wakes the writer thread, so it costs microseconds on the
+// caller's thread. The writer writes everything queued in one call and then
+// syncs it to disk (fdatasync / FlushFileBuffers): records arriving while a
+// sync runs are committed together by the next one.
+//
+// File layout: "SCHJ", version, 3 zero bytes, then records of
+//   uint8 type, uint16 payload length (little-endian), payload,
+//   uint32 CRC-32 of type, length and payload
+// A crash can leave a partly written record at the end. Recovery stops at
+// the first record that is truncated or fails its checksum and cuts the
+// file there, so appending continues after the last good record.
+class MoveJournal {
+public:
+    using RecordVisitor = std::function<void(uint8_t type, const uint8_t* payload, size_t size)>;
+
+    static constexpr uint8_t VERSION = 1;
+    static constexpr size_t MAX_PAYLOAD = 0xFFFF;
+
+private:
+    std::string path;
+#ifdef _WIN32
+    void* fileHandle;
+#else
+    int fileDescriptor;
+#endif
+    std::thread writer;
+    std::mutex mutex;
+    std::condition_variable workAvailable;
+    std::condition_variable committed;
+    std::vector<uint8_t> pending;   // records not yet handed to the writer
+    bool truncatePending;           // drop all records before writing pending
+    bool stopping;
+    uint64_t appendedBatches;       // sequence numbers: appended vs durable
+    uint64_t durableBatches;
+    uint64_t syncCount;
+    std::string writeError;
+
+    void writerLoop();
+    // Writer thread only
+    void writeAll(const std::vector<uint8_t>& bytes);
+    void sync();
+    void truncateRecords();
+    void closeFile();
+
+public:
+    MoveJournal();
+    ~MoveJournal();
+
+    MoveJournal(const MoveJournal&) = delete;
+    MoveJournal& operator=(const MoveJournal&) = delete;
+
+    // Opens the journal at path, creating it if missing, replays its valid
+    // records through visit in order and starts the writer thread.
+    // Throws std::runtime_error if the file cannot be opened or is not a journal.
+    JournalRecovery open(const std::string& file, const RecordVisitor& visit);
+
+    // Queues a record; payloads over MAX_PAYLOAD throw std::runtime_error
+    void append(uint8_t type, const void* payload, size_t size);
+    // Drops every record, written or queued; later appends start a new log
+    void restart();
+    // Blocks until everything appended so far is on disk. Throws
+    // std::runtime_error if the writer failed; nothing is written after that.
+    void flush();
+    // Flushes and stops the writer thread
+    void close();
+
+    bool isOpen() const { return writer.joinable(); }
+    uint64_t getSyncCount();
+};
@@ -0,0 +1,323 @@
+#include "Nnue.h"
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+    constexpr char MAGIC[8] = { 'S', 'C', 'H', 'N', 'N', 'U', 'E', '1' };
+    constexpr uint32_t VERSION = 1;
+    constexpr size_t BLOCK_ALIGNMENT = 64;
+
+    struct FileHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t features;
+        uint32_t halfDimensions;
+        uint32_t hidden1;
+        uint32_t hidden2;
+        uint32_t reserved;
+    };
+    static_assert(sizeof(FileHeader) == 32, "NNUE header must stay 32 bytes");
+
+    // Byte size of each block in file order
+    constexpr size_t BLOCK_SIZES[8] = {
+        sizeof(int16_t) * Nnue::HALF_DIMENSIONS,
+        sizeof(int16_t) * Nnue::HALF_DIMENSIONS * static_cast<size_t>(Nnue::FEATURES),
+        sizeof(int32_t) * Nnue::HIDDEN1,
+        sizeof(int8_t) * Nnue::HIDDEN1 * 2 * Nnue::HALF_DIMENSIONS,
+        sizeof(int32_t) * Nnue::HIDDEN2,
+        sizeof(int8_t) * Nnue::HIDDEN2 * Nnue::HIDDEN1,
+        sizeof(int32_t) * 1,
+        sizeof(int8_t) * 1 * Nnue::HIDDEN2,
+    };
+
+    size_t alignUp(size_t offset) {
+        return (offset + BLOCK_ALIGNMENT - 1) / BLOCK_ALIGNMENT * BLOCK_ALIGNMENT;
+    }
+
+    std::atomic<const NnueNetwork*> activeNetwork{ nullptr };
+}
+
+int Nnue::featureIndex(PieceColor perspective, int kingSquare, int piece, int square) {
+    const int flip = perspective == PieceColor::WHITE ? 0 : 56;
+    const int kind = (pieceCodeColor(piece) == perspective ? 0 : 5) + static_cast<int>(pieceCodeType(piece)) - 1;
+    return ((kingSquare ^ flip) * PIECE_KINDS + kind) * 64 + (square ^ flip);
+}
+
+void Nnue::setActiveNetwork(const NnueNetwork* network) {
+    activeNetwork.store(network);
+}
+
+const NnueNetwork* Nnue::getActiveNetwork() {
+    return activeNetwork.load();
+}
+
+NnueNetwork::NnueNetwork(const std::string& path) : file(path) {
+    FileHeader header;
+    if (file.size() < sizeof(header)) {
+        throw std::runtime_error(path + " is not an NNUE network");
+    }
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION) {
+        throw std::runtime_error(path + " is not an NNUE network");
+    }
+    if (header.features != Nnue::FEATURES || header.halfDimensions != Nnue::HALF_DIMENSIONS ||
+        header.hidden1 != Nnue::HIDDEN1 || header.hidden2 != Nnue::HIDDEN2) {
+        throw std::runtime_error(path + " has an unsupported network architecture");
+    }
+
+    const uint8_t* blocks[8];
+    size_t offset = sizeof(header);
+    for (int i = 0; i < 8; i++) {
+        offset = alignUp(offset);
+        if (offset + BLOCK_SIZES[i] > file.size()) {
+            throw std::runtime_error(path + " is truncated");
+        }
+        blocks[i] = file.data() + offset;
+        offset += BLOCK_SIZES[i];
+    }
+
+    // Blocks are 64-byte aligned within a page-aligned mapping
+    featureBias = reinterpret_cast<const int16_t*>(blocks[0]);
+    featureWeights = reinterpret_cast<const int16_t*>(blocks[1]);
+    hidden1Bias = reinterpret_cast<const int32_t*>(blocks[2]);
+    hidden1Weights = reinterpret_cast<const int8_t*>(blocks[3]);
+    hidden2Bias = reinterpret_cast<const int32_t*>(blocks[4]);
+    hidden2Weights = reinterpret_cast<const int8_t*>(blocks[5]);
+    outputBias = reinterpret_cast<const int32_t*>(blocks[6]);
+    outputWeights = reinterpret_cast<const int8_t*>(blocks[7]);
+}
+
+void NnueNetwork::writeRandom(const std::string& path, uint32_t seed) {
+    std::ofstream out(path, std::ios::binary);
+    if (!out.is_open()) {
+        throw std::runtime_error("Could not open " + path);
+    }
+
+    FileHeader header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.features = Nnue::FEATURES;
+    header.halfDimensions = Nnue::HALF_DIMENSIONS;
+    header.hidden1 = Nnue::HIDDEN1;
+    header.hidden2 = Nnue::HIDDEN2;
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    // Ranges keep accumulators inside int16 and the clipped activations busy
+    std::mt19937 random(seed);
+    const int ranges[8][2] = {
+        { 0, 64 }, { -12, 12 }, { -2000, 2000 }, { -32, 32 },
+        { -500, 500 }, { -64, 64 }, { -100, 100 }, { -127, 127 },
+    };
+    const size_t elementSizes[8] = { 2, 2, 4, 1, 4, 1, 4, 1 };
+
+    size_t offset = sizeof(header);
+    std::vector<char> buffer;
+    for (int i = 0; i < 8; i++) {
+        const size_t padding = alignUp(offset) - offset;
+        buffer.assign(padding, 0);
+        out.write(buffer.data(), static_cast<std::streamsize>(padding));
+        offset += padding;
+
+        std::uniform_int_distribution<int> value(ranges[i][0], ranges[i][1]);
+        const size_t count = BLOCK_SIZES[i] / elementSizes[i];
+        buffer.resize(BLOCK_SIZES[i]);
+        for (size_t j = 0; j < count; j++) {
+            const int v = value(random);
+            if (elementSizes[i] == 1) {
+                buffer[j] = static_cast<char>(static_cast<int8_t>(v));
+            } else if (elementSizes[i] == 2) {
+                const int16_t narrow = static_cast<int16_t>(v);
+                std::memcpy(buffer.data() + j * 2, &narrow, 2);
+            } else {
+                const int32_t wide = v;
+                std::memcpy(buffer.data() + j * 4, &wide, 4);
+            }
+        }
+        out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        offset += buffer.size();
+    }
+    if (!out) {
+        throw std::runtime_error("Could not write " + path);
+    }
+}
+
+int NnueNetwork::propagate(const uint8_t* transformed, const NnueKernels& kernels) const {
+    alignas(64) int32_t hidden1[Nnue::HIDDEN1];
+    alignas(64) uint8_t activation1[Nnue::HIDDEN1];
+    alignas(64) int32_t hidden2[Nnue::HIDDEN2];
+    alignas(64) uint8_t activation2[Nnue::HIDDEN2];
+    int32_t output;
+
+    kernels.affine(transformed, 2 * Nnue::HALF_DIMENSIONS, hidden1Weights, hidden1Bias, hidden1, Nnue::HIDDEN1);
+    kernels.clipHidden(hidden1, activation1, Nnue::HIDDEN1, Nnue::WEIGHT_SCALE_BITS);
+    kernels.affine(activation1, Nnue::HIDDEN1, hidden2Weights, hidden2Bias, hidden2, Nnue::HIDDEN2);
+    kernels.clipHidden(hidden2, activation2, Nnue::HIDDEN2, Nnue::WEIGHT_SCALE_BITS);
+    kernels.affine(activation2, Nnue::HIDDEN2, outputWeights, outputBias, &output, 1);
+    return output / Nnue::OUTPUT_SCALE;
+}
+
+int NnueNetwork::evaluate(const BoardState& state, const NnueKernels& kernels) const {
+    alignas(64) int16_t accumulator[Nnue::HALF_DIMENSIONS];
+    alignas(64) uint8_t transformed[2 * Nnue::HALF_DIMENSIONS];
+    const int16_t* rows[32];
+
+    const PieceColor perspectives[2] = { state.getSideToMove(), oppositeColor(state.getSideToMove()) };
+    for (int half = 0; half < 2; half++) {
+        const PieceColor perspective = perspectives[half];
+        const int kingSquare = state.getKingSquare(perspective);
+        int count = 0;
+        for (int square = 0; square < 64; square++) {
+            const int piece = state.getPieceAt(square);
+            if (piece == NO_PIECE || pieceCodeType(piece) == PieceType::KING) continue;
+            rows[count++] = getFeatureWeights(Nnue::featureIndex(perspective, kingSquare, piece, square));
+        }
+        kernels.updateAccumulator(accumulator, featureBias, rows, count, nullptr, 0, Nnue::HALF_DIMENSIONS);
+        kernels.clipAccumulator(accumulator, transformed + half * Nnue::HALF_DIMENSIONS, Nnue::HALF_DIMENSIONS);
+    }
+    return propagate(transformed, kernels);
+}
+
+NnueEvaluator::NnueEvaluator(const NnueNetwork& net, int maxPly, const NnueKernels& kernelSet)
+    : network(net), kernels(&kernelSet), entries(std::make_unique<Entry[]>(maxPly + 1)),
+      capacity(maxPly + 1), top(0), updates(0), refreshes(0) {
+}
+
+void NnueEvaluator::reset(const BoardState& root) {
+    top = 0;
+    Entry& entry = entries[0];
+    entry.dirtyCount = 0;
+    entry.kingMoved[0] = entry.kingMoved[1] = false;
+    refresh(entry, PieceColor::WHITE, root);
+    refresh(entry, PieceColor::BLACK, root);
+}
+
+void NnueEvaluator::push(const BoardState& before, PackedMove move) {
+    if (top + 1 >= capacity) {
+        throw std::runtime_error("NNUE accumulator stack overflow");
+    }
+    Entry& entry = entries[++top];
+    entry.computed[0] = entry.computed[1] = false;
+    entry.kingMoved[0] = entry.kingMoved[1] = false;
+    entry.dirtyCount = 0;
+
+    const int from = move.getFrom();
+    const int to = move.getTo();
+    const int piece = before.getPieceAt(from);
+    const PieceColor us = pieceCodeColor(piece);
+    auto addDirty = [&entry](int dirtyPiece, int dirtyFrom, int dirtyTo) {
+        entry.dirty[entry.dirtyCount++] = {
+            static_cast<int8_t>(dirtyPiece), static_cast<int8_t>(dirtyFrom), static_cast<int8_t>(dirtyTo)
+        };
+    };
+
+    if (move.isCastling()) {
+        // Kings are not features; only the rook changes for the other side
+        const bool kingside = move.getFlags() == PackedMove::KING_CASTLE;
+        addDirty(makePieceCode(us, PieceType::ROOK), kingside ? to + 1 : to - 2, kingside ? to - 1 : to + 1);
+        entry.kingMoved[static_cast<int>(us)] = true;
+        return;
+    }
+
+    if (move.isEnPassant()) {
+        const int captureSquare = to + (us == PieceColor::WHITE ? 8 : -8);
+        addDirty(before.getPieceAt(captureSquare), captureSquare, -1);
+    } else if (move.isCapture()) {
+        addDirty(before.getPieceAt(to), to, -1);
+    }
+
+    if (pieceCodeType(piece) == PieceType::KING) {
+        entry.kingMoved[static_cast<int>(us)] = true;
+    } else if (move.isPromotion()) {
+        addDirty(piece, from, -1);
+        addDirty(makePieceCode(us, move.getPromotionType()), -1, to);
+    } else {
+        addDirty(piece, from, to);
+    }
+}
+
+void NnueEvaluator::pushNull() {
+    if (top + 1 >= capacity) {
+        throw std::runtime_error("NNUE accumulator stack overflow");
+    }
+    Entry& entry = entries[++top];
+    entry.computed[0] = entry.computed[1] = false;
+    entry.kingMoved[0] = entry.kingMoved[1] = false;
+    entry.dirtyCount = 0;
+}
+
+void NnueEvaluator::refresh(Entry& entry, PieceColor perspective, const BoardState& state) {
+    const int16_t* rows[32];
+    const int kingSquare = state.getKingSquare(perspective);
+    int count = 0;
+    for (int piece = 0; piece < 12; piece++) {
+        if (pieceCodeType(piece) == PieceType::KING) continue;
+        Bitboard pieces = state.getPieces(pieceCodeColor(piece), pieceCodeType(piece));
+        while (pieces) {
+            const int square = Bitboards::popLsb(pieces);
+            rows[count++] = network.getFeatureWeights(Nnue::featureIndex(perspective, kingSquare, piece, square));
+        }
+    }
+    const int side = static_cast<int>(perspective);
+    kernels->updateAccumulator(entry.values[side], network.getFeatureBias(), rows, count, nullptr, 0,
+                               Nnue::HALF_DIMENSIONS);
+    entry.computed[side] = true;
+    refreshes++;
+}
+
+void NnueEvaluator::ensureComputed(PieceColor perspective, const BoardState& state) {
+    const int side = static_cast<int>(perspective);
+    if (entries[top].computed[side]) return;
+
+    // Walk back to the last computed accumulator; a king move in between
+    // invalidates every feature of this side, so rebuild instead
+    int source = top;
+    while (!entries[source].computed[side]) {
+        if (entries[source].kingMoved[side]) {
+            refresh(entries[top], perspective, state);
+            return;
+        }
+        source--;
+    }
+
+    const int kingSquare = state.getKingSquare(perspective);
+    for (int index = source + 1; index <= top; index++) {
+        Entry& entry = entries[index];
+        const int16_t* added[3];
+        const int16_t* removed[3];
+        int addedCount = 0;
+        int removedCount = 0;
+        for (int i = 0; i < entry.dirtyCount; i++) {
+            const DirtyPiece& dirty = entry.dirty[i];
+            if (dirty.from >= 0) {
+                removed[removedCount++] = network.getFeatureWeights(
+                    Nnue::featureIndex(perspective, kingSquare, dirty.piece, dirty.from));
+            }
+            if (dirty.to >= 0) {
+                added[addedCount++] = network.getFeatureWeights(
+                    Nnue::featureIndex(perspective, kingSquare, dirty.piece, dirty.to));
+            }
+        }
+        kernels->updateAccumulator(entry.values[side], entries[index - 1].values[side],
+                                   added, addedCount, removed, removedCount, Nnue::HALF_DIMENSIONS);
+        entry.computed[side] = true;
+        updates++;
+    }
+}
+
+const int16_t* NnueEvaluator::getAccumulator(PieceColor perspective, const BoardState& state) {
+    ensureComputed(perspective, state);
+    return entries[top].values[static_cast<int>(perspective)];
+}
+
+int NnueEvaluator::evaluate(const BoardState& state) {
+    alignas(64) uint8_t transformed[2 * Nnue::HALF_DIMENSIONS];
+    const PieceColor us = state.getSideToMove();
+    kernels->clipAccumulator(getAccumulator(us, state), transformed, Nnue::HALF_DIMENSIONS);
+    kernels->clipAccumulator(getAccumulator(oppositeColor(us), state),
+                             transformed + Nnue::HALF_DIMENSIONS, Nnue::HALF_DIMENSIONS);
+    return network.propagate(transformed, *kernels);
+}
@@ -0,0 +1,118 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include "BoardState.h"
+#include "MappedFile.h"
+#include "NnueKernels.h"
+#include "PackedMove.h"
+
+// HalfKP network: each side sees (own king square, piece, square) for every
+// non-king piece, 40960 binary features feeding a 256-wide int16 accumulator.
+// Both accumulators (side to move first) go through 512 -> 32 -> 32 -> 1
+// int8 layers. Squares are mirrored vertically for Black, so the weights
+// always look at the board from the owner's side.
+namespace Nnue {
+    constexpr int PIECE_KINDS = 10;                      // own Q R B N P, then theirs
+    constexpr int FEATURES = 64 * PIECE_KINDS * 64;
+    constexpr int HALF_DIMENSIONS = 256;
+    constexpr int HIDDEN1 = 32;
+    constexpr int HIDDEN2 = 32;
+    constexpr int WEIGHT_SCALE_BITS = 6;                 // shift after each hidden layer
+    constexpr int OUTPUT_SCALE = 16;                     // network units per centipawn
+
+    int featureIndex(PieceColor perspective, int kingSquare, int piece, int square);
+}
+
+// Network weights, read straight out of a memory-mapped file. File layout:
+// a 32-byte header ("SCHNNUE1", version, dimensions) followed by the
+// feature bias/weights (int16), then bias (int32) and weights (int8, one
+// row per output) for each dense layer, every block aligned to 64 bytes.
+class NnueNetwork {
+private:
+    MappedFile file;
+    const int16_t* featureBias;
+    const int16_t* featureWeights;
+    const int32_t* hidden1Bias;
+    const int8_t* hidden1Weights;
+    const int32_t* hidden2Bias;
+    const int8_t* hidden2Weights;
+    const int32_t* outputBias;
+    const int8_t* outputWeights;
+
+public:
+    // Throws std::runtime_error on a missing or malformed file
+    explicit NnueNetwork(const std::string& path);
+
+    // Writes a network with seeded random weights in the loader's format;
+    // useful for exercising the loader, kernels and benchmarks without a trained net
+    static void writeRandom(const std::string& path, uint32_t seed);
+
+    const int16_t* getFeatureBias() const { return featureBias; }
+    const int16_t* getFeatureWeights(int feature) const {
+        return featureWeights + static_cast<size_t>(feature) * Nnue::HALF_DIMENSIONS;
+    }
+
+    // Dense layers on the clipped accumulators (side to move first); centipawns
+    int propagate(const uint8_t* transformed, const NnueKernels& kernels) const;
+
+    // From-scratch evaluation without an accumulator stack, side to move's view
+    int evaluate(const BoardState& state, const NnueKernels& kernels) const;
+};
+
+// Accumulator stack that follows the search: push() before every makeMove,
+// pop() after every unmakeMove. Pushing only records which pieces changed;
+// the accumulator is brought up to date from the nearest computed ancestor
+// when a position is evaluated, and rebuilt from scratch when that side's
+// king has moved since.
+class NnueEvaluator {
+private:
+    struct DirtyPiece {
+        int8_t piece;
+        int8_t from;   // -1 when the piece appears
+        int8_t to;     // -1 when the piece disappears
+    };
+
+    struct Entry {
+        alignas(64) int16_t values[2][Nnue::HALF_DIMENSIONS];
+        bool computed[2];
+        bool kingMoved[2];
+        DirtyPiece dirty[3];
+        int dirtyCount;
+    };
+
+    const NnueNetwork& network;
+    const NnueKernels* kernels;
+    std::unique_ptr<Entry[]> entries;
+    int capacity;
+    int top;
+    uint64_t updates;
+    uint64_t refreshes;
+
+    void refresh(Entry& entry, PieceColor perspective, const BoardState& state);
+    void ensureComputed(PieceColor perspective, const BoardState& state);
+
+public:
+    NnueEvaluator(const NnueNetwork& net, int maxPly, const NnueKernels& kernelSet = NnueKernels::best());
+
+    void reset(const BoardState& root);
+    void push(const BoardState& before, PackedMove move);
+    void pushNull();
+    void pop() { top--; }
+
+    // Centipawns from the side to move's point of view; state must match the top entry
+    int evaluate(const BoardState& state);
+
+    const int16_t* getAccumulator(PieceColor perspective, const BoardState& state);
+    const NnueNetwork& getNetwork() const { return network; }
+    const NnueKernels& getKernels() const { return *kernels; }
+    uint64_t getUpdates() const { return updates; }
+    uint64_t getRefreshes() const { return refreshes; }
+};
+
+namespace Nnue {
+    // Network used by Search when set; the caller keeps it alive. nullptr
+    // (the default) keeps the hand-written evaluation.
+    void setActiveNetwork(const NnueNetwork* network);
+    const NnueNetwork* getActiveNetwork();
+}
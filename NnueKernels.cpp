@@ -0,0 +1,345 @@
+#include "NnueKernels.h"
+#include <algorithm>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define NNUE_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// MSVC accepts any intrinsic in any function; GCC and Clang need the
+// instruction set enabled per function so the rest of the build stays generic
+#if defined(__GNUC__) || defined(__clang__)
+#define NNUE_TARGET(isa) __attribute__((target(isa)))
+#else
+#define NNUE_TARGET(isa)
+#endif
+
+namespace {
+    // ---- Scalar reference ----
+
+    void updateScalar(int16_t* out, const int16_t* in, const int16_t* const* added, int addedCount,
+                      const int16_t* const* removed, int removedCount, int count) {
+        for (int i = 0; i < count; i++) {
+            // Accumulate in 16 bits so overflow wraps exactly like the SIMD adds
+            uint16_t value = static_cast<uint16_t>(in[i]);
+            for (int a = 0; a < addedCount; a++) value = static_cast<uint16_t>(value + static_cast<uint16_t>(added[a][i]));
+            for (int r = 0; r < removedCount; r++) value = static_cast<uint16_t>(value - static_cast<uint16_t>(removed[r][i]));
+            out[i] = static_cast<int16_t>(value);
+        }
+    }
+
+    void clipAccumulatorScalar(const int16_t* in, uint8_t* out, int count) {
+        for (int i = 0; i < count; i++) {
+            out[i] = static_cast<uint8_t>(std::clamp<int>(in[i], 0, 127));
+        }
+    }
+
+    int32_t dotScalar(const uint8_t* input, const int8_t* weights, int count) {
+        int32_t sum = 0;
+        for (int i = 0; i < count; i++) sum += static_cast<int32_t>(input[i]) * weights[i];
+        return sum;
+    }
+
+    void affineScalar(const uint8_t* input, int inputCount, const int8_t* weights,
+                      const int32_t* bias, int32_t* out, int outputCount) {
+        for (int o = 0; o < outputCount; o++) {
+            out[o] = bias[o] + dotScalar(input, weights + o * inputCount, inputCount);
+        }
+    }
+
+    void clipHiddenScalar(const int32_t* in, uint8_t* out, int count, int shift) {
+        for (int i = 0; i < count; i++) {
+            out[i] = static_cast<uint8_t>(std::clamp<int32_t>(in[i] >> shift, 0, 127));
+        }
+    }
+
+    const NnueKernels SCALAR_KERNELS = {
+        "scalar", updateScalar, clipAccumulatorScalar, affineScalar, clipHiddenScalar
+    };
+
+#ifdef NNUE_X86
+    struct CpuFeatures {
+        bool sse41 = false;
+        bool avx2 = false;
+        bool avx512 = false;   // AVX-512 F + BW
+    };
+
+    CpuFeatures detectCpu() {
+        CpuFeatures features;
+#ifdef _MSC_VER
+        int info[4];
+        __cpuid(info, 0);
+        const int maxLeaf = info[0];
+        __cpuid(info, 1);
+        features.sse41 = (info[2] & (1 << 19)) != 0;
+        const bool osSaves = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0;
+        const unsigned long long xcr0 = osSaves ? _xgetbv(0) : 0;
+        if (maxLeaf >= 7) {
+            __cpuidex(info, 7, 0);
+            features.avx2 = (xcr0 & 0x6) == 0x6 && (info[1] & (1 << 5)) != 0;
+            features.avx512 = (xcr0 & 0xE6) == 0xE6 && (info[1] & (1 << 16)) != 0 && (info[1] & (1 << 30)) != 0;
+        }
+#else
+        __builtin_cpu_init();
+        features.sse41 = __builtin_cpu_supports("sse4.1");
+        features.avx2 = __builtin_cpu_supports("avx2");
+        features.avx512 = __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+#endif
+        return features;
+    }
+
+    const CpuFeatures CPU = detectCpu();
+
+    // ---- SSE4.1 ----
+
+    NNUE_TARGET("sse4.1")
+    int32_t horizontalSum128(__m128i sum) {
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+        return _mm_cvtsi128_si32(sum);
+    }
+
+    NNUE_TARGET("sse4.1")
+    void updateSse41(int16_t* out, const int16_t* in, const int16_t* const* added, int addedCount,
+                     const int16_t* const* removed, int removedCount, int count) {
+        int i = 0;
+        for (; i + 8 <= count; i += 8) {
+            __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+            for (int a = 0; a < addedCount; a++) {
+                value = _mm_add_epi16(value, _mm_loadu_si128(reinterpret_cast<const __m128i*>(added[a] + i)));
+            }
+            for (int r = 0; r < removedCount; r++) {
+                value = _mm_sub_epi16(value, _mm_loadu_si128(reinterpret_cast<const __m128i*>(removed[r] + i)));
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), value);
+        }
+        if (i < count) {
+            const int16_t* addedTail[32];
+            const int16_t* removedTail[32];
+            for (int a = 0; a < addedCount; a++) addedTail[a] = added[a] + i;
+            for (int r = 0; r < removedCount; r++) removedTail[r] = removed[r] + i;
+            updateScalar(out + i, in + i, addedTail, addedCount, removedTail, removedCount, count - i);
+        }
+    }
+
+    NNUE_TARGET("sse4.1")
+    void clipAccumulatorSse41(const int16_t* in, uint8_t* out, int count) {
+        const __m128i zero = _mm_setzero_si128();
+        int i = 0;
+        for (; i + 16 <= count; i += 16) {
+            __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+            __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i + 8));
+            __m128i packed = _mm_max_epi8(_mm_packs_epi16(low, high), zero);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), packed);
+        }
+        clipAccumulatorScalar(in + i, out + i, count - i);
+    }
+
+    NNUE_TARGET("sse4.1")
+    void affineSse41(const uint8_t* input, int inputCount, const int8_t* weights,
+                     const int32_t* bias, int32_t* out, int outputCount) {
+        const __m128i ones = _mm_set1_epi16(1);
+        for (int o = 0; o < outputCount; o++) {
+            const int8_t* row = weights + o * inputCount;
+            __m128i sum = _mm_setzero_si128();
+            int i = 0;
+            for (; i + 16 <= inputCount; i += 16) {
+                __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+                __m128i w = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i));
+                sum = _mm_add_epi32(sum, _mm_madd_epi16(_mm_maddubs_epi16(x, w), ones));
+            }
+            out[o] = bias[o] + horizontalSum128(sum) + dotScalar(input + i, row + i, inputCount - i);
+        }
+    }
+
+    NNUE_TARGET("sse4.1")
+    void clipHiddenSse41(const int32_t* in, uint8_t* out, int count, int shift) {
+        const __m128i zero = _mm_setzero_si128();
+        int i = 0;
+        for (; i + 16 <= count; i += 16) {
+            const __m128i* source = reinterpret_cast<const __m128i*>(in + i);
+            __m128i a = _mm_srai_epi32(_mm_loadu_si128(source + 0), shift);
+            __m128i b = _mm_srai_epi32(_mm_loadu_si128(source + 1), shift);
+            __m128i c = _mm_srai_epi32(_mm_loadu_si128(source + 2), shift);
+            __m128i d = _mm_srai_epi32(_mm_loadu_si128(source + 3), shift);
+            __m128i packed = _mm_packs_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_max_epi8(packed, zero));
+        }
+        clipHiddenScalar(in + i, out + i, count - i, shift);
+    }
+
+    const NnueKernels SSE41_KERNELS = {
+        "sse4.1", updateSse41, clipAccumulatorSse41, affineSse41, clipHiddenSse41
+    };
+
+    // ---- AVX2 ----
+
+    NNUE_TARGET("avx2")
+    int32_t horizontalSum256(__m256i sum) {
+        return horizontalSum128(_mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1)));
+    }
+
+    NNUE_TARGET("avx2")
+    void updateAvx2(int16_t* out, const int16_t* in, const int16_t* const* added, int addedCount,
+                    const int16_t* const* removed, int removedCount, int count) {
+        int i = 0;
+        for (; i + 16 <= count; i += 16) {
+            __m256i value = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+            for (int a = 0; a < addedCount; a++) {
+                value = _mm256_add_epi16(value, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(added[a] + i)));
+            }
+            for (int r = 0; r < removedCount; r++) {
+                value = _mm256_sub_epi16(value, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(removed[r] + i)));
+            }
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), value);
+        }
+        if (i < count) {
+            const int16_t* addedTail[32];
+            const int16_t* removedTail[32];
+            for (int a = 0; a < addedCount; a++) addedTail[a] = added[a] + i;
+            for (int r = 0; r < removedCount; r++) removedTail[r] = removed[r] + i;
+            updateScalar(out + i, in + i, addedTail, addedCount, removedTail, removedCount, count - i);
+        }
+    }
+
+    NNUE_TARGET("avx2")
+    void clipAccumulatorAvx2(const int16_t* in, uint8_t* out, int count) {
+        const __m256i zero = _mm256_setzero_si256();
+        int i = 0;
+        for (; i + 32 <= count; i += 32) {
+            __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+            __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i + 16));
+            // packs works per 128-bit lane; put the quarters back in order
+            __m256i packed = _mm256_permute4x64_epi64(_mm256_packs_epi16(low, high), _MM_SHUFFLE(3, 1, 2, 0));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_max_epi8(packed, zero));
+        }
+        clipAccumulatorScalar(in + i, out + i, count - i);
+    }
+
+    NNUE_TARGET("avx2")
+    void affineAvx2(const uint8_t* input, int inputCount, const int8_t* weights,
+                    const int32_t* bias, int32_t* out, int outputCount) {
+        const __m256i ones = _mm256_set1_epi16(1);
+        for (int o = 0; o < outputCount; o++) {
+            const int8_t* row = weights + o * inputCount;
+            __m256i sum = _mm256_setzero_si256();
+            int i = 0;
+            for (; i + 32 <= inputCount; i += 32) {
+                __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + i));
+                __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + i));
+                sum = _mm256_add_epi32(sum, _mm256_madd_epi16(_mm256_maddubs_epi16(x, w), ones));
+            }
+            out[o] = bias[o] + horizontalSum256(sum) + dotScalar(input + i, row + i, inputCount - i);
+        }
+    }
+
+    NNUE_TARGET("avx2")
+    void clipHiddenAvx2(const int32_t* in, uint8_t* out, int count, int shift) {
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+        int i = 0;
+        for (; i + 32 <= count; i += 32) {
+            const __m256i* source = reinterpret_cast<const __m256i*>(in + i);
+            __m256i a = _mm256_srai_epi32(_mm256_loadu_si256(source + 0), shift);
+            __m256i b = _mm256_srai_epi32(_mm256_loadu_si256(source + 1), shift);
+            __m256i c = _mm256_srai_epi32(_mm256_loadu_si256(source + 2), shift);
+            __m256i d = _mm256_srai_epi32(_mm256_loadu_si256(source + 3), shift);
+            __m256i packed = _mm256_packs_epi16(_mm256_packs_epi32(a, b), _mm256_packs_epi32(c, d));
+            packed = _mm256_permutevar8x32_epi32(packed, order);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_max_epi8(packed, zero));
+        }
+        clipHiddenScalar(in + i, out + i, count - i, shift);
+    }
+
+    const NnueKernels AVX2_KERNELS = {
+        "avx2", updateAvx2, clipAccumulatorAvx2, affineAvx2, clipHiddenAvx2
+    };
+
+    // ---- AVX-512 (F + BW) ----
+
+    NNUE_TARGET("avx512f,avx512bw")
+    void updateAvx512(int16_t* out, const int16_t* in, const int16_t* const* added, int addedCount,
+                      const int16_t* const* removed, int removedCount, int count) {
+        int i = 0;
+        for (; i + 32 <= count; i += 32) {
+            __m512i value = _mm512_loadu_si512(in + i);
+            for (int a = 0; a < addedCount; a++) value = _mm512_add_epi16(value, _mm512_loadu_si512(added[a] + i));
+            for (int r = 0; r < removedCount; r++) value = _mm512_sub_epi16(value, _mm512_loadu_si512(removed[r] + i));
+            _mm512_storeu_si512(out + i, value);
+        }
+        if (i < count) {
+            const int16_t* addedTail[32];
+            const int16_t* removedTail[32];
+            for (int a = 0; a < addedCount; a++) addedTail[a] = added[a] + i;
+            for (int r = 0; r < removedCount; r++) removedTail[r] = removed[r] + i;
+            updateAvx2(out + i, in + i, addedTail, addedCount, removedTail, removedCount, count - i);
+        }
+    }
+
+    NNUE_TARGET("avx512f,avx512bw")
+    void clipAccumulatorAvx512(const int16_t* in, uint8_t* out, int count) {
+        const __m512i zero = _mm512_setzero_si512();
+        const __m512i order = _mm512_setr_epi64(0, 2, 4, 6, 1, 3, 5, 7);
+        int i = 0;
+        for (; i + 64 <= count; i += 64) {
+            __m512i low = _mm512_loadu_si512(in + i);
+            __m512i high = _mm512_loadu_si512(in + i + 32);
+            __m512i packed = _mm512_maskz_permutexvar_epi64(0xFF, order, _mm512_packs_epi16(low, high));
+            _mm512_storeu_si512(out + i, _mm512_max_epi8(packed, zero));
+        }
+        clipAccumulatorAvx2(in + i, out + i, count - i);
+    }
+
+    NNUE_TARGET("avx512f,avx512bw")
+    void affineAvx512(const uint8_t* input, int inputCount, const int8_t* weights,
+                      const int32_t* bias, int32_t* out, int outputCount) {
+        if (inputCount < 64) {
+            affineAvx2(input, inputCount, weights, bias, out, outputCount);
+            return;
+        }
+        const __m512i ones = _mm512_set1_epi16(1);
+        for (int o = 0; o < outputCount; o++) {
+            const int8_t* row = weights + o * inputCount;
+            __m512i sum = _mm512_setzero_si512();
+            int i = 0;
+            for (; i + 64 <= inputCount; i += 64) {
+                __m512i x = _mm512_loadu_si512(input + i);
+                __m512i w = _mm512_loadu_si512(row + i);
+                sum = _mm512_add_epi32(sum, _mm512_madd_epi16(_mm512_maddubs_epi16(x, w), ones));
+            }
+            // Lane extracts trip -Wmaybe-uninitialized in some GCC headers; go through memory
+            alignas(64) int32_t lanes[16];
+            _mm512_store_si512(lanes, sum);
+            int32_t total = 0;
+            for (int32_t lane : lanes) total += lane;
+            out[o] = bias[o] + total + dotScalar(input + i, row + i, inputCount - i);
+        }
+    }
+
+    // The hidden layers are only 32 wide, so AVX-512 reuses the AVX2 clip
+    const NnueKernels AVX512_KERNELS = {
+        "avx512", updateAvx512, clipAccumulatorAvx512, affineAvx512, clipHiddenAvx2
+    };
+#endif
+}
+
+const NnueKernels& NnueKernels::scalar() {
+    return SCALAR_KERNELS;
+}
+
+const NnueKernels& NnueKernels::best() {
+    return *available().back();
+}
+
+std::vector<const NnueKernels*> NnueKernels::available() {
+    std::vector<const NnueKernels*> kernels = { &SCALAR_KERNELS };
+#ifdef NNUE_X86
+    if (CPU.sse41) kernels.push_back(&SSE41_KERNELS);
+    if (CPU.avx2) kernels.push_back(&AVX2_KERNELS);
+    if (CPU.avx512) kernels.push_back(&AVX512_KERNELS);
+#endif
+    return kernels;
+}
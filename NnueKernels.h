@@ -0,0 +1,30 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+// Integer kernels behind the NNUE evaluation. Every instruction set
+// implements the same arithmetic as the scalar reference, so results are
+// bit-identical whichever kernel the CPU ends up using.
+struct NnueKernels {
+    const char* name;
+
+    // out = in + sum(added) - sum(removed), int16 with wrap-around, over count values
+    void (*updateAccumulator)(int16_t* out, const int16_t* in,
+                              const int16_t* const* added, int addedCount,
+                              const int16_t* const* removed, int removedCount, int count);
+
+    // out = clamp(in, 0, 127)
+    void (*clipAccumulator)(const int16_t* in, uint8_t* out, int count);
+
+    // out[o] = bias[o] + sum_i input[i] * weights[o * inputCount + i]; inputCount is a
+    // multiple of 16 and weights lie in [-127, 127] so SIMD pair sums cannot saturate
+    void (*affine)(const uint8_t* input, int inputCount, const int8_t* weights,
+                   const int32_t* bias, int32_t* out, int outputCount);
+
+    // out = clamp(in >> shift, 0, 127)
+    void (*clipHidden)(const int32_t* in, uint8_t* out, int count, int shift);
+
+    static const NnueKernels& scalar();
+    static const NnueKernels& best();     // widest kernel this CPU supports
+    static std::vector<const NnueKernels*> available();
+};
@@ -0,0 +1,81 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include "Enums.h"
+
+// Compact 16-bit move used by the engine: bits 0-5 from-square,
+// bits 6-11 to-square, bits 12-15 flags. The UI keeps using Move.
+class PackedMove {
+private:
+    uint16_t data;
+
+public:
+    // Flag values (4 bits)
+    static constexpr int QUIET = 0;
+    static constexpr int DOUBLE_PUSH = 1;
+    static constexpr int KING_CASTLE = 2;
+    static constexpr int QUEEN_CASTLE = 3;
+    static constexpr int CAPTURE = 4;
+    static constexpr int EN_PASSANT = 5;
+    static constexpr int PROMOTION = 8;   // + 0..3 for N, B, R, Q; + CAPTURE for capturing promotions
+
+    PackedMove() = default;  // left uninitialised so move lists are cheap to create
+    constexpr PackedMove(int from, int to, int flags = QUIET)
+        : data(static_cast<uint16_t>(from | (to << 6) | (flags << 12))) {}
+
+    static constexpr PackedMove none() { return PackedMove(0, 0, 0); }
+    static constexpr PackedMove fromRaw(uint16_t raw) {
+        PackedMove move(0, 0, 0);
+        move.data = raw;
+        return move;
+    }
+
+    constexpr int getFrom() const { return data & 0x3F; }
+    constexpr int getTo() const { return (data >> 6) & 0x3F; }
+    constexpr int getFlags() const { return data >> 12; }
+    constexpr uint16_t getRaw() const { return data; }
+
+    constexpr bool isNone() const { return data == 0; }
+    constexpr bool isCapture() const { return (getFlags() & CAPTURE) != 0; }
+    constexpr bool isPromotion() const { return (getFlags() & PROMOTION) != 0; }
+    constexpr bool isEnPassant() const { return getFlags() == EN_PASSANT; }
+    constexpr bool isCastling() const { return getFlags() == KING_CASTLE || getFlags() == QUEEN_CASTLE; }
+    constexpr bool isQuiet() const { return !isCapture() && !isPromotion(); }
+
+    PieceType getPromotionType() const {
+        static constexpr PieceType types[4] = { PieceType::KNIGHT, PieceType::BISHOP, PieceType::ROOK, PieceType::QUEEN };
+        return types[getFlags() & 3];
+    }
+
+    // Long algebraic notation, e.g. "e2e4" or "e7e8q"
+    std::string toUci() const {
+        if (isNone()) return "0000";
+        std::string text;
+        text += static_cast<char>('a' + (getFrom() & 7));
+        text += static_cast<char>('8' - (getFrom() >> 3));
+        text += static_cast<char>('a' + (getTo() & 7));
+        text += static_cast<char>('8' - (getTo() >> 3));
+        if (isPromotion()) text += "nbrq"[getFlags() & 3];
+        return text;
+    }
+
+    constexpr bool operator==(const PackedMove& other) const { return data == other.data; }
+    constexpr bool operator!=(const PackedMove& other) const { return data != other.data; }
+};
+
+// Fixed-capacity move list; no legal chess position has more than 218 moves
+struct MoveList {
+    static constexpr int CAPACITY = 256;
+    PackedMove moves[CAPACITY];
+    int count = 0;
+
+    void add(PackedMove move) { moves[count++] = move; }
+    int size() const { return count; }
+    bool empty() const { return count == 0; }
+    PackedMove& operator[](int index) { return moves[index]; }
+    const PackedMove& operator[](int index) const { return moves[index]; }
+    PackedMove* begin() { return moves; }
+    PackedMove* end() { return moves + count; }
+    const PackedMove* begin() const { return moves; }
+    const PackedMove* end() const { return moves + count; }
+};
@@ -0,0 +1,34 @@
+#include "PawnTable.h"
+#include <algorithm>
+#include <bit>
+
+PawnTable::PawnTable(size_t kilobytes) : indexMask(0), probes(0), hits(0) {
+    size_t count = std::bit_floor(std::max<size_t>(kilobytes * 1024 / sizeof(PawnEntry), 1));
+    entries.resize(count);
+    indexMask = count - 1;
+    clear();
+}
+
+void PawnTable::clear() {
+    // A zeroed entry is the correct result for key 0 (no pawns on the board)
+    std::fill(entries.begin(), entries.end(), PawnEntry{});
+    probes = 0;
+    hits = 0;
+}
+
+PawnEntry& PawnTable::probe(uint64_t key, bool& found) {
+    probes++;
+    PawnEntry& entry = entries[key & indexMask];
+    found = entry.key == key;
+    if (found) hits++;
+    return entry;
+}
+
+double PawnTable::getHitRate() const {
+    return probes == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(probes);
+}
+
+PawnTable& PawnTable::local() {
+    thread_local PawnTable table;
+    return table;
+}
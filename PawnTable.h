@@ -0,0 +1,41 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Bitboard.h"
+
+// Cached pawn-structure evaluation for one pawn configuration. Scores are
+// White minus Black; bitboards are indexed by PieceColor.
+struct PawnEntry {
+    uint64_t key;
+    int16_t mgScore;
+    int16_t egScore;
+    Bitboard passed[2];       // passed pawns
+    Bitboard attackSpan[2];   // squares the pawns can ever attack by advancing
+};
+
+// Direct-mapped hash of pawn evaluations keyed by BoardState::getPawnKey().
+// Pawn structure changes on few moves, so most probes hit. Each search
+// thread uses its own table (see local()), so nothing is synchronized.
+class PawnTable {
+private:
+    std::vector<PawnEntry> entries;
+    uint64_t indexMask;
+    uint64_t probes;
+    uint64_t hits;
+
+public:
+    explicit PawnTable(size_t kilobytes = 4096);
+
+    void clear();
+
+    // Returns the slot for key; found tells whether it already holds key.
+    // On a miss the caller fills the slot, including its key.
+    PawnEntry& probe(uint64_t key, bool& found);
+
+    uint64_t getProbes() const { return probes; }
+    uint64_t getHits() const { return hits; }
+    double getHitRate() const;
+
+    static PawnTable& local();
+};
@@ -0,0 +1,245 @@
+#include "PgnReader.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include "San.h"
+
+namespace {
+    bool isSpace(char c) {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+    }
+
+    // Characters that end a movetext token
+    bool isDelimiter(char c) {
+        return isSpace(c) || c == '{' || c == '}' || c == '(' || c == ')' || c == ';';
+    }
+
+    const char* skipSpaces(const char* cursor, const char* end) {
+        while (cursor != end && isSpace(*cursor)) cursor++;
+        return cursor;
+    }
+
+    const char* findChar(const char* cursor, const char* end, char c) {
+        const void* found = std::memchr(cursor, c, static_cast<size_t>(end - cursor));
+        return found != nullptr ? static_cast<const char*>(found) : end;
+    }
+
+    bool isResult(std::string_view token) {
+        return token == "1-0" || token == "0-1" || token == "1/2-1/2" || token == "*";
+    }
+}
+
+std::string_view PgnGame::getTag(std::string_view name) const {
+    for (const PgnTag& tag : tags) {
+        if (tag.name == name) return tag.value;
+    }
+    return {};
+}
+
+PgnReader::PgnReader(const std::string& path) : position(0), gameCount(0) {
+    std::error_code error;
+    if (std::filesystem::file_size(path, error) == 0 && !error) return;
+    file.open(path);
+    file.adviseSequential();
+    text = std::string_view(reinterpret_cast<const char*>(file.data()), file.size());
+}
+
+PgnReader::PgnReader(std::string_view buffer) : text(buffer), position(0), gameCount(0) {
+}
+
+bool PgnReader::next(PgnGame& game) {
+    const char* const begin = text.data();
+    const char* const end = begin + text.size();
+    const char* cursor = skipSpaces(begin + position, end);
+    if (end - cursor >= 3 && std::memcmp(cursor, "\xEF\xBB\xBF", 3) == 0) cursor = skipSpaces(cursor + 3, end);
+    if (cursor == end) {
+        position = text.size();
+        return false;
+    }
+    game.tags.clear();
+    game.offset = static_cast<uint64_t>(cursor - begin);
+
+    // Tag pairs, one per line: [Name "value"]
+    while (cursor != end && *cursor == '[') {
+        const char* lineEnd = findChar(cursor, end, '\n');
+        const char* name = skipSpaces(cursor + 1, lineEnd);
+        const char* nameEnd = name;
+        while (nameEnd != lineEnd && !isSpace(*nameEnd) && *nameEnd != '"' && *nameEnd != ']') nameEnd++;
+        const char* value = findChar(nameEnd, lineEnd, '"');
+        if (value != lineEnd && nameEnd != name) {
+            const char* valueEnd = ++value;
+            while (valueEnd != lineEnd && *valueEnd != '"') valueEnd += (*valueEnd == '\\' && valueEnd + 1 != lineEnd) ? 2 : 1;
+            game.tags.push_back(PgnTag{ std::string_view(name, static_cast<size_t>(nameEnd - name)),
+                                        std::string_view(value, static_cast<size_t>(valueEnd - value)) });
+        }
+        cursor = skipSpaces(lineEnd, end);
+    }
+
+    // Movetext runs to the next line starting with '[' outside a comment
+    const char* movetext = cursor;
+    while (cursor != end) {
+        const char c = *cursor;
+        if (c == '{') {
+            cursor = findChar(cursor + 1, end, '}');
+            if (cursor != end) cursor++;
+        } else if (c == ';') {
+            cursor = findChar(cursor + 1, end, '\n');
+        } else if (c == '\n') {
+            cursor++;
+            if (cursor != end && *cursor == '[') break;
+        } else {
+            cursor++;
+        }
+    }
+    game.movetext = std::string_view(movetext, static_cast<size_t>(cursor - movetext));
+    position = static_cast<size_t>(cursor - begin);
+    gameCount++;
+    return true;
+}
+
+bool Pgn::tokenize(std::string_view movetext, bool variations, const TokenVisitor& visit) {
+    const char* const begin = movetext.data();
+    const char* const end = begin + movetext.size();
+    const char* cursor = begin;
+    int skippedDepth = 0;   // nesting of the variation being skipped
+
+    while (cursor != end) {
+        const char c = *cursor;
+        if (isSpace(c) || c == '}') {
+            cursor++;
+            continue;
+        }
+        if (c == '{' || c == ';' || (c == '%' && (cursor == begin || cursor[-1] == '\n'))) {
+            // Brace comment, rest-of-line comment, or an escaped line
+            const char* close = findChar(cursor + 1, end, c == '{' ? '}' : '\n');
+            if (c != '%' && skippedDepth == 0 &&
+                !visit(PgnToken::COMMENT, std::string_view(cursor + 1, static_cast<size_t>(close - cursor - 1)))) {
+                return false;
+            }
+            cursor = close == end ? end : close + 1;
+            continue;
+        }
+        if (c == '(' || c == ')') {
+            cursor++;
+            if (!variations) {
+                if (c == '(') skippedDepth++;
+                else if (skippedDepth > 0) skippedDepth--;
+            } else if (!visit(c == '(' ? PgnToken::VARIATION_START : PgnToken::VARIATION_END, std::string_view(cursor - 1, 1))) {
+                return false;
+            }
+            continue;
+        }
+
+        const char* tokenEnd = cursor;
+        while (tokenEnd != end && !isDelimiter(*tokenEnd)) tokenEnd++;
+        std::string_view token(cursor, static_cast<size_t>(tokenEnd - cursor));
+        cursor = tokenEnd;
+        if (skippedDepth > 0) continue;
+
+        if (c == '$') {
+            if (!visit(PgnToken::NAG, token)) return false;
+            continue;
+        }
+        if (isResult(token)) {
+            if (!visit(PgnToken::RESULT, token)) return false;
+            continue;
+        }
+        // Move number, possibly glued to the move as in "12.e4" or "12...Nf6"
+        if (c >= '1' && c <= '9') {
+            const size_t digits = std::min(token.find_first_not_of("0123456789"), token.size());
+            if (digits < token.size() && token[digits] == '.') {
+                token.remove_prefix(std::min(token.find_first_not_of('.', digits), token.size()));
+            }
+        }
+        if (token.empty() || token == "e.p.") continue;
+        if (!visit(PgnToken::MOVE, token)) return false;
+    }
+    return true;
+}
+
+bool Pgn::replay(const PgnGame& game, BoardState& state, const MoveVisitor& onMove) {
+    const std::string_view fen = game.getTag("FEN");
+    if (fen.empty()) state.setStartPosition();
+    else if (!state.setFromFEN(fen)) return false;
+
+    bool legal = true;
+    tokenize(game.movetext, false, [&](PgnToken type, std::string_view text) {
+        if (type != PgnToken::MOVE) return true;
+        const PackedMove move = San::parse(state, text);
+        if (move.isNone()) {
+            legal = false;
+            return false;
+        }
+        if (onMove && !onMove(state, move)) return false;
+        UndoInfo undo;
+        state.makeMove(move, undo);
+        return true;
+    });
+    return legal;
+}
+
+int Pgn::run(const std::vector<std::string>& args) {
+    std::vector<std::string> inputs;
+    bool replayMoves = true;
+    bool variations = false;
+    bool usageError = false;
+    for (const std::string& arg : args) {
+        if (arg == "--no-replay") replayMoves = false;
+        else if (arg == "--variations") variations = true;
+        else if (arg.rfind("--", 0) != 0) inputs.push_back(arg);
+        else usageError = true;
+    }
+    if (inputs.empty() || usageError) {
+        std::cerr << "Usage: pgnread <games.pgn>... [--no-replay] [--variations]\n";
+        return 1;
+    }
+
+    uint64_t games = 0, moves = 0, badGames = 0, comments = 0, nags = 0, variationCount = 0;
+    size_t bytes = 0;
+    const auto start = std::chrono::steady_clock::now();
+    PgnGame game;
+    BoardState state;
+    for (const std::string& input : inputs) {
+        PgnReader reader(input);
+        while (reader.next(game)) {
+            games++;
+            if (replayMoves) {
+                uint64_t played = 0;
+                const bool legal = Pgn::replay(game, state, [&](const BoardState&, PackedMove) {
+                    played++;
+                    return true;
+                });
+                moves += played;
+                if (!legal) {
+                    badGames++;
+                    if (badGames <= 10) {
+                        std::cerr << input << " @" << game.offset << ": stopped after " << played << " plies ("
+                                  << game.getTag("White") << " - " << game.getTag("Black") << ")\n";
+                    }
+                }
+            }
+            // Counting pass; it also shows what skipping variations saves
+            Pgn::tokenize(game.movetext, variations, [&](PgnToken type, std::string_view) {
+                if (type == PgnToken::COMMENT) comments++;
+                else if (type == PgnToken::NAG) nags++;
+                else if (type == PgnToken::VARIATION_START) variationCount++;
+                else if (type == PgnToken::MOVE && !replayMoves) moves++;
+                return true;
+            });
+        }
+        bytes += reader.getSize();
+    }
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const double rateSeconds = std::max(seconds, 1e-9);
+    std::cout << "Games: " << games << " (" << badGames << " with an illegal or unreadable move)\n";
+    std::cout << (replayMoves ? "Moves replayed: " : "Move tokens: ") << moves << "\n";
+    std::cout << "Comments: " << comments << ", NAGs: " << nags;
+    if (variations) std::cout << ", variations: " << variationCount;
+    std::cout << "\n";
+    std::cout << "Time: " << seconds << " s, " << static_cast<uint64_t>(static_cast<double>(games) / rateSeconds)
+              << " games/s, " << static_cast<double>(bytes) / (1024.0 * 1024.0) / rateSeconds << " MB/s\n";
+    return 0;
+}
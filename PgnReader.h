@@ -0,0 +1,80 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "BoardState.h"
+#include "MappedFile.h"
+#include "PackedMove.h"
+
+// Tag pair; the value is still escaped (\" and \\) as in the file
+struct PgnTag {
+    std::string_view name;
+    std::string_view value;
+};
+
+// One game as views into the reader's text, valid while the reader lives
+struct PgnGame {
+    std::vector<PgnTag> tags;
+    std::string_view movetext;
+    uint64_t offset = 0;        // of the game's first byte
+
+    // Empty when the tag is missing
+    std::string_view getTag(std::string_view name) const;
+};
+
+enum class PgnToken {
+    MOVE,               // SAN text, annotation glyphs included
+    COMMENT,            // {...} or ; comment, without the delimiters
+    NAG,                // "$1"
+    VARIATION_START,
+    VARIATION_END,
+    RESULT              // "1-0", "0-1", "1/2-1/2" or "*"
+};
+
+// Streaming PGN reader. A file is memory-mapped and read front to back;
+// tags and movetext are handed out as string_views into the mapping, so
+// reading a game copies nothing and allocates nothing once the tag vector
+// has grown. Movetext is only tokenized on request.
+class PgnReader {
+private:
+    MappedFile file;
+    std::string_view text;
+    size_t position;
+    uint64_t gameCount;
+
+public:
+    // Throws std::runtime_error if the file cannot be mapped; an empty file has no games
+    explicit PgnReader(const std::string& path);
+    // Reads games from text the caller keeps alive
+    explicit PgnReader(std::string_view buffer);
+
+    // Next game, false at the end of the text
+    bool next(PgnGame& game);
+
+    uint64_t getGameCount() const { return gameCount; }
+    size_t getBytesRead() const { return position; }
+    size_t getSize() const { return text.size(); }
+};
+
+namespace Pgn {
+    // Return false to stop
+    using TokenVisitor = std::function<bool(PgnToken type, std::string_view text)>;
+    using MoveVisitor = std::function<bool(const BoardState& before, PackedMove move)>;
+
+    // Visits the tokens of a movetext in order, skipping move numbers.
+    // Unless variations is set, variations are skipped whole and nothing
+    // inside them is visited. Returns false if the visitor stopped.
+    bool tokenize(std::string_view movetext, bool variations, const TokenVisitor& visit);
+
+    // Replays the main line from the FEN tag (start position without one)
+    // through SAN parsing and make-move, calling onMove, if given, before
+    // each move. Returns false at a bad FEN or the first move that is not
+    // legal; state then holds the position before it.
+    bool replay(const PgnGame& game, BoardState& state, const MoveVisitor& onMove = nullptr);
+
+    // Command pgnread: games/s and MB/s over whole files
+    int run(const std::vector<std::string>& args);
+}
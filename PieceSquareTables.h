@@ -0,0 +1,155 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include "Constants.h"
+#include "Enums.h"
+
+// Middlegame/endgame piece-square tables for the tapered evaluation.
+// Tables are written from White's side with a8 first (same square order as
+// BoardState); Black uses the rank-mirrored square. The combined tables
+// include material and are signed, White positive, so BoardState can keep
+// running sums with one addition per piece change.
+namespace PieceSquareTables {
+    constexpr int MAX_PHASE = 24;
+
+    // Game phase contributed by each piece, indexed by PieceType
+    constexpr int PHASE_WEIGHT[6] = { 0, 4, 2, 1, 1, 0 };
+
+    constexpr int MATERIAL_MG[6] = {
+        0,
+        ChessConstants::QUEEN_VALUE,
+        ChessConstants::ROOK_VALUE,
+        ChessConstants::BISHOP_VALUE,
+        ChessConstants::KNIGHT_VALUE,
+        ChessConstants::PAWN_VALUE,
+    };
+    constexpr int MATERIAL_EG[6] = {
+        0,
+        ChessConstants::QUEEN_VALUE_EG,
+        ChessConstants::ROOK_VALUE_EG,
+        ChessConstants::BISHOP_VALUE_EG,
+        ChessConstants::KNIGHT_VALUE_EG,
+        ChessConstants::PAWN_VALUE_EG,
+    };
+
+    using Table = std::array<int, 64>;
+
+    constexpr Table KING_MG = {
+        -30,-40,-40,-50,-50,-40,-40,-30,
+        -30,-40,-40,-50,-50,-40,-40,-30,
+        -30,-40,-40,-50,-50,-40,-40,-30,
+        -30,-40,-40,-50,-50,-40,-40,-30,
+        -20,-30,-30,-40,-40,-30,-30,-20,
+        -10,-20,-20,-20,-20,-20,-20,-10,
+         20, 20,  0,  0,  0,  0, 20, 20,
+         20, 30, 10,  0,  0, 10, 30, 20,
+    };
+    constexpr Table KING_EG = {
+        -50,-40,-30,-20,-20,-30,-40,-50,
+        -30,-20,-10,  0,  0,-10,-20,-30,
+        -30,-10, 20, 30, 30, 20,-10,-30,
+        -30,-10, 30, 40, 40, 30,-10,-30,
+        -30,-10, 30, 40, 40, 30,-10,-30,
+        -30,-10, 20, 30, 30, 20,-10,-30,
+        -30,-30,  0,  0,  0,  0,-30,-30,
+        -50,-30,-30,-30,-30,-30,-30,-50,
+    };
+    constexpr Table QUEEN = {
+        -20,-10,-10, -5, -5,-10,-10,-20,
+        -10,  0,  0,  0,  0,  0,  0,-10,
+        -10,  0,  5,  5,  5,  5,  0,-10,
+         -5,  0,  5,  5,  5,  5,  0, -5,
+          0,  0,  5,  5,  5,  5,  0, -5,
+        -10,  5,  5,  5,  5,  5,  0,-10,
+        -10,  0,  5,  0,  0,  0,  0,-10,
+        -20,-10,-10, -5, -5,-10,-10,-20,
+    };
+    constexpr Table ROOK_MG = {
+          0,  0,  0,  0,  0,  0,  0,  0,
+          5, 10, 10, 10, 10, 10, 10,  5,
+         -5,  0,  0,  0,  0,  0,  0, -5,
+         -5,  0,  0,  0,  0,  0,  0, -5,
+         -5,  0,  0,  0,  0,  0,  0, -5,
+         -5,  0,  0,  0,  0,  0,  0, -5,
+         -5,  0,  0,  0,  0,  0,  0, -5,
+          0,  0,  0,  5,  5,  0,  0,  0,
+    };
+    constexpr Table ROOK_EG = {
+          5,  5,  5,  5,  5,  5,  5,  5,
+         10, 10, 10, 10, 10, 10, 10, 10,
+          0,  0,  0,  0,  0,  0,  0,  0,
+          0,  0,  0,  0,  0,  0,  0,  0,
+          0,  0,  0,  0,  0,  0,  0,  0,
+          0,  0,  0,  0,  0,  0,  0,  0,
+          0,  0,  0,  0,  0,  0,  0,  0,
+          0,  0,  0,  0,  0,  0,  0,  0,
+    };
+    constexpr Table BISHOP = {
+        -20,-10,-10,-10,-10,-10,-10,-20,
+        -10,  0,  0,  0,  0,  0,  0,-10,
+        -10,  0,  5, 10, 10,  5,  0,-10,
+        -10,  5,  5, 10, 10,  5,  5,-10,
+        -10,  0, 10, 10, 10, 10,  0,-10,
+        -10, 10, 10, 10, 10, 10, 10,-10,
+        -10,  5,  0,  0,  0,  0,  5,-10,
+        -20,-10,-10,-10,-10,-10,-10,-20,
+    };
+    constexpr Table KNIGHT = {
+        -50,-40,-30,-30,-30,-30,-40,-50,
+        -40,-20,  0,  0,  0,  0,-20,-40,
+        -30,  0, 10, 15, 15, 10,  0,-30,
+        -30,  5, 15, 20, 20, 15,  5,-30,
+        -30,  0, 15, 20, 20, 15,  0,-30,
+        -30,  5, 10, 15, 15, 10,  5,-30,
+        -40,-20,  0,  5,  5,  0,-20,-40,
+        -50,-40,-30,-30,-30,-30,-40,-50,
+    };
+    constexpr Table PAWN_MG = {
+          0,  0,  0,  0,  0,  0,  0,  0,
+         50, 50, 50, 50, 50, 50, 50, 50,
+         10, 10, 20, 30, 30, 20, 10, 10,
+          5,  5, 10, 25, 25, 10,  5,  5,
+          0,  0,  0, 20, 20,  0,  0,  0,
+          5, -5,-10,  0,  0,-10, -5,  5,
+          5, 10, 10,-20,-20, 10, 10,  5,
+          0,  0,  0,  0,  0,  0,  0,  0,
+    };
+    constexpr Table PAWN_EG = {
+          0,  0,  0,  0,  0,  0,  0,  0,
+         80, 80, 80, 80, 80, 80, 80, 80,
+         50, 50, 50, 50, 50, 50, 50, 50,
+         30, 30, 30, 30, 30, 30, 30, 30,
+         15, 15, 15, 15, 15, 15, 15, 15,
+          5,  5,  5,  5,  5,  5,  5,  5,
+          0,  0,  0,  0,  0,  0,  0,  0,
+          0,  0,  0,  0,  0,  0,  0,  0,
+    };
+
+    // Indexed by PieceType
+    constexpr const Table* MG_TABLES[6] = { &KING_MG, &QUEEN, &ROOK_MG, &BISHOP, &KNIGHT, &PAWN_MG };
+    constexpr const Table* EG_TABLES[6] = { &KING_EG, &QUEEN, &ROOK_EG, &BISHOP, &KNIGHT, &PAWN_EG };
+
+    struct Combined {
+        int16_t mg[12][64];
+        int16_t eg[12][64];
+    };
+
+    // Material plus table entry per BoardState piece code (color * 6 + type)
+    constexpr Combined makeCombined() {
+        Combined combined{};
+        for (int piece = 0; piece < 12; piece++) {
+            const int type = piece % 6;
+            const bool white = piece < 6;
+            for (int square = 0; square < 64; square++) {
+                const int index = white ? square : (square ^ 56);
+                const int mg = MATERIAL_MG[type] + (*MG_TABLES[type])[index];
+                const int eg = MATERIAL_EG[type] + (*EG_TABLES[type])[index];
+                combined.mg[piece][square] = static_cast<int16_t>(white ? mg : -mg);
+                combined.eg[piece][square] = static_cast<int16_t>(white ? eg : -eg);
+            }
+        }
+        return combined;
+    }
+
+    constexpr Combined COMBINED = makeCombined();
+}
@@ -0,0 +1,256 @@
+#include "PolyglotBook.h"
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include "Constants.h"
+#include "Zobrist.h"
+
+namespace {
+    constexpr int CASTLING_OFFSET = 768;
+    constexpr int EN_PASSANT_OFFSET = 772;
+    constexpr int TURN_OFFSET = 780;
+
+    // Published reference keys, used to recognise the real Random64 table
+    constexpr const char* START_FEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+    constexpr uint64_t START_KEY = 0x463B96181691FC9CULL;
+    constexpr const char* AFTER_E4_FEN = "rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 1";
+    constexpr uint64_t AFTER_E4_KEY = 0x823C9B50FD114196ULL;
+
+    constexpr Polyglot::Random64 generateFallback() {
+        Polyglot::Random64 table{};
+        uint64_t state = 0xB00C5EEDULL;
+        for (auto& value : table) value = Zobrist::detail::splitMix(state);
+        return table;
+    }
+
+    Polyglot::Random64 randomTable = generateFallback();
+    bool standardTable = false;
+
+    uint64_t readBigEndian(const uint8_t* data, int bytes) {
+        uint64_t value = 0;
+        for (int i = 0; i < bytes; i++) value = (value << 8) | data[i];
+        return value;
+    }
+
+    void writeBigEndian(uint64_t value, int bytes, uint8_t* data) {
+        for (int i = bytes - 1; i >= 0; i--) {
+            data[i] = static_cast<uint8_t>(value);
+            value >>= 8;
+        }
+    }
+
+    // Polyglot piece kinds run black pawn, white pawn, black knight, ... white king
+    int pieceKind(int piece) {
+        const int type = 5 - static_cast<int>(pieceCodeType(piece));   // PieceType runs king to pawn
+        return 2 * type + (pieceCodeColor(piece) == PieceColor::WHITE ? 1 : 0);
+    }
+
+    // Polyglot numbers squares from a1; this engine from a8
+    int bookSquare(int square) {
+        return square ^ 56;
+    }
+
+    uint16_t encodeSquares(int from, int to) {
+        return static_cast<uint16_t>(bookSquare(to) | (bookSquare(from) << 6));
+    }
+
+    // "0x9D39247E33776D41," tokens as in the format description, suffixes ignored
+    std::vector<uint64_t> parseHexValues(const std::string& text) {
+        std::vector<uint64_t> values;
+        for (size_t i = 0; i + 1 < text.size(); i++) {
+            if (text[i] != '0' || (text[i + 1] != 'x' && text[i + 1] != 'X')) continue;
+            size_t end = i + 2;
+            uint64_t value = 0;
+            while (end < text.size() && std::isxdigit(static_cast<unsigned char>(text[end]))) {
+                const char c = static_cast<char>(std::tolower(static_cast<unsigned char>(text[end])));
+                value = (value << 4) | static_cast<uint64_t>(c <= '9' ? c - '0' : c - 'a' + 10);
+                end++;
+            }
+            if (end > i + 2) values.push_back(value);
+            i = end - 1;
+        }
+        return values;
+    }
+}
+
+void Polyglot::loadRandom64(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) throw std::runtime_error("Could not open " + path);
+    const std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    std::vector<uint64_t> values;
+    if (contents.size() == RANDOM_COUNT * sizeof(uint64_t)) {
+        for (size_t i = 0; i < RANDOM_COUNT; i++) {
+            values.push_back(readBigEndian(reinterpret_cast<const uint8_t*>(contents.data()) + 8 * i, 8));
+        }
+    } else {
+        values = parseHexValues(contents);
+    }
+    if (values.size() != RANDOM_COUNT) {
+        throw std::runtime_error(path + ": expected " + std::to_string(RANDOM_COUNT) + " Random64 values, found " +
+                                 std::to_string(values.size()));
+    }
+
+    const Random64 previous = randomTable;
+    std::copy(values.begin(), values.end(), randomTable.begin());
+    BoardState start, afterE4;
+    start.setFromFEN(START_FEN);
+    afterE4.setFromFEN(AFTER_E4_FEN);
+    if (key(start) != START_KEY || key(afterE4) != AFTER_E4_KEY) {
+        randomTable = previous;
+        throw std::runtime_error(path + " does not hold the Polyglot Random64 table (reference keys differ)");
+    }
+    standardTable = true;
+}
+
+bool Polyglot::loadDefaultRandom64() {
+    std::error_code fileError;
+    if (!std::filesystem::exists(ChessConstants::POLYGLOT_RANDOM_FILE, fileError)) return false;
+    loadRandom64(ChessConstants::POLYGLOT_RANDOM_FILE);
+    return true;
+}
+
+bool Polyglot::checkStartKey() {
+    BoardState start;
+    start.setFromFEN(START_FEN);
+    return key(start) == START_KEY;
+}
+
+bool Polyglot::hasStandardRandom64() {
+    return standardTable;
+}
+
+uint64_t Polyglot::key(const BoardState& state) {
+    uint64_t key = 0;
+    Bitboard pieces = state.getOccupied();
+    while (pieces) {
+        const int square = Bitboards::popLsb(pieces);
+        key ^= randomTable[64 * pieceKind(state.getPieceAt(square)) + bookSquare(square)];
+    }
+
+    // Castling right bits are in Polyglot order already
+    for (int bit = 0; bit < 4; bit++) {
+        if (state.getCastlingRights() & (1 << bit)) key ^= randomTable[CASTLING_OFFSET + bit];
+    }
+
+    const int enPassant = state.getEnPassantSquare();
+    const PieceColor side = state.getSideToMove();
+    if (enPassant >= 0 &&
+        (Bitboards::pawnAttacks(oppositeColor(side), enPassant) & state.getPieces(side, PieceType::PAWN))) {
+        key ^= randomTable[EN_PASSANT_OFFSET + Bitboards::colOf(enPassant)];
+    }
+    if (side == PieceColor::WHITE) key ^= randomTable[TURN_OFFSET];
+    return key;
+}
+
+uint16_t Polyglot::encodeMove(PackedMove move) {
+    const int from = move.getFrom();
+    int to = move.getTo();
+    if (move.getFlags() == PackedMove::KING_CASTLE) to = from + 3;
+    if (move.getFlags() == PackedMove::QUEEN_CASTLE) to = from - 4;
+
+    uint16_t encoded = encodeSquares(from, to);
+    if (move.isPromotion()) encoded |= static_cast<uint16_t>(((move.getFlags() & 3) + 1) << 12);
+    return encoded;
+}
+
+PackedMove Polyglot::decodeMove(const BoardState& state, uint16_t move) {
+    BoardState position = state;
+    MoveList moves;
+    position.generateLegalMoves(moves);
+    for (PackedMove candidate : moves) {
+        // Some books write castling as the king's two-square step
+        if (encodeMove(candidate) == move ||
+            (candidate.isCastling() && encodeSquares(candidate.getFrom(), candidate.getTo()) == move)) {
+            return candidate;
+        }
+    }
+    return PackedMove::none();
+}
+
+Polyglot::Entry Polyglot::readEntry(const uint8_t* data) {
+    return Entry{
+        readBigEndian(data, 8),
+        static_cast<uint16_t>(readBigEndian(data + 8, 2)),
+        static_cast<uint16_t>(readBigEndian(data + 10, 2)),
+        static_cast<uint32_t>(readBigEndian(data + 12, 4)),
+    };
+}
+
+void Polyglot::writeEntry(const Entry& entry, uint8_t* data) {
+    writeBigEndian(entry.key, 8, data);
+    writeBigEndian(entry.move, 2, data + 8);
+    writeBigEndian(entry.weight, 2, data + 10);
+    writeBigEndian(entry.learn, 4, data + 12);
+}
+
+PolyglotBook::PolyglotBook() : entryCount(0) {
+}
+
+PolyglotBook::PolyglotBook(const std::string& path) : PolyglotBook() {
+    open(path);
+}
+
+void PolyglotBook::open(const std::string& path) {
+    file.open(path);
+    if (file.size() % Polyglot::ENTRY_SIZE != 0) {
+        file.close();
+        throw std::runtime_error("Not a Polyglot book (size is not a multiple of 16 bytes): " + path);
+    }
+    entryCount = file.size() / Polyglot::ENTRY_SIZE;
+    file.adviseRandomAccess();
+}
+
+// First entry whose key is not less than key
+size_t PolyglotBook::lowerBound(uint64_t key) const {
+    size_t low = 0;
+    size_t high = entryCount;
+    while (low < high) {
+        const size_t middle = low + (high - low) / 2;
+        if (readBigEndian(file.data() + middle * Polyglot::ENTRY_SIZE, 8) < key) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+std::vector<BookMove> PolyglotBook::probe(const BoardState& state) const {
+    std::vector<BookMove> moves;
+    if (!isOpen()) return moves;
+
+    const uint64_t key = Polyglot::key(state);
+    for (size_t index = lowerBound(key); index < entryCount; index++) {
+        const Polyglot::Entry entry = Polyglot::readEntry(file.data() + index * Polyglot::ENTRY_SIZE);
+        if (entry.key != key) break;
+        const PackedMove move = Polyglot::decodeMove(state, entry.move);
+        if (!move.isNone()) moves.push_back(BookMove{ move, entry.weight });
+    }
+    std::stable_sort(moves.begin(), moves.end(), [](const BookMove& a, const BookMove& b) {
+        return a.weight > b.weight;
+    });
+    return moves;
+}
+
+PackedMove PolyglotBook::bestMove(const BoardState& state) const {
+    const std::vector<BookMove> moves = probe(state);
+    return moves.empty() ? PackedMove::none() : moves.front().move;
+}
+
+PackedMove PolyglotBook::weightedMove(const BoardState& state, uint64_t random) const {
+    const std::vector<BookMove> moves = probe(state);
+    uint64_t total = 0;
+    for (const BookMove& move : moves) total += move.weight;
+    if (total == 0) return moves.empty() ? PackedMove::none() : moves.front().move;
+
+    uint64_t pick = random % total;
+    for (const BookMove& move : moves) {
+        if (pick < move.weight) return move.move;
+        pick -= move.weight;
+    }
+    return moves.front().move;
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "BoardState.h"
+#include "MappedFile.h"
+#include "PackedMove.h"
+
+// Polyglot opening book format. A book is a file of 16-byte big-endian
+// entries { uint64 key, uint16 move, uint16 weight, uint32 learn } sorted by
+// key. Keys XOR 781 Random64 values: 768 piece-square, 4 castling rights,
+// 8 en passant files (only when a capture is possible) and the side to move.
+//
+// The standard Random64 table published with Polyglot is read from
+// polyglot-random64.txt next to the executable by loadDefaultRandom64(), which
+// the game, book and bookbuild all call first; loadRandom64() installs one from
+// any other path. Without it a fixed-seed table is used, which reads books
+// written by this program (bookbuild) but matches no third-party book.
+namespace Polyglot {
+    constexpr size_t RANDOM_COUNT = 781;
+    constexpr size_t ENTRY_SIZE = 16;
+    using Random64 = std::array<uint64_t, RANDOM_COUNT>;
+
+    struct Entry {
+        uint64_t key;
+        uint16_t move;
+        uint16_t weight;
+        uint32_t learn;
+    };
+
+    // Reads the table from text (781 hex values, e.g. the C array from the
+    // format description) or binary (781 big-endian values). Throws
+    // std::runtime_error; call before books are probed from other threads.
+    void loadRandom64(const std::string& path);
+    // Loads ChessConstants::POLYGLOT_RANDOM_FILE if it exists; false if absent
+    bool loadDefaultRandom64();
+    bool hasStandardRandom64();
+    // Whether the start position hashes to the published key 0x463B96181691FC9C
+    bool checkStartKey();
+
+    uint64_t key(const BoardState& state);
+
+    // Book move encoding: to file/rank, from file/rank, promotion piece;
+    // castling is written as the king taking its own rook
+    uint16_t encodeMove(PackedMove move);
+    // Legal move matching a book move, PackedMove::none() if there is none
+    PackedMove decodeMove(const BoardState& state, uint16_t move);
+
+    Entry readEntry(const uint8_t* data);
+    void writeEntry(const Entry& entry, uint8_t* data);
+}
+
+struct BookMove {
+    PackedMove move;
+    uint16_t weight;
+};
+
+// Read-only book, memory-mapped and binary-searched in place: opening costs
+// the same for any book size and a probe touches O(log n) pages.
+class PolyglotBook {
+private:
+    MappedFile file;
+    size_t entryCount;
+
+    size_t lowerBound(uint64_t key) const;
+
+public:
+    PolyglotBook();
+    // Throws std::runtime_error if the file cannot be mapped or is not a book
+    explicit PolyglotBook(const std::string& path);
+
+    void open(const std::string& path);
+    bool isOpen() const { return file.isOpen(); }
+    size_t getEntryCount() const { return entryCount; }
+
+    // Legal book moves of the position, heaviest first
+    std::vector<BookMove> probe(const BoardState& state) const;
+    // Heaviest move, PackedMove::none() when out of book
+    PackedMove bestMove(const BoardState& state) const;
+    // Move picked with probability proportional to its weight; random is any 64-bit value
+    PackedMove weightedMove(const BoardState& state, uint64_t random) const;
+};
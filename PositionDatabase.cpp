@@ -0,0 +1,548 @@
+#include "PositionDatabase.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+#include "ExternalSort.h"
+#include "PgnReader.h"
+#include "San.h"
+#include "WorkStealingPool.h"
+
+namespace {
+    constexpr size_t HEADER_SIZE = 56;
+    constexpr size_t BLOCK_INDEX_ENTRY_SIZE = 24;
+    constexpr size_t GAME_ENTRY_SIZE = 12;
+    constexpr size_t BATCH_GAMES = 1024;            // games handed to one task
+    constexpr size_t MERGE_WIDTH = 64;              // runs merged at once
+
+    struct Entry {
+        uint64_t key;
+        uint32_t game;
+        uint16_t ply;
+        uint16_t move;       // PackedMove played from the position, none at the end of a game
+    };
+
+    bool entryLess(const Entry& a, const Entry& b) {
+        if (a.key != b.key) return a.key < b.key;
+        return a.game != b.game ? a.game < b.game : a.ply < b.ply;
+    }
+
+    uint32_t read32(const uint8_t* data) {
+        return static_cast<uint32_t>(data[0]) | (static_cast<uint32_t>(data[1]) << 8) |
+               (static_cast<uint32_t>(data[2]) << 16) | (static_cast<uint32_t>(data[3]) << 24);
+    }
+
+    uint64_t read64(const uint8_t* data) {
+        return static_cast<uint64_t>(read32(data)) | (static_cast<uint64_t>(read32(data + 4)) << 32);
+    }
+
+    void write64(uint64_t value, std::vector<uint8_t>& out) {
+        for (int i = 0; i < 8; i++) out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+
+    void write32(uint32_t value, std::vector<uint8_t>& out) {
+        for (int i = 0; i < 4; i++) out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+
+    void writeVarint(uint64_t value, std::vector<uint8_t>& out) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    // False if the varint runs past end
+    bool readVarint(const uint8_t*& cursor, const uint8_t* end, uint64_t& value) {
+        value = 0;
+        for (int shift = 0; shift < 64 && cursor != end; shift += 7) {
+            const uint8_t byte = *cursor++;
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) return true;
+        }
+        return false;
+    }
+
+    GameResult parseResult(std::string_view result) {
+        if (result == "1-0") return GameResult::WHITE_WINS;
+        if (result == "0-1") return GameResult::BLACK_WINS;
+        if (result == "1/2-1/2") return GameResult::DRAW;
+        return GameResult::UNKNOWN;
+    }
+
+    // Streams sorted entries into compressed blocks. Within a block each
+    // entry is: varint key delta, varint game (a delta from the previous
+    // game when the key repeats), varint ply, uint16 move.
+    class BlockWriter {
+    private:
+        std::ofstream& out;
+        std::vector<uint8_t> block;
+        std::vector<uint8_t> index;
+        uint64_t offset;
+        uint64_t firstKey = 0;
+        uint32_t blockEntries = 0;
+        Entry previous{};
+        uint64_t entries = 0;
+        uint64_t blocks = 0;
+
+        void finishBlock() {
+            if (blockEntries == 0) return;
+            write64(firstKey, index);
+            write64(offset, index);
+            write32(blockEntries, index);
+            write32(static_cast<uint32_t>(block.size()), index);
+            out.write(reinterpret_cast<const char*>(block.data()), static_cast<std::streamsize>(block.size()));
+            offset += block.size();
+            block.clear();
+            blockEntries = 0;
+            blocks++;
+        }
+
+    public:
+        BlockWriter(std::ofstream& stream, uint64_t start) : out(stream), offset(start) {}
+
+        void add(const Entry& entry) {
+            if (blockEntries == PositionDatabase::BLOCK_ENTRIES) finishBlock();
+            if (blockEntries == 0) {
+                firstKey = entry.key;
+                previous = Entry{ entry.key, 0, 0, 0 };
+            }
+            const uint64_t keyDelta = entry.key - previous.key;
+            writeVarint(keyDelta, block);
+            writeVarint(keyDelta == 0 ? entry.game - previous.game : entry.game, block);
+            writeVarint(entry.ply, block);
+            block.push_back(static_cast<uint8_t>(entry.move));
+            block.push_back(static_cast<uint8_t>(entry.move >> 8));
+            previous = entry;
+            blockEntries++;
+            entries++;
+        }
+
+        void finish() { finishBlock(); }
+
+        const std::vector<uint8_t>& getIndex() const { return index; }
+        uint64_t getOffset() const { return offset; }
+        uint64_t getEntries() const { return entries; }
+        uint64_t getBlocks() const { return blocks; }
+    };
+
+    struct Batch {
+        std::vector<PgnGame> games;
+        uint32_t firstGame = 0;
+    };
+
+    struct WorkerState {
+        std::vector<Entry> entries;
+        uint64_t unreadable = 0;
+    };
+
+    void processBatch(const Batch& batch, int plies, size_t capacity, WorkerState& state, ExternalSort::RunFiles& runs) {
+        BoardState board;
+        for (size_t i = 0; i < batch.games.size(); i++) {
+            const uint32_t game = batch.firstGame + static_cast<uint32_t>(i);
+            int ply = 0;
+            bool limited = false;
+            const bool legal = Pgn::replay(batch.games[i], board, [&](const BoardState& before, PackedMove move) {
+                if (plies > 0 && ply >= plies) {
+                    limited = true;
+                    return false;
+                }
+                state.entries.push_back(Entry{ before.getKey(), game, static_cast<uint16_t>(ply), move.getRaw() });
+                return ++ply < 0xFFFF;
+            });
+            if (!legal) state.unreadable++;
+            // Final position, or the last one before an unreadable move
+            if (!limited && (legal || ply > 0)) {
+                state.entries.push_back(Entry{ board.getKey(), game, static_cast<uint16_t>(ply), PackedMove::none().getRaw() });
+            }
+
+            if (state.entries.size() >= capacity) {
+                std::sort(state.entries.begin(), state.entries.end(), entryLess);
+                ExternalSort::writeRun(state.entries, runs.create());
+                state.entries.clear();
+            }
+        }
+    }
+
+    double percent(uint64_t part, uint64_t whole) {
+        return whole == 0 ? 0.0 : 100.0 * static_cast<double>(part) / static_cast<double>(whole);
+    }
+}
+
+PositionDatabase::PositionDatabase()
+    : entryCount(0), gameCount(0), blockCount(0), blockIndex(nullptr), gameTable(nullptr) {
+}
+
+PositionDatabase::PositionDatabase(const std::string& path) : PositionDatabase() {
+    open(path);
+}
+
+void PositionDatabase::open(const std::string& path) {
+    file.open(path);
+    const uint8_t* data = file.data();
+    const uint64_t size = file.size();
+    if (size < HEADER_SIZE || std::memcmp(data, "SCHP", 4) != 0 || data[4] != VERSION) {
+        file.close();
+        throw std::runtime_error(path + " is not a position database");
+    }
+    entryCount = read64(data + 8);
+    gameCount = read64(data + 16);
+    blockCount = read64(data + 24);
+    const uint64_t blockIndexOffset = read64(data + 32);
+    const uint64_t gameTableOffset = read64(data + 40);
+    const uint64_t inputTableOffset = read64(data + 48);
+    const bool valid = blockIndexOffset <= size && blockCount <= (size - blockIndexOffset) / BLOCK_INDEX_ENTRY_SIZE &&
+                       gameTableOffset <= size && gameCount <= (size - gameTableOffset) / GAME_ENTRY_SIZE &&
+                       inputTableOffset <= size - 4;
+    if (!valid) {
+        file.close();
+        throw std::runtime_error(path + " is truncated");
+    }
+    blockIndex = data + blockIndexOffset;
+    gameTable = data + gameTableOffset;
+
+    inputs.clear();
+    const uint8_t* cursor = data + inputTableOffset + 4;
+    const uint8_t* end = data + size;
+    for (uint32_t i = read32(data + inputTableOffset); i > 0; i--) {
+        const size_t length = end - cursor >= 2 ? static_cast<size_t>(cursor[0] | (cursor[1] << 8)) : SIZE_MAX;
+        if (length > static_cast<size_t>(end - cursor) - 2) {
+            file.close();
+            throw std::runtime_error(path + " is truncated");
+        }
+        inputs.emplace_back(reinterpret_cast<const char*>(cursor + 2), length);
+        cursor += 2 + length;
+    }
+    file.adviseRandomAccess();
+}
+
+PositionStats PositionDatabase::lookup(BoardState& state, size_t maxMatches) const {
+    PositionStats stats;
+    if (!isOpen()) return stats;
+    const uint64_t key = state.getKey();
+    MoveList legal;
+    state.generateLegalMoves(legal);
+
+    // The key's entries start in the last block whose first key is below it,
+    // or in the first block starting with it, and may run over several blocks
+    uint64_t low = 0, high = blockCount;
+    while (low < high) {
+        const uint64_t middle = (low + high) / 2;
+        if (read64(blockIndex + middle * BLOCK_INDEX_ENTRY_SIZE) < key) low = middle + 1;
+        else high = middle;
+    }
+    uint32_t lastGame = UINT32_MAX;
+    for (uint64_t block = low > 0 ? low - 1 : 0; block < blockCount; block++) {
+        const uint8_t* entry = blockIndex + block * BLOCK_INDEX_ENTRY_SIZE;
+        uint64_t currentKey = read64(entry);
+        if (currentKey > key) break;
+        const uint64_t offset = read64(entry + 8);
+        const uint32_t count = read32(entry + 16);
+        const uint32_t bytes = read32(entry + 20);
+        if (offset > file.size() || bytes > file.size() - offset) throw std::runtime_error("Position database block out of range");
+
+        const uint8_t* cursor = file.data() + offset;
+        const uint8_t* end = cursor + bytes;
+        uint64_t game = 0;
+        for (uint32_t i = 0; i < count; i++) {
+            uint64_t keyDelta, gameValue, ply;
+            if (!readVarint(cursor, end, keyDelta) || !readVarint(cursor, end, gameValue) ||
+                !readVarint(cursor, end, ply) || end - cursor < 2) {
+                throw std::runtime_error("Corrupt position database block");
+            }
+            currentKey += keyDelta;
+            game = keyDelta == 0 ? game + gameValue : gameValue;
+            const PackedMove move = PackedMove::fromRaw(static_cast<uint16_t>(cursor[0] | (cursor[1] << 8)));
+            cursor += 2;
+            if (currentKey < key) continue;
+            if (currentKey > key) break;
+            // A next move that is not legal here means another position with the same key
+            if (!move.isNone() && std::find(legal.begin(), legal.end(), move) == legal.end()) continue;
+
+            const GameResult result = game < gameCount ? static_cast<GameResult>(gameTable[game * GAME_ENTRY_SIZE + 10]) : GameResult::UNKNOWN;
+            stats.occurrences++;
+            if (static_cast<uint32_t>(game) != lastGame) {
+                lastGame = static_cast<uint32_t>(game);
+                stats.games++;
+                if (result == GameResult::WHITE_WINS) stats.whiteWins++;
+                else if (result == GameResult::DRAW) stats.draws++;
+                else if (result == GameResult::BLACK_WINS) stats.blackWins++;
+                if (stats.matches.size() < maxMatches) stats.matches.push_back(PositionMatch{ lastGame, static_cast<uint16_t>(ply) });
+            }
+            if (move.isNone()) continue;
+            auto next = std::find_if(stats.nextMoves.begin(), stats.nextMoves.end(), [&](const NextMoveStats& s) { return s.move == move; });
+            if (next == stats.nextMoves.end()) {
+                stats.nextMoves.push_back(NextMoveStats{ move });
+                next = stats.nextMoves.end() - 1;
+            }
+            next->count++;
+            if (result == GameResult::WHITE_WINS) next->whiteWins++;
+            else if (result == GameResult::DRAW) next->draws++;
+            else if (result == GameResult::BLACK_WINS) next->blackWins++;
+        }
+    }
+    std::stable_sort(stats.nextMoves.begin(), stats.nextMoves.end(), [](const NextMoveStats& a, const NextMoveStats& b) {
+        return a.count > b.count;
+    });
+    return stats;
+}
+
+IndexedGame PositionDatabase::getGame(uint32_t game) const {
+    IndexedGame indexed;
+    if (game >= gameCount) return indexed;
+    const uint8_t* entry = gameTable + static_cast<size_t>(game) * GAME_ENTRY_SIZE;
+    indexed.offset = read64(entry);
+    const uint16_t input = static_cast<uint16_t>(entry[8] | (entry[9] << 8));
+    if (input < inputs.size()) indexed.input = inputs[input];
+    indexed.result = static_cast<GameResult>(entry[10]);
+    return indexed;
+}
+
+PositionDatabase::BuildReport PositionDatabase::build(const BuildOptions& options) {
+    const auto start = std::chrono::steady_clock::now();
+    if (options.inputs.size() > 0xFFFF) throw std::runtime_error("Too many input files");
+    const int threads = std::max(1, options.threads);
+    const size_t budget = std::max<size_t>(options.memoryMegabytes, 16) * 1024 * 1024;
+    const size_t capacity = std::max<size_t>(budget * 3 / 4 / sizeof(Entry) / static_cast<size_t>(threads), 4096);
+
+    BuildReport report;
+    ExternalSort::RunFiles runs(options.outputPath);
+    std::vector<WorkerState> states(static_cast<size_t>(threads));
+    std::vector<uint8_t> gameTable;
+    // Games are views into the mapped inputs, so every reader lives until the end
+    std::vector<std::unique_ptr<PgnReader>> readers;
+
+    std::mutex flightMutex;
+    std::condition_variable batchDone;
+    size_t inFlight = 0;
+    std::exception_ptr failure;
+    {
+        WorkStealingPool pool(threads);
+        auto submit = [&](std::shared_ptr<Batch> batch) {
+            std::unique_lock<std::mutex> lock(flightMutex);
+            batchDone.wait(lock, [&] { return inFlight < 2 * static_cast<size_t>(threads); });
+            inFlight++;
+            lock.unlock();
+            pool.submit([&, batch](int worker) {
+                try {
+                    processBatch(*batch, options.plies, capacity, states[worker], runs);
+                }
+                catch (...) {
+                    std::lock_guard<std::mutex> guard(flightMutex);
+                    if (!failure) failure = std::current_exception();
+                }
+                std::lock_guard<std::mutex> guard(flightMutex);
+                inFlight--;
+                batchDone.notify_one();
+            });
+        };
+
+        auto batch = std::make_shared<Batch>();
+        for (size_t input = 0; input < options.inputs.size(); input++) {
+            readers.push_back(std::make_unique<PgnReader>(options.inputs[input]));
+            PgnGame game;
+            while (readers.back()->next(game)) {
+                if (report.games == UINT32_MAX) throw std::runtime_error("Too many games");
+                write64(game.offset, gameTable);
+                gameTable.push_back(static_cast<uint8_t>(input));
+                gameTable.push_back(static_cast<uint8_t>(input >> 8));
+                gameTable.push_back(static_cast<uint8_t>(parseResult(game.getTag("Result"))));
+                gameTable.push_back(0);
+                if (batch->games.empty()) batch->firstGame = static_cast<uint32_t>(report.games);
+                batch->games.push_back(game);
+                report.games++;
+                if (batch->games.size() == BATCH_GAMES) {
+                    submit(batch);
+                    batch = std::make_shared<Batch>();
+                }
+            }
+        }
+        if (!batch->games.empty()) submit(batch);
+        pool.wait();
+    }
+    if (failure) std::rethrow_exception(failure);
+    for (const auto& state : states) report.unreadableGames += state.unreadable;
+
+    const std::string temporaryPath = options.outputPath + ".tmp";
+    std::ofstream out(temporaryPath, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) throw std::runtime_error("Could not write " + temporaryPath);
+    const std::vector<uint8_t> placeholder(HEADER_SIZE, 0);
+    out.write(reinterpret_cast<const char*>(placeholder.data()), HEADER_SIZE);
+    BlockWriter writer(out, HEADER_SIZE);
+    if (runs.getCreated() == 0) {
+        std::vector<Entry> all = std::move(states[0].entries);
+        for (auto& state : states) {
+            all.insert(all.end(), state.entries.begin(), state.entries.end());
+            std::vector<Entry>().swap(state.entries);
+        }
+        std::sort(all.begin(), all.end(), entryLess);
+        for (const Entry& entry : all) writer.add(entry);
+    } else {
+        for (auto& state : states) {
+            if (!state.entries.empty()) {
+                std::sort(state.entries.begin(), state.entries.end(), entryLess);
+                ExternalSort::writeRun(state.entries, runs.create());
+            }
+            std::vector<Entry>().swap(state.entries);
+        }
+        std::vector<std::string> pending = runs.getPaths();
+        report.runs = pending.size();
+        const size_t bufferRecords = std::max<size_t>(budget / (MERGE_WIDTH + 1) / sizeof(Entry), 1024);
+        const auto never = [](Entry&, const Entry&) { return false; };
+        pending = ExternalSort::reduceRuns<Entry>(runs, pending, MERGE_WIDTH, bufferRecords, entryLess, never);
+        ExternalSort::mergeRuns<Entry>(pending, bufferRecords, entryLess, [&](const Entry& entry) { writer.add(entry); });
+    }
+    writer.finish();
+
+    std::vector<uint8_t> tail = writer.getIndex();
+    const uint64_t blockIndexOffset = writer.getOffset();
+    const uint64_t gameTableOffset = blockIndexOffset + tail.size();
+    tail.insert(tail.end(), gameTable.begin(), gameTable.end());
+    const uint64_t inputTableOffset = blockIndexOffset + tail.size();
+    write32(static_cast<uint32_t>(options.inputs.size()), tail);
+    for (const std::string& input : options.inputs) {
+        const size_t length = std::min<size_t>(input.size(), 0xFFFF);
+        tail.push_back(static_cast<uint8_t>(length));
+        tail.push_back(static_cast<uint8_t>(length >> 8));
+        tail.insert(tail.end(), input.begin(), input.begin() + static_cast<std::ptrdiff_t>(length));
+    }
+    out.write(reinterpret_cast<const char*>(tail.data()), static_cast<std::streamsize>(tail.size()));
+
+    std::vector<uint8_t> header = { 'S', 'C', 'H', 'P', VERSION, 0, 0, 0 };
+    write64(writer.getEntries(), header);
+    write64(report.games, header);
+    write64(writer.getBlocks(), header);
+    write64(blockIndexOffset, header);
+    write64(gameTableOffset, header);
+    write64(inputTableOffset, header);
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(header.data()), static_cast<std::streamsize>(header.size()));
+    out.close();
+    if (!out) throw std::runtime_error("Could not write " + temporaryPath);
+    std::filesystem::rename(temporaryPath, options.outputPath);
+
+    report.entries = writer.getEntries();
+    report.blocks = writer.getBlocks();
+    report.bytes = blockIndexOffset + tail.size();
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return report;
+}
+
+int PositionDb::run(const std::vector<std::string>& args) {
+    const std::string command = args.empty() ? "" : args[0];
+    if (command == "build") {
+        PositionDatabase::BuildOptions options;
+        options.threads = WorkStealingPool::defaultThreadCount();
+        bool valid = true;
+        for (size_t i = 1; i < args.size(); i++) {
+            if (args[i] == "--out" && i + 1 < args.size()) options.outputPath = args[++i];
+            else if (args[i] == "--plies" && i + 1 < args.size()) options.plies = std::stoi(args[++i]);
+            else if (args[i] == "--threads" && i + 1 < args.size()) options.threads = std::max(1, std::stoi(args[++i]));
+            else if (args[i] == "--memory" && i + 1 < args.size()) options.memoryMegabytes = std::stoull(args[++i]);
+            else if (args[i].rfind("--", 0) != 0) options.inputs.push_back(args[i]);
+            else valid = false;
+        }
+        if (valid && !options.inputs.empty()) {
+            const PositionDatabase::BuildReport report = PositionDatabase::build(options);
+            const double seconds = report.seconds > 0.0 ? report.seconds : 1e-9;
+            std::cout << "Indexed " << report.games << " games (" << report.unreadableGames << " stopped at an unreadable move) with "
+                      << options.threads << " threads in " << report.seconds << " s: "
+                      << static_cast<uint64_t>(static_cast<double>(report.games) / seconds) << " games/s\n"
+                      << "  " << report.entries << " positions in " << report.blocks << " blocks, " << report.runs
+                      << " runs spilled to disk\n"
+                      << "Wrote " << report.bytes << " bytes to " << options.outputPath << " ("
+                      << static_cast<double>(report.bytes) / static_cast<double>(std::max<uint64_t>(report.entries, 1))
+                      << " bytes per position)\n";
+            return 0;
+        }
+    }
+    if (command == "query" && args.size() >= 2) {
+        std::string fen;
+        std::string moves;
+        size_t listed = 10;
+        bool valid = true;
+        for (size_t i = 2; i < args.size(); i++) {
+            if (args[i] == "--moves" && i + 1 < args.size()) moves = args[++i];
+            else if (args[i] == "--games" && i + 1 < args.size()) listed = std::stoul(args[++i]);
+            else if (args[i].rfind("--", 0) != 0 && fen.empty()) fen = args[i];
+            else valid = false;
+        }
+        BoardState state;
+        if (fen.empty()) state.setStartPosition();
+        else if (!state.setFromFEN(fen)) {
+            std::cerr << "Invalid FEN: " << fen << "\n";
+            return 1;
+        }
+        std::istringstream sequence(moves);
+        std::string san;
+        while (valid && sequence >> san) {
+            const PackedMove move = San::parse(state, san);
+            if (move.isNone()) {
+                std::cerr << "Not a legal move here: " << san << "\n";
+                return 1;
+            }
+            UndoInfo undo;
+            state.makeMove(move, undo);
+        }
+        if (valid) {
+            const PositionDatabase database(args[1]);
+            const auto start = std::chrono::steady_clock::now();
+            const PositionStats stats = database.lookup(state, listed);
+            const double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+            std::cout << state.toFEN() << "\n";
+            std::cout << stats.games << " of " << database.getGameCount() << " games (" << stats.occurrences << " occurrences): "
+                      << std::fixed << std::setprecision(1) << "White " << percent(stats.whiteWins, stats.games) << "%, draw "
+                      << percent(stats.draws, stats.games) << "%, Black " << percent(stats.blackWins, stats.games) << "%\n";
+            for (const NextMoveStats& next : stats.nextMoves) {
+                std::cout << "  " << std::left << std::setw(8) << San::toString(state, next.move) << std::right << std::setw(9)
+                          << next.count << std::setw(7) << percent(next.count, stats.occurrences) << "%   +"
+                          << next.whiteWins << " =" << next.draws << " -" << next.blackWins << "\n";
+            }
+            // Players are read from the PGN itself when it is still where it was indexed
+            std::unordered_map<std::string, std::unique_ptr<MappedFile>> sources;
+            for (const PositionMatch& match : stats.matches) {
+                const IndexedGame game = database.getGame(match.game);
+                std::cout << "  game " << match.game << ", ply " << match.ply << ": ";
+                auto source = sources.find(game.input);
+                if (source == sources.end()) {
+                    auto mapped = std::make_unique<MappedFile>();
+                    try {
+                        mapped->open(game.input);
+                    }
+                    catch (const std::exception&) {
+                        mapped.reset();
+                    }
+                    source = sources.emplace(game.input, std::move(mapped)).first;
+                }
+                PgnGame pgn;
+                if (source->second && game.offset < source->second->size()) {
+                    const char* text = reinterpret_cast<const char*>(source->second->data());
+                    PgnReader reader(std::string_view(text + game.offset, source->second->size() - game.offset));
+                    if (reader.next(pgn)) {
+                        const std::string_view white = pgn.getTag("White"), black = pgn.getTag("Black");
+                        std::cout << (white.empty() ? "?" : white) << " - " << (black.empty() ? "?" : black) << " "
+                                  << game.input << " @" << game.offset << "\n";
+                        continue;
+                    }
+                }
+                std::cout << game.input << " @" << game.offset << "\n";
+            }
+            std::cout << std::defaultfloat << "Lookup: " << milliseconds << " ms\n";
+            return 0;
+        }
+    }
+    std::cerr << "Usage: posdb build <games.pgn>... [--out <positions.db>] [--plies N] [--threads N] [--memory MB]\n"
+              << "       posdb query <positions.db> [fen] [--moves \"e4 e5 Nf3\"] [--games N]\n";
+    return 1;
+}
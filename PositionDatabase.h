@@ -0,0 +1,107 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "BoardState.h"
+#include "GameCodec.h"
+#include "MappedFile.h"
+#include "PackedMove.h"
+
+struct PositionMatch {
+    uint32_t game;
+    uint16_t ply;               // half-moves played before the position
+};
+
+// Occurrences of the looked-up position followed by one move, and how those games ended
+struct NextMoveStats {
+    PackedMove move;
+    uint64_t count = 0;
+    uint64_t whiteWins = 0, draws = 0, blackWins = 0;
+};
+
+struct PositionStats {
+    uint64_t occurrences = 0;   // a game repeating the position counts each time
+    uint64_t games = 0;
+    uint64_t whiteWins = 0, draws = 0, blackWins = 0;
+    std::vector<NextMoveStats> nextMoves;   // most played first
+    std::vector<PositionMatch> matches;     // first occurrence per game, lowest game ids
+};
+
+struct IndexedGame {
+    std::string input;          // PGN file the game came from
+    uint64_t offset = 0;        // of the game's first byte in it
+    GameResult result = GameResult::UNKNOWN;
+};
+
+// Database of every position reached in a set of PGN games. Entries
+// (Zobrist key, game id, ply, next move) are sorted by key and stored in
+// blocks of up to 4096; a block delta-encodes keys and game ids as
+// varints, so repeated opening positions cost a byte or two. A sparse
+// index of each block's first key finds the blocks of a position by binary
+// search, and a lookup decodes only those.
+//
+// File layout, little-endian:
+//   "SCHP", version, 3 zero bytes
+//   uint64 entries, games, blocks, block index offset, game table offset, input table offset
+//   blocks
+//   block index: { uint64 first key, uint64 offset, uint32 entries, uint32 bytes } per block
+//   game table: { uint64 PGN offset, uint16 input, uint8 result, uint8 0 } per game
+//   input table: uint32 count, then uint16 length + path per input
+class PositionDatabase {
+private:
+    MappedFile file;
+    uint64_t entryCount;
+    uint64_t gameCount;
+    uint64_t blockCount;
+    const uint8_t* blockIndex;
+    const uint8_t* gameTable;
+    std::vector<std::string> inputs;
+
+public:
+    static constexpr uint8_t VERSION = 1;
+    static constexpr size_t BLOCK_ENTRIES = 4096;
+
+    struct BuildOptions {
+        std::vector<std::string> inputs;
+        std::string outputPath = "positions.db";
+        int plies = 0;                      // positions per game, 0 for all
+        int threads = 1;
+        size_t memoryMegabytes = 256;
+    };
+
+    struct BuildReport {
+        uint64_t games = 0;
+        uint64_t unreadableGames = 0;       // stopped at a bad FEN or move; earlier positions are kept
+        uint64_t entries = 0;
+        uint64_t blocks = 0;
+        uint64_t bytes = 0;
+        size_t runs = 0;
+        double seconds = 0.0;
+    };
+
+    PositionDatabase();
+    // Throws std::runtime_error if the file cannot be mapped or is not a database
+    explicit PositionDatabase(const std::string& path);
+
+    void open(const std::string& path);
+    bool isOpen() const { return file.isOpen(); }
+
+    // Games reaching the position, with results and the moves played from
+    // it; at most maxMatches matches are listed
+    PositionStats lookup(BoardState& state, size_t maxMatches) const;
+    IndexedGame getGame(uint32_t game) const;
+
+    uint64_t getEntryCount() const { return entryCount; }
+    uint64_t getGameCount() const { return gameCount; }
+    uint64_t getBlockCount() const { return blockCount; }
+
+    // Replays the games on all threads; entries are sorted in memory runs
+    // spilled to disk and merged, as in BookBuilder. Throws std::runtime_error.
+    static BuildReport build(const BuildOptions& options);
+};
+
+namespace PositionDb {
+    // Command posdb: build a database or look up a position
+    int run(const std::vector<std::string>& args);
+}
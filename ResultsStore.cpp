@@ -0,0 +1,647 @@
+#include "ResultsStore.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include "Checksum.h"
+#include "Constants.h"
+
+namespace {
+    constexpr uint8_t VERSION = 1;
+    constexpr size_t FILE_HEADER_SIZE = 8;
+    constexpr size_t RECORD_SIZE = 28;
+    constexpr size_t INDEX_HEADER_SIZE = 32;
+    constexpr size_t INDEX_PLAYER_SIZE = 48;
+    constexpr size_t MAX_NAME = 255;
+    // Queries rebuild the index once the records it does not cover reach
+    // this, which bounds the unindexed tail every query scans
+    constexpr uint64_t REBUILD_TAIL = 65536;
+
+    constexpr const char* TERMINATION_NAMES[] = {
+        "Other",
+        "Checkmate",
+        "Timeout",
+        "Stalemate",
+        "Draw - Insufficient Material",
+        "Draw - Fifty Move Rule",
+        "Draw - Threefold Repetition",
+        "Adjudication - KPK Win",
+        "Draw - KPK Adjudication",
+    };
+
+    // One record as stored, with player ids
+    struct RawRecord {
+        uint64_t time;
+        uint32_t white;
+        uint32_t black;
+        uint32_t seconds;
+        GameResult result;
+        Termination termination;
+    };
+
+    uint32_t read32(const uint8_t* data) {
+        return static_cast<uint32_t>(data[0]) | (static_cast<uint32_t>(data[1]) << 8) |
+               (static_cast<uint32_t>(data[2]) << 16) | (static_cast<uint32_t>(data[3]) << 24);
+    }
+
+    uint64_t read64(const uint8_t* data) {
+        return static_cast<uint64_t>(read32(data)) | (static_cast<uint64_t>(read32(data + 4)) << 32);
+    }
+
+    void write32(uint32_t value, uint8_t* data) {
+        for (int i = 0; i < 4; i++) data[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+
+    void write64(uint64_t value, uint8_t* data) {
+        write32(static_cast<uint32_t>(value), data);
+        write32(static_cast<uint32_t>(value >> 32), data + 4);
+    }
+
+    void fileHeader(const char* magic, uint8_t* data) {
+        std::memcpy(data, magic, 4);
+        data[4] = VERSION;
+        data[5] = data[6] = data[7] = 0;
+    }
+
+    bool checkHeader(const std::vector<uint8_t>& bytes, const char* magic) {
+        return bytes.size() >= FILE_HEADER_SIZE && std::memcmp(bytes.data(), magic, 4) == 0 && bytes[4] == VERSION;
+    }
+
+    std::vector<uint8_t> readFile(const std::string& path, size_t maxSize) {
+        std::vector<uint8_t> bytes;
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file.is_open()) return bytes;
+        bytes.resize(std::min(static_cast<size_t>(file.tellg()), maxSize));
+        file.seekg(0);
+        file.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        if (!file) throw std::runtime_error("Could not read " + path);
+        return bytes;
+    }
+
+    void encodeRecord(const RawRecord& record, uint8_t* data) {
+        write64(record.time, data);
+        write32(record.white, data + 8);
+        write32(record.black, data + 12);
+        write32(record.seconds, data + 16);
+        data[20] = static_cast<uint8_t>(record.result);
+        data[21] = static_cast<uint8_t>(record.termination);
+        data[22] = data[23] = 0;
+        write32(Checksum::crc32(data, 24), data + 24);
+    }
+
+    bool decodeRecord(const uint8_t* data, RawRecord& record) {
+        if (Checksum::crc32(data, 24) != read32(data + 24)) return false;
+        record.time = read64(data);
+        record.white = read32(data + 8);
+        record.black = read32(data + 12);
+        record.seconds = read32(data + 16);
+        record.result = static_cast<GameResult>(data[20]);
+        record.termination = static_cast<Termination>(data[21]);
+        return true;
+    }
+
+    // Counts a record into the stats of one of its players
+    void addRecord(const RawRecord& record, bool asWhite, PlayerStats& stats) {
+        const bool draw = record.result == GameResult::DRAW;
+        const bool won = record.result == (asWhite ? GameResult::WHITE_WINS : GameResult::BLACK_WINS);
+        if (asWhite) (draw ? stats.whiteDraws : won ? stats.whiteWins : stats.whiteLosses)++;
+        else (draw ? stats.blackDraws : won ? stats.blackWins : stats.blackLosses)++;
+        stats.totalDurationSeconds += record.seconds;
+    }
+
+    // Player table entry of the index
+    PlayerStats readPlayer(const uint8_t* data) {
+        PlayerStats stats;
+        stats.whiteWins = read32(data);
+        stats.whiteDraws = read32(data + 4);
+        stats.whiteLosses = read32(data + 8);
+        stats.blackWins = read32(data + 12);
+        stats.blackDraws = read32(data + 16);
+        stats.blackLosses = read32(data + 20);
+        stats.totalDurationSeconds = read64(data + 24);
+        return stats;
+    }
+
+    void writePlayer(const PlayerStats& stats, uint64_t postingsStart, uint32_t postingsCount, uint8_t* data) {
+        write32(stats.whiteWins, data);
+        write32(stats.whiteDraws, data + 4);
+        write32(stats.whiteLosses, data + 8);
+        write32(stats.blackWins, data + 12);
+        write32(stats.blackDraws, data + 16);
+        write32(stats.blackLosses, data + 20);
+        write64(stats.totalDurationSeconds, data + 24);
+        write64(postingsStart, data + 32);
+        write32(postingsCount, data + 40);
+        write32(0, data + 44);
+    }
+
+    // "2026-10-19 14:03" as 202610191403, 0 if malformed
+    uint64_t parseTime(const std::string& text) {
+        uint64_t value = 0;
+        int digits = 0;
+        for (char c : text) {
+            if (c >= '0' && c <= '9') {
+                value = value * 10 + static_cast<uint64_t>(c - '0');
+                digits++;
+            } else if (c != '-' && c != ' ' && c != ':') {
+                return 0;
+            }
+        }
+        return digits == 12 ? value : 0;
+    }
+
+    std::string formatDuration(double seconds) {
+        const uint64_t whole = static_cast<uint64_t>(seconds + 0.5);
+        std::ostringstream text;
+        text << whole / 60 << ":" << std::setfill('0') << std::setw(2) << whole % 60;
+        return text.str();
+    }
+
+    std::string trim(const std::string& text) {
+        const size_t first = text.find_first_not_of(' ');
+        if (first == std::string::npos) return "";
+        return text.substr(first, text.find_last_not_of(' ') - first + 1);
+    }
+
+    // Fields of a "a | b | c" line
+    std::vector<std::string> splitFields(const std::string& line) {
+        std::vector<std::string> fields;
+        size_t start = 0;
+        while (true) {
+            const size_t bar = line.find('|', start);
+            fields.push_back(trim(line.substr(start, bar == std::string::npos ? std::string::npos : bar - start)));
+            if (bar == std::string::npos) break;
+            start = bar + 1;
+        }
+        return fields;
+    }
+
+    double millisecondsSince(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+uint64_t PlayerStats::getGames() const {
+    return getWins() + getDraws() + getLosses();
+}
+
+double PlayerStats::getAverageDurationSeconds() const {
+    const uint64_t games = getGames();
+    return games == 0 ? 0.0 : static_cast<double>(totalDurationSeconds) / static_cast<double>(games);
+}
+
+const char* Results::terminationName(Termination termination) {
+    const size_t code = static_cast<size_t>(termination);
+    return code < std::size(TERMINATION_NAMES) ? TERMINATION_NAMES[code] : TERMINATION_NAMES[0];
+}
+
+Termination Results::parseTermination(const std::string& text) {
+    for (size_t code = 1; code < std::size(TERMINATION_NAMES); code++) {
+        if (text == TERMINATION_NAMES[code]) return static_cast<Termination>(code);
+    }
+    return Termination::OTHER;
+}
+
+ResultsStore::ResultsStore(const std::string& path)
+    : recordCount(0), namesSize(0), indexedRecords(0) {
+    std::filesystem::path base(path);
+    recordsPath = path;
+    namesPath = base.replace_extension(".names").string();
+    indexPath = base.replace_extension(".idx").string();
+
+    // Names up to the last complete one
+    const std::vector<uint8_t> nameBytes = readFile(namesPath, SIZE_MAX);
+    if (!nameBytes.empty()) {
+        if (!checkHeader(nameBytes, "SCHN")) throw std::runtime_error(namesPath + " is not a results name file");
+        size_t position = FILE_HEADER_SIZE;
+        while (position < nameBytes.size() && nameBytes.size() - position - 1 >= nameBytes[position]) {
+            const std::string name(reinterpret_cast<const char*>(&nameBytes[position + 1]), nameBytes[position]);
+            playerIds.emplace(name, static_cast<uint32_t>(names.size()));
+            names.push_back(name);
+            position += 1 + nameBytes[position];
+        }
+        namesSize = position;
+    }
+
+    // Records up to the last complete one that passes its checksum
+    std::error_code error;
+    const uint64_t size = std::filesystem::file_size(recordsPath, error);
+    if (!error && size > 0) {
+        if (!checkHeader(readFile(recordsPath, FILE_HEADER_SIZE), "SCHR")) {
+            throw std::runtime_error(recordsPath + " is not a results file");
+        }
+        recordCount = size < FILE_HEADER_SIZE ? 0 : (size - FILE_HEADER_SIZE) / RECORD_SIZE;
+        if (recordCount > 0) {
+            std::ifstream file(recordsPath, std::ios::binary);
+            uint8_t last[RECORD_SIZE];
+            file.seekg(static_cast<std::streamoff>(FILE_HEADER_SIZE + (recordCount - 1) * RECORD_SIZE));
+            file.read(reinterpret_cast<char*>(last), RECORD_SIZE);
+            RawRecord record;
+            if (!file || !decodeRecord(last, record)) recordCount--;
+        }
+    }
+}
+
+uint32_t ResultsStore::playerId(const std::string& name) {
+    const std::string key = name.substr(0, MAX_NAME);
+    const auto found = playerIds.find(key);
+    if (found != playerIds.end()) return found->second;
+    const uint32_t id = static_cast<uint32_t>(names.size());
+    playerIds.emplace(key, id);
+    names.push_back(key);
+    return id;
+}
+
+void ResultsStore::append(const MatchResult& result) {
+    appendAll({ result });
+}
+
+void ResultsStore::appendAll(const std::vector<MatchResult>& results) {
+    if (results.empty()) return;
+    const size_t knownNames = names.size();
+    std::vector<uint8_t> recordBytes(results.size() * RECORD_SIZE);
+    for (size_t i = 0; i < results.size(); i++) {
+        const MatchResult& result = results[i];
+        const RawRecord record{ result.time, playerId(result.white), playerId(result.black),
+                                result.durationSeconds, result.result, result.termination };
+        encodeRecord(record, &recordBytes[i * RECORD_SIZE]);
+    }
+
+    // Names first: a record never refers to a name that is not on disk.
+    // A torn tail from an earlier crash is cut before appending.
+    std::error_code error;
+    if (names.size() > knownNames) {
+        std::vector<uint8_t> nameBytes;
+        if (namesSize == 0) {
+            nameBytes.resize(FILE_HEADER_SIZE);
+            fileHeader("SCHN", nameBytes.data());
+        }
+        for (size_t id = knownNames; id < names.size(); id++) {
+            nameBytes.push_back(static_cast<uint8_t>(names[id].size()));
+            nameBytes.insert(nameBytes.end(), names[id].begin(), names[id].end());
+        }
+        if (namesSize > 0 && std::filesystem::file_size(namesPath, error) != namesSize) {
+            std::filesystem::resize_file(namesPath, namesSize);
+        }
+        std::ofstream file(namesPath, namesSize == 0 ? std::ios::binary | std::ios::trunc : std::ios::binary | std::ios::app);
+        file.write(reinterpret_cast<const char*>(nameBytes.data()), static_cast<std::streamsize>(nameBytes.size()));
+        file.close();
+        if (!file) throw std::runtime_error("Could not write " + namesPath);
+        namesSize += nameBytes.size();
+    }
+
+    records.close();
+    const uint64_t recordsEnd = FILE_HEADER_SIZE + recordCount * RECORD_SIZE;
+    const uint64_t size = std::filesystem::file_size(recordsPath, error);
+    const bool create = error || size < FILE_HEADER_SIZE;
+    if (!create && size != recordsEnd) std::filesystem::resize_file(recordsPath, recordsEnd);
+    std::ofstream file(recordsPath, create ? std::ios::binary | std::ios::trunc : std::ios::binary | std::ios::app);
+    if (create) {
+        uint8_t header[FILE_HEADER_SIZE];
+        fileHeader("SCHR", header);
+        file.write(reinterpret_cast<const char*>(header), FILE_HEADER_SIZE);
+    }
+    file.write(reinterpret_cast<const char*>(recordBytes.data()), static_cast<std::streamsize>(recordBytes.size()));
+    file.close();
+    if (!file) throw std::runtime_error("Could not write " + recordsPath);
+    recordCount += results.size();
+}
+
+uint64_t ResultsStore::importText(const std::string& path, uint64_t& skippedLines) {
+    std::ifstream file(path);
+    if (!file.is_open()) throw std::runtime_error("Could not open " + path);
+    skippedLines = 0;
+    uint64_t imported = 0;
+    std::vector<MatchResult> batch;
+    std::string line;
+    while (std::getline(file, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (trim(line).empty()) continue;
+        const std::vector<std::string> fields = splitFields(line);
+        MatchResult result;
+        const size_t colon = fields.size() == 6 ? fields[5].find(':') : std::string::npos;
+        result.time = fields.size() == 6 ? parseTime(fields[0]) : 0;
+        if (result.time == 0 || colon == std::string::npos || fields[1].empty() || fields[2].empty()) {
+            skippedLines++;
+            continue;
+        }
+        result.white = fields[1];
+        result.black = fields[2];
+        result.termination = Results::parseTermination(fields[4]);
+        const std::string& winner = fields[3];
+        if (winner == "Draw" || fields[4].rfind("Draw", 0) == 0 || fields[4] == "Stalemate") result.result = GameResult::DRAW;
+        else if (winner == result.white) result.result = GameResult::WHITE_WINS;
+        else if (winner == result.black) result.result = GameResult::BLACK_WINS;
+        try {
+            result.durationSeconds = static_cast<uint32_t>(std::stoul(fields[5].substr(0, colon)) * 60 +
+                                                           std::stoul(fields[5].substr(colon + 1)));
+        }
+        catch (const std::exception&) {
+            result.result = GameResult::UNKNOWN;
+        }
+        if (result.result == GameResult::UNKNOWN) {
+            skippedLines++;
+            continue;
+        }
+        batch.push_back(std::move(result));
+        if (batch.size() == 65536) {
+            appendAll(batch);
+            imported += batch.size();
+            batch.clear();
+        }
+    }
+    appendAll(batch);
+    return imported + batch.size();
+}
+
+void ResultsStore::mapRecords() {
+    if (!records.isOpen() && recordCount > 0) records.open(recordsPath);
+}
+
+void ResultsStore::buildIndex() {
+    index.close();
+    mapRecords();
+    const uint8_t* data = recordCount > 0 ? records.data() + FILE_HEADER_SIZE : nullptr;
+    const size_t playerCount = names.size();
+
+    // Aggregates and posting counts, then postings in record order
+    std::vector<PlayerStats> stats(playerCount);
+    std::vector<uint64_t> postingsStart(playerCount + 1, 0);
+    RawRecord record;
+    for (uint64_t number = 0; number < recordCount; number++) {
+        if (!decodeRecord(data + number * RECORD_SIZE, record) || record.white >= playerCount || record.black >= playerCount) continue;
+        addRecord(record, true, stats[record.white]);
+        addRecord(record, false, stats[record.black]);
+        postingsStart[record.white + 1]++;
+        postingsStart[record.black + 1]++;
+    }
+    for (size_t player = 0; player < playerCount; player++) postingsStart[player + 1] += postingsStart[player];
+
+    // A posting is opponent << 32 | record, so sorting groups each opponent's games in order
+    std::vector<uint64_t> postings(postingsStart[playerCount]);
+    std::vector<uint64_t> fill(postingsStart.begin(), postingsStart.end() - 1);
+    for (uint64_t number = 0; number < recordCount; number++) {
+        if (!decodeRecord(data + number * RECORD_SIZE, record) || record.white >= playerCount || record.black >= playerCount) continue;
+        postings[fill[record.white]++] = (static_cast<uint64_t>(record.black) << 32) | number;
+        postings[fill[record.black]++] = (static_cast<uint64_t>(record.white) << 32) | number;
+    }
+    for (size_t player = 0; player < playerCount; player++) {
+        std::sort(postings.begin() + static_cast<std::ptrdiff_t>(postingsStart[player]),
+                  postings.begin() + static_cast<std::ptrdiff_t>(postingsStart[player + 1]));
+    }
+
+    std::vector<uint8_t> bytes(INDEX_HEADER_SIZE + playerCount * INDEX_PLAYER_SIZE + postings.size() * 8);
+    fileHeader("SCHX", bytes.data());
+    write64(recordCount, &bytes[8]);
+    write32(static_cast<uint32_t>(playerCount), &bytes[16]);
+    // Ties the index to the records it was built from
+    write32(recordCount > 0 ? read32(data + (recordCount - 1) * RECORD_SIZE + 24) : 0, &bytes[20]);
+    for (size_t player = 0; player < playerCount; player++) {
+        writePlayer(stats[player], postingsStart[player], static_cast<uint32_t>(postingsStart[player + 1] - postingsStart[player]),
+                    &bytes[INDEX_HEADER_SIZE + player * INDEX_PLAYER_SIZE]);
+    }
+    uint8_t* postingBytes = &bytes[INDEX_HEADER_SIZE + playerCount * INDEX_PLAYER_SIZE];
+    for (size_t i = 0; i < postings.size(); i++) write64(postings[i], postingBytes + i * 8);
+
+    // Written aside and renamed, so readers never see half an index
+    const std::string temporaryPath = indexPath + ".tmp";
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        file.close();
+        if (!file) throw std::runtime_error("Could not write " + temporaryPath);
+    }
+    std::filesystem::rename(temporaryPath, indexPath);
+    index.open(indexPath);
+    indexedRecords = recordCount;
+}
+
+void ResultsStore::openIndex() {
+    if (index.isOpen() && recordCount - indexedRecords < REBUILD_TAIL) return;
+    index.close();
+    indexedRecords = 0;
+    std::error_code error;
+    if (std::filesystem::exists(indexPath, error)) {
+        try {
+            index.open(indexPath);
+        }
+        catch (const std::runtime_error&) {
+            // Empty or unreadable: rebuilt below
+        }
+    }
+    if (index.isOpen()) {
+        const uint8_t* data = index.data();
+        const uint64_t covered = index.size() >= INDEX_HEADER_SIZE ? read64(data + 8) : UINT64_MAX;
+        const uint64_t players = index.size() >= INDEX_HEADER_SIZE ? read32(data + 16) : 0;
+        bool valid = index.size() >= INDEX_HEADER_SIZE + players * INDEX_PLAYER_SIZE &&
+                     std::memcmp(data, "SCHX", 4) == 0 && data[4] == VERSION &&
+                     covered <= recordCount && players <= names.size();
+        if (valid && covered > 0) {
+            mapRecords();
+            valid = read32(records.data() + FILE_HEADER_SIZE + (covered - 1) * RECORD_SIZE + 24) == read32(data + 20);
+        }
+        if (valid) {
+            // Postings must lie inside the file
+            const uint64_t postingsEnd = (index.size() - INDEX_HEADER_SIZE - players * INDEX_PLAYER_SIZE) / 8;
+            for (uint64_t player = 0; player < players && valid; player++) {
+                const uint8_t* entry = data + INDEX_HEADER_SIZE + player * INDEX_PLAYER_SIZE;
+                valid = read64(entry + 32) + read32(entry + 40) <= postingsEnd;
+            }
+        }
+        if (valid && recordCount - covered < REBUILD_TAIL) {
+            indexedRecords = covered;
+            return;
+        }
+        index.close();
+    }
+    buildIndex();
+}
+
+PlayerStats ResultsStore::indexedStats(uint32_t player) const {
+    PlayerStats stats;
+    if (player < read32(index.data() + 16)) {
+        stats = readPlayer(index.data() + INDEX_HEADER_SIZE + player * static_cast<size_t>(INDEX_PLAYER_SIZE));
+    }
+    stats.name = names[player];
+    return stats;
+}
+
+void ResultsStore::addUnindexed(uint32_t player, PlayerStats& stats) const {
+    RawRecord record;
+    for (uint64_t number = indexedRecords; number < recordCount; number++) {
+        if (!decodeRecord(records.data() + FILE_HEADER_SIZE + number * RECORD_SIZE, record)) continue;
+        if (record.white == player) addRecord(record, true, stats);
+        if (record.black == player) addRecord(record, false, stats);
+    }
+}
+
+PlayerStats ResultsStore::playerStats(const std::string& name) {
+    const auto found = playerIds.find(name);
+    if (found == playerIds.end()) throw std::runtime_error("Unknown player: " + name);
+    openIndex();
+    mapRecords();
+    PlayerStats stats = indexedStats(found->second);
+    addUnindexed(found->second, stats);
+    return stats;
+}
+
+HeadToHead ResultsStore::headToHead(const std::string& player, const std::string& opponent) {
+    const auto playerFound = playerIds.find(player);
+    const auto opponentFound = playerIds.find(opponent);
+    if (playerFound == playerIds.end()) throw std::runtime_error("Unknown player: " + player);
+    if (opponentFound == playerIds.end()) throw std::runtime_error("Unknown player: " + opponent);
+    const uint32_t id = playerFound->second;
+    const uint32_t opponentId = opponentFound->second;
+    openIndex();
+    mapRecords();
+
+    HeadToHead result;
+    auto count = [&](uint64_t number) {
+        RawRecord record;
+        if (!decodeRecord(records.data() + FILE_HEADER_SIZE + number * RECORD_SIZE, record)) return;
+        const bool asWhite = record.white == id && record.black == opponentId;
+        if (!asWhite && !(record.black == id && record.white == opponentId)) return;
+        if (record.result == GameResult::DRAW) result.draws++;
+        else if (record.result == (asWhite ? GameResult::WHITE_WINS : GameResult::BLACK_WINS)) result.wins++;
+        else result.losses++;
+        result.totalDurationSeconds += record.seconds;
+    };
+
+    // Binary search of the player's postings for the opponent's range
+    if (id < read32(index.data() + 16)) {
+        const uint8_t* entry = index.data() + INDEX_HEADER_SIZE + id * static_cast<size_t>(INDEX_PLAYER_SIZE);
+        const uint8_t* postings = index.data() + INDEX_HEADER_SIZE + read32(index.data() + 16) * static_cast<size_t>(INDEX_PLAYER_SIZE) +
+                                  read64(entry + 32) * 8;
+        size_t low = 0, high = read32(entry + 40);
+        while (low < high) {
+            const size_t middle = (low + high) / 2;
+            if ((read64(postings + middle * 8) >> 32) < opponentId) low = middle + 1;
+            else high = middle;
+        }
+        const size_t postingCount = read32(entry + 40);
+        for (size_t i = low; i < postingCount && (read64(postings + i * 8) >> 32) == opponentId; i++) {
+            count(read64(postings + i * 8) & 0xFFFFFFFFu);
+        }
+    }
+    for (uint64_t number = indexedRecords; number < recordCount; number++) count(number);
+    return result;
+}
+
+std::vector<PlayerStats> ResultsStore::leaderboard(size_t count, uint64_t minGames) {
+    openIndex();
+    mapRecords();
+    std::vector<PlayerStats> players(names.size());
+    for (uint32_t player = 0; player < names.size(); player++) players[player] = indexedStats(player);
+    RawRecord record;
+    for (uint64_t number = indexedRecords; number < recordCount; number++) {
+        if (!decodeRecord(records.data() + FILE_HEADER_SIZE + number * RECORD_SIZE, record)) continue;
+        if (record.white < players.size()) addRecord(record, true, players[record.white]);
+        if (record.black < players.size()) addRecord(record, false, players[record.black]);
+    }
+    players.erase(std::remove_if(players.begin(), players.end(), [&](const PlayerStats& stats) {
+        return stats.getGames() < std::max<uint64_t>(minGames, 1);
+    }), players.end());
+    const auto better = [](const PlayerStats& a, const PlayerStats& b) {
+        return a.getScore() != b.getScore() ? a.getScore() > b.getScore() : a.getGames() > b.getGames();
+    };
+    count = std::min(count, players.size());
+    std::partial_sort(players.begin(), players.begin() + static_cast<std::ptrdiff_t>(count), players.end(), better);
+    players.resize(count);
+    return players;
+}
+
+int Results::run(const std::vector<std::string>& args) {
+    std::string storePath = ChessConstants::Assets::RESULTS_STORE;
+    size_t top = 10;
+    uint64_t minGames = 1;
+    std::vector<std::string> positional;
+    bool usageError = false;
+    for (size_t i = 0; i < args.size(); i++) {
+        if (args[i] == "--store" && i + 1 < args.size()) storePath = args[++i];
+        else if (args[i] == "--min-games" && i + 1 < args.size()) minGames = std::stoull(args[++i]);
+        else if (args[i].rfind("--", 0) == 0) usageError = true;
+        else positional.push_back(args[i]);
+    }
+    const std::string command = positional.empty() ? "" : positional[0];
+    if (command == "top" && positional.size() == 2) top = std::stoul(positional[1]);
+    const bool valid = (command == "import" && positional.size() >= 2) || (command == "index" && positional.size() == 1) ||
+                       (command == "player" && positional.size() == 2) || (command == "h2h" && positional.size() == 3) ||
+                       (command == "top" && positional.size() <= 2);
+    if (!valid || usageError) {
+        std::cerr << "Usage: results import <match_results.txt>... | index | player <name> | h2h <a> <b> | top [N]"
+                     " [--min-games N] [--store <file>]\n";
+        return 1;
+    }
+
+    ResultsStore store(storePath);
+    const auto start = std::chrono::steady_clock::now();
+    if (command == "import") {
+        for (size_t i = 1; i < positional.size(); i++) {
+            uint64_t skipped = 0;
+            const uint64_t imported = store.importText(positional[i], skipped);
+            std::cout << positional[i] << ": imported " << imported << " results";
+            if (skipped > 0) std::cout << ", skipped " << skipped << " unreadable lines";
+            std::cout << "\n";
+        }
+        store.buildIndex();
+        std::cout << "Store: " << store.getRecordCount() << " results, " << store.getPlayerCount() << " players, "
+                  << millisecondsSince(start) << " ms\n";
+        return 0;
+    }
+    if (command == "index") {
+        store.buildIndex();
+        std::cout << "Indexed " << store.getRecordCount() << " results of " << store.getPlayerCount() << " players in "
+                  << millisecondsSince(start) << " ms\n";
+        return 0;
+    }
+    if (command == "player") {
+        if (!store.hasPlayer(positional[1])) {
+            std::cerr << "Unknown player: " << positional[1] << "\n";
+            return 1;
+        }
+        const PlayerStats stats = store.playerStats(positional[1]);
+        const double queryMs = millisecondsSince(start);
+        std::cout << stats.name << ": " << stats.getGames() << " games, +" << stats.getWins() << " =" << stats.getDraws()
+                  << " -" << stats.getLosses() << ", average " << formatDuration(stats.getAverageDurationSeconds()) << "\n";
+        std::cout << "  as White: +" << stats.whiteWins << " =" << stats.whiteDraws << " -" << stats.whiteLosses
+                  << ", as Black: +" << stats.blackWins << " =" << stats.blackDraws << " -" << stats.blackLosses << "\n";
+        std::cout << "Query: " << queryMs << " ms over " << store.getRecordCount() << " results ("
+                  << store.getRecordCount() - store.getIndexedRecords() << " not yet indexed)\n";
+        return 0;
+    }
+    if (command == "h2h") {
+        for (size_t i = 1; i <= 2; i++) {
+            if (!store.hasPlayer(positional[i])) {
+                std::cerr << "Unknown player: " << positional[i] << "\n";
+                return 1;
+            }
+        }
+        const HeadToHead result = store.headToHead(positional[1], positional[2]);
+        const double queryMs = millisecondsSince(start);
+        const uint64_t games = result.wins + result.draws + result.losses;
+        std::cout << positional[1] << " vs " << positional[2] << ": " << games << " games, +" << result.wins << " ="
+                  << result.draws << " -" << result.losses;
+        if (games > 0) std::cout << ", average " << formatDuration(static_cast<double>(result.totalDurationSeconds) / static_cast<double>(games));
+        std::cout << "\n";
+        std::cout << "Query: " << queryMs << " ms\n";
+        return 0;
+    }
+
+    const std::vector<PlayerStats> players = store.leaderboard(top, minGames);
+    const double queryMs = millisecondsSince(start);
+    std::cout << "  #  Player                    Games    Score      +      =      -  Avg time\n";
+    for (size_t i = 0; i < players.size(); i++) {
+        const PlayerStats& stats = players[i];
+        std::cout << std::setw(3) << i + 1 << "  " << std::left << std::setw(24) << stats.name.substr(0, 24) << std::right
+                  << std::setw(7) << stats.getGames() << std::setw(9) << std::fixed << std::setprecision(1) << stats.getScore()
+                  << std::setw(7) << stats.getWins() << std::setw(7) << stats.getDraws() << std::setw(7) << stats.getLosses()
+                  << std::setw(10) << formatDuration(stats.getAverageDurationSeconds()) << "\n";
+    }
+    std::cout << std::defaultfloat << "Query: " << queryMs << " ms over " << store.getPlayerCount() << " players\n";
+    return 0;
+}
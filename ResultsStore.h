@@ -0,0 +1,121 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "GameCodec.h"
+#include "MappedFile.h"
+
+// How a game ended; the names are the result types Game writes
+enum class Termination : uint8_t {
+    OTHER,
+    CHECKMATE,
+    TIMEOUT,
+    STALEMATE,
+    INSUFFICIENT_MATERIAL,
+    FIFTY_MOVE_RULE,
+    THREEFOLD_REPETITION,
+    ADJUDICATION_WIN,
+    ADJUDICATION_DRAW
+};
+
+struct MatchResult {
+    uint64_t time = 0;              // local time as YYYYMMDDhhmm
+    std::string white;
+    std::string black;
+    GameResult result = GameResult::UNKNOWN;
+    Termination termination = Termination::OTHER;
+    uint32_t durationSeconds = 0;
+};
+
+struct PlayerStats {
+    std::string name;
+    uint32_t whiteWins = 0, whiteDraws = 0, whiteLosses = 0;
+    uint32_t blackWins = 0, blackDraws = 0, blackLosses = 0;
+    uint64_t totalDurationSeconds = 0;
+
+    uint64_t getGames() const;
+    uint64_t getWins() const { return uint64_t(whiteWins) + blackWins; }
+    uint64_t getDraws() const { return uint64_t(whiteDraws) + blackDraws; }
+    uint64_t getLosses() const { return uint64_t(whiteLosses) + blackLosses; }
+    double getScore() const { return static_cast<double>(getWins()) + 0.5 * static_cast<double>(getDraws()); }
+    double getAverageDurationSeconds() const;
+};
+
+// Results of one player against another, from the first player's side
+struct HeadToHead {
+    uint64_t wins = 0, draws = 0, losses = 0;
+    uint64_t totalDurationSeconds = 0;
+};
+
+namespace Results {
+    const char* terminationName(Termination termination);
+    // OTHER for text that names no known termination
+    Termination parseTermination(const std::string& text);
+
+    // Command results: import, index and queries
+    int run(const std::vector<std::string>& args);
+}
+
+// Match results as fixed-size binary records, appended one per game. The
+// store at path "results.bin" is three files:
+//   results.bin    "SCHR", version, 3 zero bytes, then 28-byte records
+//                  { uint64 time, uint32 white, uint32 black, uint32 seconds,
+//                    uint8 result, uint8 termination, uint16 0, uint32 CRC-32 }
+//   results.names  "SCHN", version, 3 zero bytes, then uint8 length + name;
+//                  a player's id is the position of the name
+//   results.idx    per-player aggregates and postings, rebuilt on demand
+// The index holds, for every player, win/draw/loss counts by color, the
+// total game time and the player's (opponent, record) pairs sorted by
+// opponent. Queries read the player table or one player's postings from
+// the memory-mapped index, plus the records appended since it was built.
+// That tail is rebuilt into the index once it reaches 65536 records, so
+// answering a query costs the same for any number of stored games.
+class ResultsStore {
+private:
+    std::string recordsPath;
+    std::string namesPath;
+    std::string indexPath;
+    std::vector<std::string> names;
+    std::unordered_map<std::string, uint32_t> playerIds;
+    uint64_t recordCount;
+    size_t namesSize;               // bytes of complete names
+    MappedFile records;
+    MappedFile index;
+    uint64_t indexedRecords;
+
+    uint32_t playerId(const std::string& name);
+    void appendAll(const std::vector<MatchResult>& results);
+    void mapRecords();
+    void openIndex();
+    // Player table entry; zero for players added after the index was built
+    PlayerStats indexedStats(uint32_t player) const;
+    // Adds the player's records appended after the index was built
+    void addUnindexed(uint32_t player, PlayerStats& stats) const;
+
+public:
+    // Loads the player names; missing files are an empty store.
+    // Throws std::runtime_error if a file exists but is not part of a store.
+    explicit ResultsStore(const std::string& path);
+
+    // Appends one record, adding new player names first. Throws
+    // std::runtime_error if a file cannot be written.
+    void append(const MatchResult& result);
+    // Imports "time | white | black | winner | result type | m:ss" lines as
+    // written to match_results.txt; returns the number imported
+    uint64_t importText(const std::string& path, uint64_t& skippedLines);
+
+    // Rebuilds the index from all records
+    void buildIndex();
+    bool hasPlayer(const std::string& name) const { return playerIds.count(name) != 0; }
+    // Throws std::runtime_error for an unknown player
+    PlayerStats playerStats(const std::string& name);
+    HeadToHead headToHead(const std::string& player, const std::string& opponent);
+    // Highest scores first, ties broken by more games
+    std::vector<PlayerStats> leaderboard(size_t count, uint64_t minGames);
+
+    uint64_t getRecordCount() const { return recordCount; }
+    size_t getPlayerCount() const { return names.size(); }
+    uint64_t getIndexedRecords() const { return indexedRecords; }
+};
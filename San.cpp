@@ -0,0 +1,253 @@
+#include "San.h"
+
+using namespace Bitboards;
+
+namespace {
+    constexpr const char* PIECE_LETTERS = "KQRBN";     // PieceType order, pawns have none
+    constexpr const char* PROMOTION_LETTERS = "NBRQ";  // PackedMove promotion order
+
+    int pieceLetterType(char c) {
+        for (int type = 0; type < 5; type++) {
+            if (PIECE_LETTERS[type] == c) return type;
+        }
+        return -1;
+    }
+
+    int promotionIndex(char c) {
+        for (int index = 0; index < 4; index++) {
+            if (PROMOTION_LETTERS[index] == c || PROMOTION_LETTERS[index] + ('a' - 'A') == c) return index;
+        }
+        return -1;
+    }
+
+    int pawnDirection(PieceColor color) {
+        return color == PieceColor::WHITE ? -8 : 8;
+    }
+
+    // Whether the side to move keeps its king safe; castling is checked where it is built
+    bool isLegal(const BoardState& state, int from, int to, bool enPassant) {
+        const PieceColor us = state.getSideToMove();
+        const Bitboard enemies = state.getPieces(oppositeColor(us));
+        if (pieceCodeType(state.getPieceAt(from)) == PieceType::KING) {
+            return !(state.attackersTo(to, state.getOccupied() ^ squareBit(from)) & enemies & ~squareBit(to));
+        }
+        Bitboard removed = squareBit(to);
+        Bitboard occupancy = (state.getOccupied() ^ squareBit(from)) | squareBit(to);
+        if (enPassant) {
+            const Bitboard captured = squareBit(to - pawnDirection(us));
+            occupancy ^= captured;
+            removed |= captured;
+        }
+        return !(state.attackersTo(state.getKingSquare(us), occupancy) & enemies & ~removed);
+    }
+
+    PackedMove castlingMove(const BoardState& state, bool kingside) {
+        const PieceColor us = state.getSideToMove();
+        const PieceColor them = oppositeColor(us);
+        const int kingSquare = makeSquare(us == PieceColor::WHITE ? 7 : 0, 4);
+        const uint8_t right = us == PieceColor::WHITE ? (kingside ? WHITE_KINGSIDE : WHITE_QUEENSIDE)
+                                                      : (kingside ? BLACK_KINGSIDE : BLACK_QUEENSIDE);
+        const int step = kingside ? 1 : -1;
+        const int rookSquare = kingside ? kingSquare + 3 : kingSquare - 4;
+        const Bitboard between = kingside ? squareBit(kingSquare + 1) | squareBit(kingSquare + 2)
+                                          : squareBit(kingSquare - 1) | squareBit(kingSquare - 2) | squareBit(kingSquare - 3);
+
+        if (!(state.getCastlingRights() & right) ||
+            state.getPieceAt(kingSquare) != makePieceCode(us, PieceType::KING) ||
+            state.getPieceAt(rookSquare) != makePieceCode(us, PieceType::ROOK) ||
+            (state.getOccupied() & between) ||
+            state.isSquareAttacked(kingSquare, them) ||
+            state.isSquareAttacked(kingSquare + step, them) ||
+            state.isSquareAttacked(kingSquare + 2 * step, them)) {
+            return PackedMove::none();
+        }
+        return PackedMove(kingSquare, kingSquare + 2 * step, kingside ? PackedMove::KING_CASTLE : PackedMove::QUEEN_CASTLE);
+    }
+
+    // Other pieces of the mover's type that could legally reach the same square
+    Bitboard rivals(const BoardState& state, PieceType type, int from, int to) {
+        const PieceColor us = state.getSideToMove();
+        Bitboard candidates = pieceAttacks(type, to, state.getOccupied()) & state.getPieces(us, type) & ~squareBit(from);
+        Bitboard legal = 0;
+        while (candidates) {
+            const int square = popLsb(candidates);
+            if (isLegal(state, square, to, false)) legal |= squareBit(square);
+        }
+        return legal;
+    }
+
+    char* writeSquare(char* out, int square) {
+        *out++ = static_cast<char>('a' + colOf(square));
+        *out++ = static_cast<char>('8' - rowOf(square));
+        return out;
+    }
+}
+
+size_t San::write(const BoardState& state, PackedMove move, char* buffer) {
+    char* out = buffer;
+    const int from = move.getFrom();
+    const int to = move.getTo();
+
+    if (move.isCastling()) {
+        *out++ = 'O';
+        *out++ = '-';
+        *out++ = 'O';
+        if (move.getFlags() == PackedMove::QUEEN_CASTLE) {
+            *out++ = '-';
+            *out++ = 'O';
+        }
+    } else {
+        const PieceType type = pieceCodeType(state.getPieceAt(from));
+        if (type == PieceType::PAWN) {
+            if (move.isCapture()) {
+                *out++ = static_cast<char>('a' + colOf(from));
+                *out++ = 'x';
+            }
+            out = writeSquare(out, to);
+            if (move.isPromotion()) {
+                *out++ = '=';
+                *out++ = PROMOTION_LETTERS[move.getFlags() & 3];
+            }
+        } else {
+            *out++ = PIECE_LETTERS[static_cast<int>(type)];
+            const Bitboard others = type == PieceType::KING ? 0 : rivals(state, type, from, to);
+            if (others) {
+                // File if it tells them apart, else rank, else both
+                if (!(others & colMask(colOf(from)))) {
+                    *out++ = static_cast<char>('a' + colOf(from));
+                } else if (!(others & rowMask(rowOf(from)))) {
+                    *out++ = static_cast<char>('8' - rowOf(from));
+                } else {
+                    out = writeSquare(out, from);
+                }
+            }
+            if (move.isCapture()) *out++ = 'x';
+            out = writeSquare(out, to);
+        }
+    }
+
+    if (state.givesCheck(move)) {
+        BoardState next = state;
+        UndoInfo undo;
+        next.makeMove(move, undo);
+        MoveList replies;
+        next.generateLegalMoves(replies);
+        *out++ = replies.empty() ? '#' : '+';
+    }
+    return static_cast<size_t>(out - buffer);
+}
+
+std::string San::toString(const BoardState& state, PackedMove move) {
+    char buffer[MAX_LENGTH];
+    return std::string(buffer, write(state, move, buffer));
+}
+
+PackedMove San::parse(const BoardState& state, std::string_view text) {
+    const char* cursor = text.data();
+    const char* const end = cursor + text.size();
+    if (cursor == end) return PackedMove::none();
+
+    // Castling: "O-O", "O-O-O", or with zeros
+    if (*cursor == 'O' || *cursor == '0') {
+        const char letter = *cursor;
+        int count = 0;
+        while (cursor != end && *cursor == letter) {
+            count++;
+            cursor++;
+            if (cursor != end && *cursor == '-') cursor++;
+        }
+        if (count < 2 || count > 3) return PackedMove::none();
+        if (cursor != end && *cursor != '+' && *cursor != '#' && *cursor != '!' && *cursor != '?') {
+            return PackedMove::none();
+        }
+        return castlingMove(state, count == 2);
+    }
+
+    PieceType type = PieceType::PAWN;
+    const int letterType = pieceLetterType(*cursor);
+    if (letterType >= 0) {
+        type = static_cast<PieceType>(letterType);
+        cursor++;
+    }
+
+    // Files and ranks in order of appearance; the last two are the destination
+    char coordinates[4];
+    int count = 0;
+    int promotion = -1;
+    for (; cursor != end; cursor++) {
+        const char c = *cursor;
+        if ((c >= 'a' && c <= 'h') || (c >= '1' && c <= '8')) {
+            if (count == 4 || promotion >= 0) return PackedMove::none();
+            coordinates[count++] = c;
+        } else if (c == 'x' || c == ':' || c == '-') {
+            continue;
+        } else if (c == '=' && cursor + 1 != end) {
+            promotion = promotionIndex(*++cursor);
+            if (promotion < 0) return PackedMove::none();
+        } else if (c >= 'B' && c <= 'R' && promotion < 0 && type == PieceType::PAWN && count >= 2) {
+            promotion = promotionIndex(c);
+            if (promotion < 0) return PackedMove::none();
+        } else if (c == '+' || c == '#' || c == '!' || c == '?') {
+            break;
+        } else {
+            return PackedMove::none();
+        }
+    }
+    if (count < 2 || coordinates[count - 2] < 'a' || coordinates[count - 2] > 'h' ||
+        coordinates[count - 1] < '1' || coordinates[count - 1] > '8') {
+        return PackedMove::none();
+    }
+    const int to = makeSquare('8' - coordinates[count - 1], coordinates[count - 2] - 'a');
+    Bitboard sources = ~0ULL;
+    for (int i = 0; i < count - 2; i++) {
+        const char c = coordinates[i];
+        sources &= (c >= 'a') ? colMask(c - 'a') : rowMask('8' - c);
+    }
+
+    const PieceColor us = state.getSideToMove();
+    if (state.getPieces(us) & squareBit(to)) return PackedMove::none();
+    const bool targetOccupied = (state.getOccupied() & squareBit(to)) != 0;
+    const Bitboard ourPieces = state.getPieces(us, type);
+
+    Bitboard candidates;
+    bool pawnCapture = false;
+    if (type == PieceType::PAWN) {
+        // A source file other than the destination's makes it a capture
+        pawnCapture = !(sources & colMask(colOf(to)));
+        if (pawnCapture) {
+            if (!targetOccupied && to != state.getEnPassantSquare()) return PackedMove::none();
+            candidates = pawnAttacks(oppositeColor(us), to) & ourPieces;
+        } else {
+            if (targetOccupied) return PackedMove::none();
+            // No pawn can stand behind its own back rank; stepping back from it would leave the board
+            if (rowOf(to) == (us == PieceColor::WHITE ? 7 : 0)) return PackedMove::none();
+            const int single = to - pawnDirection(us);
+            candidates = ourPieces & squareBit(single);
+            const int doublePushRow = us == PieceColor::WHITE ? 4 : 3;
+            if (!candidates && rowOf(to) == doublePushRow && state.getPieceAt(single) == NO_PIECE) {
+                candidates = ourPieces & squareBit(single - pawnDirection(us));
+            }
+        }
+        const bool promotes = rowOf(to) == (us == PieceColor::WHITE ? 0 : 7);
+        if (promotes != (promotion >= 0)) return PackedMove::none();
+    } else {
+        if (promotion >= 0) return PackedMove::none();
+        candidates = pieceAttacks(type, to, state.getOccupied()) & ourPieces;
+    }
+    candidates &= sources;
+
+    PackedMove found = PackedMove::none();
+    while (candidates) {
+        const int from = popLsb(candidates);
+        int flags = targetOccupied ? PackedMove::CAPTURE : PackedMove::QUIET;
+        if (type == PieceType::PAWN) {
+            if (pawnCapture && !targetOccupied) flags = PackedMove::EN_PASSANT;
+            else if (promotion >= 0) flags |= PackedMove::PROMOTION + promotion;
+            else if (to - from == 2 * pawnDirection(us)) flags = PackedMove::DOUBLE_PUSH;
+        }
+        if (!isLegal(state, from, to, flags == PackedMove::EN_PASSANT)) continue;
+        if (!found.isNone()) return PackedMove::none();   // ambiguous
+        found = PackedMove(from, to, flags);
+    }
+    return found;
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include "BoardState.h"
+#include "PackedMove.h"
+
+// Standard algebraic notation: "Nbd7", "exd6", "e8=Q+", "O-O-O#".
+// Disambiguation looks only at same-type pieces attacking the destination
+// (attack bitboards plus a pin test), so neither direction generates a
+// move list; the one exception is telling mate from check after a
+// checking move.
+namespace San {
+    constexpr size_t MAX_LENGTH = 8;
+
+    // Writes a legal move of the position, no terminator; returns the length
+    size_t write(const BoardState& state, PackedMove move, char* buffer);
+    std::string toString(const BoardState& state, PackedMove move);
+
+    // Legal move named by the text in one pass over it; PackedMove::none()
+    // if it names no legal move or more than one. Also accepts "0-0",
+    // superfluous disambiguation, long forms such as "Ng1-f3", promotions
+    // without '=' and trailing +, #, ! and ? annotations.
+    PackedMove parse(const BoardState& state, std::string_view text);
+}
@@ -0,0 +1,624 @@
+#include "Search.h"
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include "AllocationHook.h"
+#include "Arena.h"
+#include "Endgames.h"
+#include "Evaluation.h"
+#include "KpkBitbase.h"
+#include "TablebaseProber.h"
+
+namespace {
+    constexpr int TT_MOVE_SCORE = 1000000;
+    constexpr int CAPTURE_SCORE = 100000;
+    constexpr int PROMOTION_SCORE = 90000;
+    constexpr int KILLER_SCORE = 80000;
+    constexpr int HISTORY_LIMIT = 50000;
+    constexpr int ASPIRATION_WINDOW = 25;
+
+    int scoreToTable(int score, int ply) {
+        if (score >= Search::MATE_BOUND) return score + ply;
+        if (score <= -Search::MATE_BOUND) return score - ply;
+        return score;
+    }
+
+    int scoreFromTable(int score, int ply) {
+        if (score >= Search::MATE_BOUND) return score - ply;
+        if (score <= -Search::MATE_BOUND) return score + ply;
+        return score;
+    }
+}
+
+Search::Search(TranspositionTable& tt)
+    : table(tt), stats(&SearchStats::local()), pawnTable(&PawnTable::local()),
+      sharedEvalCache(nullptr), evalCache(&EvalCache::local()), cachedNetwork(nullptr), tablebases(nullptr), stopRequested(false), startNodes(0),
+      frames(std::make_unique<Frame[]>(MAX_PLY)),
+      rootMoves(nullptr), rootMoveCount(0), completedLines(nullptr), completedCount(0), topScores(nullptr) {
+    for (int ply = 0; ply < MAX_PLY; ply++) {
+        frames[ply].killers[0] = frames[ply].killers[1] = PackedMove::none();
+        frames[ply].pvLength = 0;
+    }
+    for (auto& row : history) std::fill(std::begin(row), std::end(row), 0);
+}
+
+SearchResult Search::run(const BoardState& root, const SearchLimits& searchLimits) {
+    board = root;
+    limits = searchLimits;
+    stopRequested = false;
+    stats = &SearchStats::local();
+    pawnTable = &PawnTable::local();
+    // Tables otherwise built on first use, which would allocate inside the search
+    KpkBitbase::init();
+    Endgames::init();
+    if (tablebases != nullptr) TablebaseProber::prepareThread();
+    const NnueNetwork* network = Nnue::getActiveNetwork();
+    if (network == nullptr) {
+        nnue.reset();
+    } else if (!nnue || &nnue->getNetwork() != network) {
+        nnue = std::make_unique<NnueEvaluator>(*network, MAX_PLY + 1);
+    }
+    if (nnue) nnue->reset(board);
+    evalCache = sharedEvalCache != nullptr ? sharedEvalCache : &EvalCache::local();
+    if (network != cachedNetwork) {
+        // Scores from a different evaluator must not leak into this search
+        evalCache->clear();
+        cachedNetwork = network;
+    }
+    startTime = std::chrono::steady_clock::now();
+
+    for (int ply = 0; ply < MAX_PLY; ply++) {
+        frames[ply].killers[0] = frames[ply].killers[1] = PackedMove::none();
+    }
+    for (auto& row : history) std::fill(std::begin(row), std::end(row), 0);
+    keyHistory[0] = board.getKey();
+
+    MoveList legalMoves;
+    board.generateLegalMoves(legalMoves);
+    const int lineCount = std::clamp(limits.multiPV, 1, std::max(legalMoves.size(), 1));
+
+    // Root bookkeeping for this run comes from the thread's arena
+    Arena& arena = Arena::local();
+    arena.reset();
+    rootMoveCount = legalMoves.size();
+    rootMoves = arena.allocate<RootMove>(std::max(rootMoveCount, 1));
+    completedLines = arena.allocate<RootMove>(lineCount);
+    topScores = arena.allocate<int>(lineCount);
+    completedCount = 0;
+    for (int i = 0; i < rootMoveCount; i++) {
+        rootMoves[i].move = legalMoves[i];
+        rootMoves[i].score = rootMoves[i].previousScore = -INFINITE_SCORE;
+        rootMoves[i].pvLength = 0;
+    }
+
+    const SearchStats startStats = *stats;
+    startNodes = stats->totalNodes();
+    const uint64_t pawnProbesBefore = pawnTable->getProbes();
+    const uint64_t pawnHitsBefore = pawnTable->getHits();
+    const uint64_t allocationsBefore = AllocationHook::threadAllocations();
+    int completedDepth = 0;
+    uint64_t previousIterationNodes = 0;
+
+    for (int depth = 1; depth <= std::min(limits.depth, MAX_PLY - 1); depth++) {
+        const uint64_t nodesBefore = stats->totalNodes();
+        const RootMove* lines = rootMoves;
+        int found = 0;
+
+        if (lineCount == 1) {
+            // Single PV: the root is an ordinary node and its line sits in frame 0
+            int score = alphaBeta(-INFINITE_SCORE, INFINITE_SCORE, depth, 0, false);
+            if (frames[0].pvLength > 0) {
+                RootMove& line = rootMoves[0];
+                line.move = frames[0].pv[0];
+                line.score = score;
+                line.pvLength = frames[0].pvLength;
+                std::copy_n(frames[0].pv, frames[0].pvLength, line.pv);
+                found = 1;
+            }
+        } else {
+            searchRoot(depth, lineCount);
+            while (found < lineCount && rootMoves[found].score > -INFINITE_SCORE) found++;
+        }
+
+        // A partial iteration is only trusted if nothing else is available
+        if (stopRequested && completedDepth > 0) break;
+        if (found > 0) {
+            std::copy_n(lines, found, completedLines);
+            completedCount = found;
+            completedDepth = depth;
+        }
+
+        const uint64_t iterationNodes = stats->totalNodes() - nodesBefore;
+        if (limits.printIterations && found > 0) {
+            double branchingFactor = previousIterationNodes > 0
+                ? static_cast<double>(iterationNodes) / static_cast<double>(previousIterationNodes) : 0.0;
+            printIteration(depth, stats->since(startStats), branchingFactor);
+        }
+        previousIterationNodes = iterationNodes;
+
+        if (stopRequested) break;
+        if (limits.onIteration && found > 0) limits.onIteration(depth, collectLines());
+        // A forced mate found within the current horizon will not change
+        if (lineCount == 1 && found > 0 && isMateScore(completedLines[0].score) &&
+            MATE_SCORE - std::abs(completedLines[0].score) <= depth) {
+            break;
+        }
+    }
+
+    SearchResult result;
+    result.allocations = AllocationHook::threadAllocations() - allocationsBefore;
+    stats->pawnProbes += pawnTable->getProbes() - pawnProbesBefore;
+    stats->pawnHits += pawnTable->getHits() - pawnHitsBefore;
+    result.lines = collectLines();
+    if (!result.lines.empty()) {
+        result.bestMove = result.lines[0].moves[0];
+        result.pv = result.lines[0].moves;
+        result.score = result.lines[0].score;
+        result.depth = completedDepth;
+    } else if (!legalMoves.empty()) {
+        result.bestMove = legalMoves[0];
+    }
+
+    result.seconds = elapsedMs() / 1000.0;
+    result.stats = stats->since(startStats);
+    return result;
+}
+
+void Search::stop() {
+    stopRequested = true;
+}
+
+bool Search::isMateScore(int score) {
+    return std::abs(score) >= MATE_BOUND;
+}
+
+std::string Search::formatScore(int score) {
+    if (isMateScore(score)) {
+        int plies = MATE_SCORE - std::abs(score);
+        int moves = (plies + 1) / 2;
+        return "mate " + std::to_string(score > 0 ? moves : -moves);
+    }
+    return "cp " + std::to_string(score);
+}
+
+void Search::makeMove(PackedMove move, UndoInfo& undo) {
+    if (nnue) nnue->push(board, move);
+    board.makeMove(move, undo);
+}
+
+void Search::unmakeMove(PackedMove move, const UndoInfo& undo) {
+    board.unmakeMove(move, undo);
+    if (nnue) nnue->pop();
+}
+
+void Search::makeNullMove(UndoInfo& undo) {
+    if (nnue) nnue->pushNull();
+    board.makeNullMove(undo);
+}
+
+void Search::unmakeNullMove(const UndoInfo& undo) {
+    board.unmakeNullMove(undo);
+    if (nnue) nnue->pop();
+}
+
+int Search::evaluate() {
+    const uint64_t key = board.getKey();
+    int score;
+    stats->evalProbes++;
+    if (evalCache->probe(key, score)) {
+        stats->evalHits++;
+        return score;
+    }
+    score = nnue ? nnue->evaluate(board) : Evaluation::evaluate(board, *pawnTable);
+    evalCache->store(key, score);
+    return score;
+}
+
+int Search::alphaBeta(int alpha, int beta, int depth, int ply, bool allowNull) {
+    Frame& frame = frames[ply];
+    frame.pvLength = 0;
+    if (depth <= 0) return quiescence(alpha, beta, ply);
+
+    stats->nodes++;
+    if ((stats->nodes & 2047) == 0) checkLimits();
+    if (stopRequested) return 0;
+
+    const bool rootNode = (ply == 0);
+    const bool pvNode = (beta - alpha > 1);
+
+    if (!rootNode) {
+        if (board.getHalfmoveClock() >= 100 || isRepetition(ply)) return 0;
+        if (ply >= MAX_PLY - 1) return evaluate();
+
+        // Mate distance pruning
+        alpha = std::max(alpha, -MATE_SCORE + ply);
+        beta = std::min(beta, MATE_SCORE - ply - 1);
+        if (alpha >= beta) return alpha;
+
+        // Tables ignore the fifty-move rule, so only trust them when the
+        // clock was just reset; quieter nodes below keep searching normally
+        if (tablebases != nullptr && board.getHalfmoveClock() == 0 &&
+            Bitboards::popCount(board.getOccupied()) <= tablebases->getMaxPieces()) {
+            stats->tbProbes++;
+            TablebaseProbe probe;
+            if (tablebases->probe(board, probe)) {
+                stats->tbHits++;
+                if (probe.wdl == 0) return 0;
+                return probe.wdl > 0 ? TB_WIN_SCORE - ply : -TB_WIN_SCORE + ply;
+            }
+        }
+    }
+
+    const uint64_t key = board.getKey();
+    PackedMove ttMove = PackedMove::none();
+    TTEntry entry;
+    stats->ttProbes++;
+    if (table.probe(key, entry)) {
+        stats->ttHits++;
+        ttMove = PackedMove::fromRaw(entry.move);
+        if (!pvNode && entry.depth >= depth) {
+            int ttScore = scoreFromTable(entry.score, ply);
+            if (entry.bound == Bound::EXACT ||
+                (entry.bound == Bound::LOWER && ttScore >= beta) ||
+                (entry.bound == Bound::UPPER && ttScore <= alpha)) {
+                return ttScore;
+            }
+        }
+    }
+
+    const bool inCheck = board.isInCheck();
+    const int staticEval = inCheck ? -INFINITE_SCORE : evaluate();
+    frame.staticEval = staticEval;
+
+    // Null-move pruning: give the opponent a free move; if we still fail high the node is cut
+    if (allowNull && !pvNode && !inCheck && depth >= 3 && staticEval >= beta &&
+        board.hasNonPawnMaterial(board.getSideToMove())) {
+        stats->nullMoveTries++;
+        const int reduction = 2 + depth / 4;
+        UndoInfo undo;
+        makeNullMove(undo);
+        keyHistory[ply + 1] = board.getKey();
+        int score = -alphaBeta(-beta, -beta + 1, depth - 1 - reduction, ply + 1, false);
+        unmakeNullMove(undo);
+        if (stopRequested) return 0;
+        if (score >= beta) {
+            stats->nullMoveCutoffs++;
+            return isMateScore(score) ? beta : score;
+        }
+    }
+
+    MoveList& moves = frame.moves;
+    board.generateMoves(moves);
+    scoreMoves(moves, frame.scores, ttMove, ply);
+
+    int legalMoves = 0;
+    int bestScore = -INFINITE_SCORE;
+    PackedMove bestMove = PackedMove::none();
+    Bound bound = Bound::UPPER;
+
+    for (int i = 0; i < moves.size(); i++) {
+        PackedMove move = pickNextMove(moves, frame.scores, i);
+        UndoInfo undo;
+        makeMove(move, undo);
+        if (!board.wasLegalMove()) {
+            unmakeMove(move, undo);
+            continue;
+        }
+        legalMoves++;
+        keyHistory[ply + 1] = board.getKey();
+
+        const bool givesCheck = board.isInCheck();
+        const int newDepth = depth - 1 + (givesCheck ? 1 : 0);
+        int score;
+
+        if (legalMoves == 1) {
+            score = -alphaBeta(-beta, -alpha, newDepth, ply + 1, true);
+        } else {
+            // Late move reductions for quiet moves ordered after the good ones
+            int reduction = 0;
+            if (depth >= 3 && legalMoves > 3 && move.isQuiet() && !inCheck && !givesCheck &&
+                move != frame.killers[0] && move != frame.killers[1]) {
+                reduction = (depth >= 6 && legalMoves > 8) ? 2 : 1;
+                stats->lmrReductions++;
+            }
+
+            score = -alphaBeta(-alpha - 1, -alpha, newDepth - reduction, ply + 1, true);
+            if (reduction > 0 && score > alpha) {
+                stats->lmrResearches++;
+                score = -alphaBeta(-alpha - 1, -alpha, newDepth, ply + 1, true);
+            }
+            if (score > alpha && score < beta) {
+                score = -alphaBeta(-beta, -alpha, newDepth, ply + 1, true);
+            }
+        }
+
+        unmakeMove(move, undo);
+        if (stopRequested) return 0;
+
+        if (score > bestScore) {
+            bestScore = score;
+            bestMove = move;
+            if (score > alpha) {
+                alpha = score;
+                bound = Bound::EXACT;
+                updatePv(ply, move);
+
+                if (score >= beta) {
+                    bound = Bound::LOWER;
+                    stats->recordCutoff(legalMoves - 1);
+                    if (move.isQuiet()) {
+                        if (frame.killers[0] != move) {
+                            frame.killers[1] = frame.killers[0];
+                            frame.killers[0] = move;
+                        }
+                        int& entryScore = history[board.getPieceAt(move.getFrom())][move.getTo()];
+                        entryScore = std::min(entryScore + depth * depth, HISTORY_LIMIT);
+                    }
+                    break;
+                }
+            }
+        }
+    }
+
+    if (legalMoves == 0) {
+        return inCheck ? -MATE_SCORE + ply : 0;
+    }
+
+    table.store(key, scoreToTable(bestScore, ply), bestMove, depth, bound);
+    return bestScore;
+}
+
+int Search::searchRootWindow(int previousScore, int depth) {
+    // Aspiration window around the previous iteration's score, widened on failure
+    int delta = ASPIRATION_WINDOW;
+    int alpha = -INFINITE_SCORE;
+    int beta = INFINITE_SCORE;
+    if (previousScore > -INFINITE_SCORE && !isMateScore(previousScore)) {
+        alpha = std::max(previousScore - delta, -INFINITE_SCORE);
+        beta = std::min(previousScore + delta, INFINITE_SCORE);
+    }
+
+    while (true) {
+        int score = -alphaBeta(-beta, -alpha, depth, 1, true);
+        if (stopRequested) return score;
+        if (score <= alpha && alpha > -INFINITE_SCORE) {
+            alpha = std::max(score - delta, -INFINITE_SCORE);
+        } else if (score >= beta && beta < INFINITE_SCORE) {
+            beta = std::min(score + delta, INFINITE_SCORE);
+        } else {
+            return score;
+        }
+        delta *= 4;
+    }
+}
+
+void Search::searchRoot(int depth, int lineCount) {
+    stats->nodes++;
+
+    // Best lines of the previous iteration go first so the K-th score settles early
+    sortRootMoves(rootMoves, rootMoveCount);
+    for (int i = 0; i < rootMoveCount; i++) {
+        rootMoves[i].previousScore = rootMoves[i].score;
+        rootMoves[i].score = -INFINITE_SCORE;
+    }
+
+    int topCount = 0;   // topScores holds the best scores so far, descending
+    const bool rootInCheck = board.isInCheck();
+
+    for (int i = 0; i < rootMoveCount; i++) {
+        RootMove& rootMove = rootMoves[i];
+        UndoInfo undo;
+        makeMove(rootMove.move, undo);
+        keyHistory[1] = board.getKey();
+        const int newDepth = depth - 1 + (board.isInCheck() ? 1 : 0);
+
+        int score;
+        bool exact = true;
+        if (topCount < lineCount) {
+            score = searchRootWindow(rootMove.previousScore, newDepth);
+        } else {
+            // Only a move that beats the current K-th line needs an exact score
+            const int kthScore = topScores[topCount - 1];
+            int reduction = 0;
+            if (depth >= 3 && i >= lineCount + 2 && rootMove.move.isQuiet() && !rootInCheck && newDepth < depth) {
+                reduction = (depth >= 6 && i >= lineCount + 7) ? 2 : 1;
+                // The tail of a long move list rarely reaches the top K; a fail high is re-searched in full
+                if (depth >= 8 && i >= lineCount + 12) reduction = 3;
+                stats->lmrReductions++;
+            }
+            score = -alphaBeta(-kthScore - 1, -kthScore, newDepth - reduction, 1, true);
+            if (reduction > 0 && score > kthScore) {
+                stats->lmrResearches++;
+                score = -alphaBeta(-kthScore - 1, -kthScore, newDepth, 1, true);
+            }
+            if (score > kthScore) {
+                score = -alphaBeta(-INFINITE_SCORE, -kthScore, newDepth, 1, true);
+            }
+            exact = score > kthScore;
+        }
+        unmakeMove(rootMove.move, undo);
+        if (stopRequested) return;
+        if (!exact) continue;
+
+        rootMove.score = score;
+        rootMove.pv[0] = rootMove.move;
+        rootMove.pvLength = frames[1].pvLength + 1;
+        std::copy_n(frames[1].pv, frames[1].pvLength, rootMove.pv + 1);
+
+        // Insert into the descending top list, dropping the score that falls off the end
+        int slot = std::min(topCount, lineCount - 1);
+        while (slot > 0 && topScores[slot - 1] < score) {
+            topScores[slot] = topScores[slot - 1];
+            slot--;
+        }
+        topScores[slot] = score;
+        topCount = std::min(topCount + 1, lineCount);
+    }
+
+    sortRootMoves(rootMoves, rootMoveCount);
+    if (rootMoveCount > 0) {
+        table.store(board.getKey(), scoreToTable(rootMoves[0].score, 0), rootMoves[0].move, depth, Bound::EXACT);
+    }
+}
+
+int Search::quiescence(int alpha, int beta, int ply) {
+    Frame& frame = frames[ply];
+    frame.pvLength = 0;
+    stats->qnodes++;
+    if ((stats->qnodes & 2047) == 0) checkLimits();
+    if (stopRequested) return 0;
+
+    int standPat = evaluate();
+    if (ply >= MAX_PLY - 1 || standPat >= beta) return standPat;
+    alpha = std::max(alpha, standPat);
+
+    MoveList& captures = frame.moves;
+    board.generateCaptures(captures);
+    scoreMoves(captures, frame.scores, PackedMove::none(), ply);
+
+    int bestScore = standPat;
+    for (int i = 0; i < captures.size(); i++) {
+        PackedMove move = pickNextMove(captures, frame.scores, i);
+        UndoInfo undo;
+        makeMove(move, undo);
+        if (!board.wasLegalMove()) {
+            unmakeMove(move, undo);
+            continue;
+        }
+        int score = -quiescence(-beta, -alpha, ply + 1);
+        unmakeMove(move, undo);
+        if (stopRequested) return 0;
+
+        if (score > bestScore) {
+            bestScore = score;
+            if (score > alpha) {
+                alpha = score;
+                if (score >= beta) break;
+            }
+        }
+    }
+    return bestScore;
+}
+
+void Search::scoreMoves(const MoveList& moves, int* scores, PackedMove ttMove, int ply) const {
+    for (int i = 0; i < moves.size(); i++) {
+        const PackedMove move = moves[i];
+        if (move == ttMove) {
+            scores[i] = TT_MOVE_SCORE;
+        } else if (move.isCapture()) {
+            // MVV-LVA: most valuable victim first, cheapest attacker breaks ties
+            int victim = move.isEnPassant() ? Evaluation::pieceValue(PieceType::PAWN)
+                                            : Evaluation::pieceValue(pieceCodeType(board.getPieceAt(move.getTo())));
+            int attacker = Evaluation::pieceValue(pieceCodeType(board.getPieceAt(move.getFrom())));
+            scores[i] = CAPTURE_SCORE + victim * 10 - attacker / 10;
+        } else if (move.isPromotion()) {
+            scores[i] = PROMOTION_SCORE + Evaluation::pieceValue(move.getPromotionType());
+        } else if (move == frames[ply].killers[0]) {
+            scores[i] = KILLER_SCORE;
+        } else if (move == frames[ply].killers[1]) {
+            scores[i] = KILLER_SCORE - 1;
+        } else {
+            scores[i] = history[board.getPieceAt(move.getFrom())][move.getTo()];
+        }
+    }
+}
+
+PackedMove Search::pickNextMove(MoveList& moves, int* scores, int index) {
+    int best = index;
+    for (int i = index + 1; i < moves.size(); i++) {
+        if (scores[i] > scores[best]) best = i;
+    }
+    std::swap(moves[index], moves[best]);
+    std::swap(scores[index], scores[best]);
+    return moves[index];
+}
+
+void Search::sortRootMoves(RootMove* moves, int count) {
+    // Stable insertion sort, best score first; std::stable_sort may allocate
+    for (int i = 1; i < count; i++) {
+        RootMove current = moves[i];
+        int j = i;
+        while (j > 0 && moves[j - 1].score < current.score) {
+            moves[j] = moves[j - 1];
+            j--;
+        }
+        moves[j] = current;
+    }
+}
+
+void Search::updatePv(int ply, PackedMove move) {
+    Frame& frame = frames[ply];
+    const Frame& child = frames[ply + 1];
+    frame.pv[0] = move;
+    std::copy_n(child.pv, child.pvLength, frame.pv + 1);
+    frame.pvLength = child.pvLength + 1;
+}
+
+bool Search::isRepetition(int ply) const {
+    const uint64_t key = keyHistory[ply];
+    const int limit = std::max(0, ply - board.getHalfmoveClock());
+    for (int i = ply - 2; i >= limit; i -= 2) {
+        if (keyHistory[i] == key) return true;
+    }
+    return false;
+}
+
+void Search::checkLimits() {
+    if (limits.stopSignal != nullptr && limits.stopSignal->load(std::memory_order_relaxed)) {
+        stopRequested = true;
+    }
+    if (limits.nodes > 0 && stats->totalNodes() - startNodes >= limits.nodes) {
+        stopRequested = true;
+    }
+    if (limits.moveTimeMs > 0 && elapsedMs() >= limits.moveTimeMs) {
+        stopRequested = true;
+    }
+}
+
+int64_t Search::elapsedMs() const {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - startTime).count();
+}
+
+std::vector<PvLine> Search::collectLines() const {
+    std::vector<PvLine> lines;
+    for (int i = 0; i < completedCount; i++) {
+        const RootMove& line = completedLines[i];
+        lines.push_back({ line.score, std::vector<PackedMove>(line.pv, line.pv + line.pvLength) });
+    }
+    return lines;
+}
+
+void Search::printIteration(int depth, const SearchStats& searchStats, double branchingFactor) const {
+    const int64_t ms = elapsedMs();
+    const uint64_t nps = ms > 0 ? searchStats.totalNodes() * 1000 / static_cast<uint64_t>(ms) : 0;
+
+    for (int i = 0; i < completedCount; i++) {
+        const RootMove& line = completedLines[i];
+        std::cout << "info depth " << depth;
+        if (completedCount > 1) std::cout << " multipv " << (i + 1);
+        std::cout << " score " << formatScore(line.score);
+
+        // Telemetry is reported once per iteration, on the first line
+        if (i == 0) {
+            std::cout << " nodes " << searchStats.totalNodes()
+                      << " qnodes " << searchStats.qnodes
+                      << " nps " << nps
+                      << std::fixed << std::setprecision(1)
+                      << " tthit " << searchStats.ttHitRate() * 100.0 << "%"
+                      << " fmc " << searchStats.firstMoveCutoffRate() * 100.0 << "%"
+                      << " null " << searchStats.nullMoveSuccessRate() * 100.0 << "%"
+                      << " lmr-re " << searchStats.lmrResearchRate() * 100.0 << "%"
+                      << std::setprecision(2)
+                      << " ebf " << branchingFactor
+                      << " time " << ms
+                      << std::defaultfloat;
+        }
+
+        std::cout << " pv";
+        for (int ply = 0; ply < line.pvLength; ply++) {
+            std::cout << " " << line.pv[ply].toUci();
+        }
+        std::cout << "\n";
+    }
+}
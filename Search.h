@@ -0,0 +1,144 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "BoardState.h"
+#include "EvalCache.h"
+#include "Nnue.h"
+#include "PackedMove.h"
+#include "PawnTable.h"
+#include "SearchStats.h"
+#include "TranspositionTable.h"
+
+class TablebaseProber;
+
+struct PvLine {
+    int score = 0;
+    std::vector<PackedMove> moves;
+};
+
+struct SearchLimits {
+    int depth = 64;
+    uint64_t nodes = 0;        // 0 = unlimited
+    int64_t moveTimeMs = 0;    // 0 = unlimited
+    int multiPV = 1;           // number of best root moves to report
+    bool printIterations = false;
+    const std::atomic<bool>* stopSignal = nullptr;  // optional caller-owned stop flag
+
+    // Called after every completed iteration with the lines found so far, best first
+    std::function<void(int depth, const std::vector<PvLine>& lines)> onIteration;
+};
+
+struct SearchResult {
+    PackedMove bestMove = PackedMove::none();
+    int score = 0;
+    int depth = 0;
+    double seconds = 0.0;
+    std::vector<PackedMove> pv;
+    std::vector<PvLine> lines; // multiPV lines, best first; lines[0] matches pv
+    SearchStats stats;         // counters for this search only
+    uint64_t allocations = 0;  // operator new calls inside the search (AllocationHook builds only)
+};
+
+// Iterative-deepening principal variation search with a transposition
+// table, null-move pruning, late move reductions and quiescence search.
+// With multiPV > 1 the root keeps alpha at the K-th best score, so moves
+// outside the top K are refuted with cheap null-window searches.
+// When Nnue has an active network, positions are evaluated by it through an
+// incrementally updated accumulator stack instead of Evaluation. Static
+// evaluations are cached by Zobrist key in an EvalCache.
+// Per-ply state lives in a stack of frames allocated with the Search object
+// and root bookkeeping comes from the thread's Arena, so the search itself
+// never touches the heap. One Search object is meant to be driven by a
+// single thread. With a TablebaseProber set, positions right after a
+// capture or pawn move are scored from the endgame tables.
+class Search {
+public:
+    static constexpr int MAX_PLY = 128;
+    static constexpr int INFINITE_SCORE = 32001;
+    static constexpr int MATE_SCORE = 32000;
+    static constexpr int MATE_BOUND = MATE_SCORE - MAX_PLY;
+    static constexpr int TB_WIN_SCORE = MATE_BOUND - MAX_PLY;   // tablebase win, less the ply
+
+private:
+    // Everything one ply of the search needs, preallocated
+    struct Frame {
+        MoveList moves;
+        int scores[MoveList::CAPACITY];
+        PackedMove pv[MAX_PLY];     // triangular PV: line from this ply down
+        int pvLength;
+        PackedMove killers[2];
+        int staticEval;
+    };
+
+    struct RootMove {
+        PackedMove move;
+        int score;
+        int previousScore;
+        int pvLength;
+        PackedMove pv[MAX_PLY];
+    };
+
+    TranspositionTable& table;
+    BoardState board;
+    SearchLimits limits;
+    SearchStats* stats;
+    PawnTable* pawnTable;
+    std::unique_ptr<NnueEvaluator> nnue;   // set while Nnue has an active network
+    EvalCache* sharedEvalCache;            // nullptr = the thread's own cache
+    EvalCache* evalCache;
+    const NnueNetwork* cachedNetwork;      // evaluator the cache contents came from
+    TablebaseProber* tablebases;           // nullptr = no tablebase probing
+    std::atomic<bool> stopRequested;
+    std::chrono::steady_clock::time_point startTime;
+    uint64_t startNodes;        // thread's node counter when run() began
+
+    std::unique_ptr<Frame[]> frames;
+    int history[12][64];
+    uint64_t keyHistory[MAX_PLY + 1];
+
+    // Arena storage, valid for the current run()
+    RootMove* rootMoves;        // ordered by the previous iteration
+    int rootMoveCount;
+    RootMove* completedLines;   // lines of the last finished iteration, best first
+    int completedCount;
+    int* topScores;             // scratch for searchRoot
+
+    // Board make/unmake that keeps the NNUE accumulators in step
+    void makeMove(PackedMove move, UndoInfo& undo);
+    void unmakeMove(PackedMove move, const UndoInfo& undo);
+    void makeNullMove(UndoInfo& undo);
+    void unmakeNullMove(const UndoInfo& undo);
+    int evaluate();
+
+    int alphaBeta(int alpha, int beta, int depth, int ply, bool allowNull);
+    void searchRoot(int depth, int lineCount);
+    int searchRootWindow(int previousScore, int depth);
+    int quiescence(int alpha, int beta, int ply);
+    void scoreMoves(const MoveList& moves, int* scores, PackedMove ttMove, int ply) const;
+    static PackedMove pickNextMove(MoveList& moves, int* scores, int index);
+    static void sortRootMoves(RootMove* moves, int count);
+    void updatePv(int ply, PackedMove move);
+    bool isRepetition(int ply) const;
+    void checkLimits();
+    int64_t elapsedMs() const;
+    std::vector<PvLine> collectLines() const;
+    void printIteration(int depth, const SearchStats& searchStats, double branchingFactor) const;
+
+public:
+    explicit Search(TranspositionTable& tt);
+
+    SearchResult run(const BoardState& root, const SearchLimits& searchLimits);
+    // Share one evaluation cache between searches; nullptr reverts to EvalCache::local()
+    void setEvalCache(EvalCache* cache) { sharedEvalCache = cache; }
+    // Probe endgame tables during the search; the prober may be shared between threads
+    void setTablebases(TablebaseProber* prober) { tablebases = prober; }
+    void stop();
+
+    static bool isMateScore(int score);
+    static std::string formatScore(int score);
+};
@@ -0,0 +1,142 @@
+#include "SearchStats.h"
+#include <mutex>
+#include <sstream>
+
+namespace {
+    std::mutex retiredMutex;
+    SearchStats retiredTotals;
+
+    // The thread's counters, folded into the retired totals when it exits
+    struct ThreadBlock {
+        SearchStats stats;
+
+        ~ThreadBlock() {
+            std::lock_guard<std::mutex> lock(retiredMutex);
+            retiredTotals.add(stats);
+        }
+    };
+
+    double ratio(uint64_t part, uint64_t whole) {
+        return whole == 0 ? 0.0 : static_cast<double>(part) / static_cast<double>(whole);
+    }
+}
+
+void SearchStats::reset() {
+    *this = SearchStats();
+}
+
+void SearchStats::add(const SearchStats& other) {
+    nodes += other.nodes;
+    qnodes += other.qnodes;
+    ttProbes += other.ttProbes;
+    ttHits += other.ttHits;
+    betaCutoffs += other.betaCutoffs;
+    for (int i = 0; i < CUTOFF_BUCKETS; i++) {
+        cutoffsByMoveIndex[i] += other.cutoffsByMoveIndex[i];
+    }
+    nullMoveTries += other.nullMoveTries;
+    nullMoveCutoffs += other.nullMoveCutoffs;
+    lmrReductions += other.lmrReductions;
+    lmrResearches += other.lmrResearches;
+    pawnProbes += other.pawnProbes;
+    pawnHits += other.pawnHits;
+    evalProbes += other.evalProbes;
+    evalHits += other.evalHits;
+    tbProbes += other.tbProbes;
+    tbHits += other.tbHits;
+}
+
+SearchStats SearchStats::since(const SearchStats& earlier) const {
+    SearchStats delta;
+    delta.nodes = nodes - earlier.nodes;
+    delta.qnodes = qnodes - earlier.qnodes;
+    delta.ttProbes = ttProbes - earlier.ttProbes;
+    delta.ttHits = ttHits - earlier.ttHits;
+    delta.betaCutoffs = betaCutoffs - earlier.betaCutoffs;
+    for (int i = 0; i < CUTOFF_BUCKETS; i++) {
+        delta.cutoffsByMoveIndex[i] = cutoffsByMoveIndex[i] - earlier.cutoffsByMoveIndex[i];
+    }
+    delta.nullMoveTries = nullMoveTries - earlier.nullMoveTries;
+    delta.nullMoveCutoffs = nullMoveCutoffs - earlier.nullMoveCutoffs;
+    delta.lmrReductions = lmrReductions - earlier.lmrReductions;
+    delta.lmrResearches = lmrResearches - earlier.lmrResearches;
+    delta.pawnProbes = pawnProbes - earlier.pawnProbes;
+    delta.pawnHits = pawnHits - earlier.pawnHits;
+    delta.evalProbes = evalProbes - earlier.evalProbes;
+    delta.evalHits = evalHits - earlier.evalHits;
+    delta.tbProbes = tbProbes - earlier.tbProbes;
+    delta.tbHits = tbHits - earlier.tbHits;
+    return delta;
+}
+
+double SearchStats::ttHitRate() const {
+    return ratio(ttHits, ttProbes);
+}
+
+double SearchStats::pawnHitRate() const {
+    return ratio(pawnHits, pawnProbes);
+}
+
+double SearchStats::evalHitRate() const {
+    return ratio(evalHits, evalProbes);
+}
+
+double SearchStats::tbHitRate() const {
+    return ratio(tbHits, tbProbes);
+}
+
+double SearchStats::firstMoveCutoffRate() const {
+    return ratio(cutoffsByMoveIndex[0], betaCutoffs);
+}
+
+double SearchStats::nullMoveSuccessRate() const {
+    return ratio(nullMoveCutoffs, nullMoveTries);
+}
+
+double SearchStats::lmrResearchRate() const {
+    return ratio(lmrResearches, lmrReductions);
+}
+
+std::string SearchStats::toJson() const {
+    std::ostringstream json;
+    json << "{\"nodes\":" << nodes
+         << ",\"qnodes\":" << qnodes
+         << ",\"ttProbes\":" << ttProbes
+         << ",\"ttHits\":" << ttHits
+         << ",\"ttHitRate\":" << ttHitRate()
+         << ",\"betaCutoffs\":" << betaCutoffs
+         << ",\"cutoffsByMoveIndex\":[";
+    for (int i = 0; i < CUTOFF_BUCKETS; i++) {
+        json << (i > 0 ? "," : "") << cutoffsByMoveIndex[i];
+    }
+    json << "],\"firstMoveCutoffRate\":" << firstMoveCutoffRate()
+         << ",\"nullMoveTries\":" << nullMoveTries
+         << ",\"nullMoveCutoffs\":" << nullMoveCutoffs
+         << ",\"lmrReductions\":" << lmrReductions
+         << ",\"lmrResearches\":" << lmrResearches
+         << ",\"pawnProbes\":" << pawnProbes
+         << ",\"pawnHits\":" << pawnHits
+         << ",\"pawnHitRate\":" << pawnHitRate()
+         << ",\"evalProbes\":" << evalProbes
+         << ",\"evalHits\":" << evalHits
+         << ",\"evalHitRate\":" << evalHitRate()
+         << ",\"tbProbes\":" << tbProbes
+         << ",\"tbHits\":" << tbHits
+         << "}";
+    return json.str();
+}
+
+SearchStats& SearchStats::local() {
+    thread_local ThreadBlock block;
+    return block.stats;
+}
+
+SearchStats SearchStats::aggregate() {
+    SearchStats total;
+    {
+        std::lock_guard<std::mutex> lock(retiredMutex);
+        total = retiredTotals;
+    }
+    total.add(local());
+    return total;
+}
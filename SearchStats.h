@@ -0,0 +1,53 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+// Search telemetry counters. Each thread increments its own block (plain
+// integers, no atomics) and folds it into a shared total when it exits;
+// aggregate() sums that total, so it sees a search thread once joined.
+struct SearchStats {
+    static constexpr int CUTOFF_BUCKETS = 8;  // move index 0..6, last bucket is 7+
+
+    uint64_t nodes = 0;
+    uint64_t qnodes = 0;
+    uint64_t ttProbes = 0;
+    uint64_t ttHits = 0;
+    uint64_t betaCutoffs = 0;
+    uint64_t cutoffsByMoveIndex[CUTOFF_BUCKETS] = {};
+    uint64_t nullMoveTries = 0;
+    uint64_t nullMoveCutoffs = 0;
+    uint64_t lmrReductions = 0;
+    uint64_t lmrResearches = 0;
+    uint64_t pawnProbes = 0;
+    uint64_t pawnHits = 0;
+    uint64_t evalProbes = 0;
+    uint64_t evalHits = 0;
+    uint64_t tbProbes = 0;
+    uint64_t tbHits = 0;
+
+    void reset();
+    void add(const SearchStats& other);
+    SearchStats since(const SearchStats& earlier) const;
+
+    void recordCutoff(int moveIndex) {
+        betaCutoffs++;
+        cutoffsByMoveIndex[moveIndex < CUTOFF_BUCKETS - 1 ? moveIndex : CUTOFF_BUCKETS - 1]++;
+    }
+
+    uint64_t totalNodes() const { return nodes + qnodes; }
+    double ttHitRate() const;
+    double pawnHitRate() const;
+    double evalHitRate() const;
+    double tbHitRate() const;
+    double firstMoveCutoffRate() const;
+    double nullMoveSuccessRate() const;
+    double lmrResearchRate() const;
+
+    std::string toJson() const;
+
+    // Counters of the calling thread
+    static SearchStats& local();
+    // Sum over threads that have exited plus the calling thread. Other live
+    // threads are left out: reading their counters mid-search would race.
+    static SearchStats aggregate();
+};
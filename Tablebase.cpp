@@ -0,0 +1,344 @@
+#include "Tablebase.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include "Bitboard.h"
+#include "BoardState.h"
+
+namespace {
+    using Bitboards::colOf;
+    using Bitboards::rowOf;
+
+    constexpr char PIECE_LETTERS[6] = { 'K', 'Q', 'R', 'B', 'N', 'P' };   // PieceType order
+    constexpr int STRENGTH[6] = { 0, 9, 5, 3, 3, 1 };
+    constexpr int KING_PAIRS = 462;
+
+    enum BlockMethod : uint8_t {
+        RAW8 = 0,
+        RAW16 = 1,
+        RUNS = 2,
+    };
+
+    int rankOf(int square) { return 7 - rowOf(square); }
+
+    // Positive above the a1-h8 diagonal, 0 on it
+    int diagonalSide(int square) { return rankOf(square) - colOf(square); }
+
+    // Mirror in the a1-h8 diagonal
+    int transpose(int square) { return (7 - colOf(square)) * 8 + (7 - rowOf(square)); }
+
+    bool kingsTouch(int a, int b) {
+        return std::max(std::abs(rowOf(a) - rowOf(b)), std::abs(colOf(a) - colOf(b))) <= 1;
+    }
+
+    // White king in the a1-d1-d4 triangle, Black king anywhere not touching it,
+    // and on or below the diagonal when the White king is on it
+    struct KingPairs {
+        int16_t index[64][64];
+        int8_t whiteKing[KING_PAIRS];
+        int8_t blackKing[KING_PAIRS];
+    };
+
+    KingPairs buildKingPairs() {
+        KingPairs pairs;
+        std::fill(&pairs.index[0][0], &pairs.index[0][0] + 64 * 64, static_cast<int16_t>(-1));
+        int count = 0;
+        for (int whiteKing = 0; whiteKing < 64; whiteKing++) {
+            if (colOf(whiteKing) > 3 || diagonalSide(whiteKing) > 0) continue;
+            for (int blackKing = 0; blackKing < 64; blackKing++) {
+                if (kingsTouch(whiteKing, blackKing)) continue;
+                if (diagonalSide(whiteKing) == 0 && diagonalSide(blackKing) > 0) continue;
+                pairs.index[whiteKing][blackKing] = static_cast<int16_t>(count);
+                pairs.whiteKing[count] = static_cast<int8_t>(whiteKing);
+                pairs.blackKing[count] = static_cast<int8_t>(blackKing);
+                count++;
+            }
+        }
+        if (count != KING_PAIRS) throw std::logic_error("Tablebase king pair count");
+        return pairs;
+    }
+
+    const KingPairs& kingPairs() {
+        static const KingPairs pairs = buildKingPairs();
+        return pairs;
+    }
+
+    // Piece types of one side in PieceType order; throws unless it holds exactly one king
+    std::vector<int> parseSide(const std::string& text, const std::string& signature) {
+        std::vector<int> types;
+        for (char letter : text) {
+            const char* found = std::find(std::begin(PIECE_LETTERS), std::end(PIECE_LETTERS), letter);
+            if (found == std::end(PIECE_LETTERS)) {
+                throw std::runtime_error("Bad tablebase signature: " + signature);
+            }
+            types.push_back(static_cast<int>(found - PIECE_LETTERS));
+        }
+        std::sort(types.begin(), types.end());
+        if (std::count(types.begin(), types.end(), 0) != 1) {
+            throw std::runtime_error("Bad tablebase signature (one king per side): " + signature);
+        }
+        return types;
+    }
+
+    void splitSignature(const std::string& signature, std::vector<int>& white, std::vector<int>& black) {
+        const size_t separator = signature.find('v');
+        if (separator == std::string::npos) {
+            throw std::runtime_error("Bad tablebase signature (expected e.g. KRvK): " + signature);
+        }
+        white = parseSide(signature.substr(0, separator), signature);
+        black = parseSide(signature.substr(separator + 1), signature);
+        if (white.size() + black.size() > static_cast<size_t>(Tablebase::MAX_PIECES)) {
+            throw std::runtime_error("Tablebases are limited to " + std::to_string(Tablebase::MAX_PIECES) +
+                                     " pieces: " + signature);
+        }
+    }
+
+    std::string sideText(const std::vector<int>& types) {
+        std::string text;
+        for (int type : types) text += PIECE_LETTERS[type];
+        return text;
+    }
+
+    void writeVarint(uint32_t value, std::vector<uint8_t>& out) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    bool readVarint(const uint8_t*& data, const uint8_t* end, uint32_t& value) {
+        value = 0;
+        for (int shift = 0; shift < 32 && data < end; shift += 7) {
+            const uint8_t byte = *data++;
+            value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) return true;
+        }
+        return false;
+    }
+}
+
+const Tablebase::FileHeader& Tablebase::readHeader(const uint8_t* data, size_t size, const std::string& path) {
+    if (size < sizeof(FileHeader)) throw std::runtime_error("Tablebase file too small: " + path);
+    const auto& header = *reinterpret_cast<const FileHeader*>(data);
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION) {
+        throw std::runtime_error("Not a tablebase file (or wrong version): " + path);
+    }
+    const uint64_t offsetBytes = (2 * header.blockCount + 1) * sizeof(uint64_t);
+    if (header.blockEntries != BLOCK_ENTRIES || header.offsetTable > size || offsetBytes > size - header.offsetTable ||
+        header.entryCount > header.blockCount * header.blockEntries) {
+        throw std::runtime_error("Corrupt tablebase header: " + path);
+    }
+    return header;
+}
+
+void Tablebase::encodeBlock(const uint16_t* values, size_t count, std::vector<uint8_t>& out) {
+    std::vector<uint8_t> runs;
+    uint16_t largest = 0;
+    for (size_t i = 0; i < count;) {
+        size_t end = i + 1;
+        while (end < count && values[end] == values[i]) end++;
+        writeVarint(static_cast<uint32_t>(end - i), runs);
+        writeVarint(values[i], runs);
+        largest = std::max(largest, values[i]);
+        i = end;
+    }
+
+    const size_t rawSize = largest < 256 ? count : 2 * count;
+    if (runs.size() < rawSize) {
+        out.push_back(RUNS);
+        out.insert(out.end(), runs.begin(), runs.end());
+    } else if (largest < 256) {
+        out.push_back(RAW8);
+        for (size_t i = 0; i < count; i++) out.push_back(static_cast<uint8_t>(values[i]));
+    } else {
+        out.push_back(RAW16);
+        for (size_t i = 0; i < count; i++) {
+            out.push_back(static_cast<uint8_t>(values[i]));
+            out.push_back(static_cast<uint8_t>(values[i] >> 8));
+        }
+    }
+}
+
+bool Tablebase::decodeBlock(const uint8_t* data, size_t size, uint16_t* values, size_t count) {
+    if (size == 0) return false;
+    const uint8_t* end = data + size;
+    switch (*data++) {
+        case RAW8:
+            if (size != count + 1) return false;
+            for (size_t i = 0; i < count; i++) values[i] = data[i];
+            return true;
+        case RAW16:
+            if (size != 2 * count + 1) return false;
+            for (size_t i = 0; i < count; i++) values[i] = static_cast<uint16_t>(data[2 * i] | (data[2 * i + 1] << 8));
+            return true;
+        case RUNS: {
+            size_t filled = 0;
+            while (filled < count) {
+                uint32_t length, value;
+                if (!readVarint(data, end, length) || !readVarint(data, end, value)) return false;
+                if (length == 0 || length > count - filled || value > 0xFFFF) return false;
+                std::fill(values + filled, values + filled + length, static_cast<uint16_t>(value));
+                filled += length;
+            }
+            return data == end;
+        }
+        default:
+            return false;
+    }
+}
+
+std::string Tablebase::canonicalSignature(const std::string& signature, bool& colorsSwapped) {
+    std::vector<int> white, black;
+    splitSignature(signature, white, black);
+
+    int whiteStrength = 0, blackStrength = 0;
+    for (int type : white) whiteStrength += STRENGTH[type];
+    for (int type : black) blackStrength += STRENGTH[type];
+
+    // Ties go to the side with more pieces, then to the more valuable piece list
+    colorsSwapped = blackStrength != whiteStrength ? blackStrength > whiteStrength
+                  : black.size() != white.size() ? black.size() > white.size()
+                  : black < white;
+    if (colorsSwapped) std::swap(white, black);
+    return sideText(white) + "v" + sideText(black);
+}
+
+TablebaseLayout::TablebaseLayout(const std::string& text)
+    : signature(text), pieces{}, pieceCount(0), pawnCount(0), leadSlot(-1), sliceSize(1), sliceCount(1) {
+    std::vector<int> white, black;
+    splitSignature(signature, white, black);
+
+    pieces[pieceCount++] = makePieceCode(PieceColor::WHITE, PieceType::KING);
+    pieces[pieceCount++] = makePieceCode(PieceColor::BLACK, PieceType::KING);
+    for (PieceColor color : { PieceColor::WHITE, PieceColor::BLACK }) {
+        for (int type : (color == PieceColor::WHITE ? white : black)) {
+            if (type == 0) continue;
+            if (type == static_cast<int>(PieceType::PAWN) && pawnCount++ == 0) leadSlot = pieceCount;
+            pieces[pieceCount++] = makePieceCode(color, static_cast<PieceType>(type));
+        }
+    }
+
+    if (pawnCount == 0) {
+        sliceSize = KING_PAIRS;
+        for (int slot = 2; slot < pieceCount; slot++) sliceSize *= 64;
+        return;
+    }
+
+    for (int slot = 0; slot < pieceCount - pawnCount; slot++) sliceSize *= 64;
+
+    // Enumerate pawn configurations and order them by total advancement, most advanced first
+    uint64_t codeCount = 24;
+    for (int i = 1; i < pawnCount; i++) codeCount *= 48;
+    sliceOfPawns.assign(codeCount, -1);
+
+    std::vector<std::pair<int, uint64_t>> order;
+    std::vector<Squares> placements(codeCount);
+    for (uint64_t code = 0; code < codeCount; code++) {
+        Squares& squares = placements[code];
+        uint64_t rest = code;
+        int advancement = 0;
+        Bitboard used = 0;
+        bool overlap = false;
+        for (int slot = pieceCount - 1; slot >= 2; slot--) {
+            if (pieces[slot] % 6 != static_cast<int>(PieceType::PAWN)) continue;
+            const int square = slot == leadSlot
+                ? Bitboards::makeSquare(static_cast<int>(rest / 4) + 1, static_cast<int>(rest % 4))
+                : static_cast<int>(rest % 48) + 8;
+            rest /= 48;
+            squares[slot] = square;
+            overlap |= (used & Bitboards::squareBit(square)) != 0;
+            used |= Bitboards::squareBit(square);
+            advancement += pieces[slot] < 6 ? 6 - rowOf(square) : rowOf(square) - 1;
+        }
+        if (!overlap) order.emplace_back(-advancement, code);
+    }
+    std::sort(order.begin(), order.end());
+
+    for (const auto& entry : order) {
+        sliceOfPawns[entry.second] = static_cast<int32_t>(pawnsOfSlice.size());
+        pawnsOfSlice.push_back(placements[entry.second]);
+    }
+    sliceCount = pawnsOfSlice.size();
+}
+
+uint64_t TablebaseLayout::pawnCode(const Squares& squares) const {
+    // First pawn (lead, files a-d) is the most significant digit
+    uint64_t code = static_cast<uint64_t>((rowOf(squares[leadSlot]) - 1) * 4 + colOf(squares[leadSlot]));
+    for (int slot = leadSlot + 1; slot < pieceCount; slot++) {
+        if (pieces[slot] % 6 == static_cast<int>(PieceType::PAWN)) code = code * 48 + (squares[slot] - 8);
+    }
+    return code;
+}
+
+void TablebaseLayout::normalize(Squares& squares) const {
+    auto transform = [&](auto mapping) {
+        for (int slot = 0; slot < pieceCount; slot++) squares[slot] = mapping(squares[slot]);
+    };
+
+    if (pawnCount > 0) {
+        if (colOf(squares[leadSlot]) >= 4) transform([](int square) { return square ^ 7; });
+        return;
+    }
+
+    if (colOf(squares[0]) >= 4) transform([](int square) { return square ^ 7; });
+    if (rankOf(squares[0]) >= 4) transform([](int square) { return square ^ 56; });
+    if (diagonalSide(squares[0]) > 0) {
+        transform(transpose);
+    } else if (diagonalSide(squares[0]) == 0) {
+        // King on the diagonal: the first piece off it decides
+        for (int slot = 1; slot < pieceCount; slot++) {
+            const int side = diagonalSide(squares[slot]);
+            if (side == 0) continue;
+            if (side > 0) transform(transpose);
+            break;
+        }
+    }
+}
+
+uint64_t TablebaseLayout::index(Squares& squares) const {
+    normalize(squares);
+    uint64_t within = 0;
+    if (pawnCount == 0) {
+        within = static_cast<uint64_t>(kingPairs().index[squares[0]][squares[1]]);
+        for (int slot = 2; slot < pieceCount; slot++) within = within * 64 + squares[slot];
+        return within;
+    }
+    for (int slot = 0; slot < pieceCount; slot++) {
+        if (pieces[slot] % 6 != static_cast<int>(PieceType::PAWN)) within = within * 64 + squares[slot];
+    }
+    return static_cast<uint64_t>(sliceOfPawns[pawnCode(squares)]) * sliceSize + within;
+}
+
+bool TablebaseLayout::decode(uint64_t index, Squares& squares) const {
+    uint64_t rest = index % sliceSize;
+    if (pawnCount > 0) squares = pawnsOfSlice[index / sliceSize];
+
+    for (int slot = pieceCount - 1; slot >= (pawnCount == 0 ? 2 : 0); slot--) {
+        if (pieces[slot] % 6 == static_cast<int>(PieceType::PAWN)) continue;
+        squares[slot] = static_cast<int>(rest % 64);
+        rest /= 64;
+    }
+    if (pawnCount == 0) {
+        squares[0] = kingPairs().whiteKing[rest];
+        squares[1] = kingPairs().blackKing[rest];
+    }
+
+    Bitboard used = 0;
+    for (int slot = 0; slot < pieceCount; slot++) {
+        const Bitboard bit = Bitboards::squareBit(squares[slot]);
+        if (used & bit) return false;
+        used |= bit;
+    }
+    if (kingsTouch(squares[0], squares[1])) return false;
+
+    // Both kings on the diagonal: only the copy with the first off-diagonal piece below it is used
+    if (pawnCount == 0 && diagonalSide(squares[0]) == 0 && diagonalSide(squares[1]) == 0) {
+        for (int slot = 2; slot < pieceCount; slot++) {
+            const int side = diagonalSide(squares[slot]);
+            if (side != 0) return side < 0;
+        }
+    }
+    return true;
+}
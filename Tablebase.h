@@ -0,0 +1,99 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Endgame tablebases produced by TablebaseGenerator (command tbgen). A table
+// covers one material signature such as "KRPvKR", stronger side first as
+// White, and stores WDL and DTZ for both sides to move.
+//
+// File layout (little endian, usable straight from a memory mapping):
+//   FileHeader                       64 bytes
+//   block data                       BLOCK_ENTRIES entries per block, see encodeBlock
+//   uint64_t offsets[2 * blockCount + 1]
+// Block b for side to move s is offsets[2 * b + s] .. offsets[2 * b + s + 1].
+// Positions that cannot occur (overlapping pieces, side not to move in
+// check) hold whatever value compresses best and must not be probed.
+namespace Tablebase {
+    constexpr int MAX_PIECES = 5;                  // kings included
+    constexpr uint32_t BLOCK_ENTRIES = 4096;
+    constexpr uint32_t VERSION = 1;
+    constexpr char MAGIC[8] = { 'S', 'C', 'H', 'T', 'B', 'L', 'B', '1' };
+    constexpr const char* FILE_EXTENSION = ".stb";
+
+    // Entry values from the side to move: 0 is a draw, 2 * dtz a win and
+    // 2 * dtz + 1 a loss. DTZ counts plies to the next capture, pawn move or
+    // mate; a mated side to move is lossValue(0).
+    constexpr uint16_t DRAW_VALUE = 0;
+    constexpr uint16_t winValue(int dtz) { return static_cast<uint16_t>(2 * dtz); }
+    constexpr uint16_t lossValue(int dtz) { return static_cast<uint16_t>(2 * dtz + 1); }
+    constexpr int wdlOf(uint16_t value) { return value == 0 ? 0 : (value & 1) ? -1 : 1; }
+    constexpr int dtzOf(uint16_t value) { return value >> 1; }
+
+    struct FileHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t blockEntries;
+        char signature[16];        // NUL padded
+        uint64_t entryCount;       // per side to move
+        uint64_t blockCount;       // per side to move
+        uint64_t offsetTable;      // file offset of the block offsets
+        uint32_t maxDtz;
+        uint32_t reserved;
+    };
+    static_assert(sizeof(FileHeader) == 64, "tablebase header must stay 64 bytes");
+
+    // Validated header of a mapped table file; throws std::runtime_error
+    const FileHeader& readHeader(const uint8_t* data, size_t size, const std::string& path);
+
+    // Appends one compressed block (raw 8-bit, raw 16-bit or run-length, whichever is smallest)
+    void encodeBlock(const uint16_t* values, size_t count, std::vector<uint8_t>& out);
+    // Decodes a block written by encodeBlock; false when the data is malformed
+    bool decodeBlock(const uint8_t* data, size_t size, uint16_t* values, size_t count);
+
+    // Signature with the stronger side first ("KvKR" -> "KRvK"); colorsSwapped
+    // reports whether the sides were exchanged. Throws on malformed signatures.
+    std::string canonicalSignature(const std::string& signature, bool& colorsSwapped);
+}
+
+// Perfect index of one material signature with symmetry reduction.
+// Without pawns the kings use the 462 non-adjacent placements with the
+// White king in the a1-d1-d4 triangle; with pawns the first pawn is
+// mirrored onto files a-d. Pawn configurations form slices ordered by
+// pawn advancement, so a pawn push always leads into an earlier slice.
+class TablebaseLayout {
+public:
+    using Squares = std::array<int, Tablebase::MAX_PIECES>;
+
+private:
+    std::string signature;
+    Squares pieces;            // piece codes: White king, Black king, White's others, Black's others
+    int pieceCount;
+    int pawnCount;
+    int leadSlot;              // first pawn, -1 without pawns
+    uint64_t sliceSize;
+    uint64_t sliceCount;
+    std::vector<int32_t> sliceOfPawns;       // pawn code -> slice, -1 when pawns overlap
+    std::vector<Squares> pawnsOfSlice;       // pawn squares in piece order, other entries unused
+
+    uint64_t pawnCode(const Squares& squares) const;
+    void normalize(Squares& squares) const;
+
+public:
+    explicit TablebaseLayout(const std::string& signature);
+
+    const std::string& getSignature() const { return signature; }
+    int getPieceCount() const { return pieceCount; }
+    int getPiece(int slot) const { return pieces[slot]; }
+    bool hasPawns() const { return pawnCount > 0; }
+    uint64_t getEntryCount() const { return sliceSize * sliceCount; }
+    uint64_t getSliceSize() const { return sliceSize; }
+    uint64_t getSliceCount() const { return sliceCount; }
+
+    // Index of a placement given in piece order; squares are normalized in place
+    uint64_t index(Squares& squares) const;
+    // Placement of an index; false when the slot is not a canonical, non-overlapping placement
+    bool decode(uint64_t index, Squares& squares) const;
+};
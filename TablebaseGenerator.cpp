@@ -0,0 +1,619 @@
+#include "TablebaseGenerator.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include "Bitboard.h"
+#include "BoardState.h"
+#include "MappedFile.h"
+#include "Tablebase.h"
+#include "WorkStealingPool.h"
+
+namespace {
+    using Squares = TablebaseLayout::Squares;
+    using Tablebase::MAX_PIECES;
+
+    constexpr uint16_t ILLEGAL = 0xFFFF;        // working value of positions that cannot occur
+    constexpr uint8_t CANNOT_LOSE = 0x80;       // counter flag: a capture or pawn move draws
+    constexpr uint64_t CHUNK_ENTRIES = 1 << 16;
+    constexpr int MAX_SUCCESSORS = 128;
+    constexpr char PIECE_LETTERS[6] = { 'K', 'Q', 'R', 'B', 'N', 'P' };   // PieceType order
+    constexpr int PAWN = static_cast<int>(PieceType::PAWN);
+
+    int colorOf(int piece) { return piece / 6; }
+    int typeOf(int piece) { return piece % 6; }
+
+    // Finished table kept for lookups: 2 bits per position and side, 1 = win, 2 = loss
+    struct SolvedTable {
+        TablebaseLayout layout;
+        std::vector<uint64_t> wdl[2];
+
+        explicit SolvedTable(const std::string& signature) : layout(signature) {
+            for (auto& bits : wdl) bits.assign((layout.getEntryCount() + 31) / 32, 0);
+        }
+
+        // +1 win, 0 draw, -1 loss for the side to move
+        int probe(int side, uint64_t index) const {
+            const uint64_t code = (wdl[side][index / 32] >> (2 * (index % 32))) & 3;
+            return code == 1 ? 1 : code == 2 ? -1 : 0;
+        }
+
+        // Callers own whole 64-bit words (chunks are multiples of 32 entries)
+        void store(int side, uint64_t index, int result) {
+            const uint64_t code = result > 0 ? 1 : result < 0 ? 2 : 0;
+            wdl[side][index / 32] |= code << (2 * (index % 32));
+        }
+    };
+
+    // Where a capture, promotion or pawn push leads: the table and where each of this
+    // table's slots goes in it (-1 for the captured piece)
+    struct Conversion {
+        const SolvedTable* table = nullptr;
+        bool swapped = false;
+        std::array<int, MAX_PIECES> targetSlot{};
+
+        // Result for the side to move after the move, from that side's point of view
+        int probe(const Squares& squares, int sideToMove) const {
+            Squares target{};
+            for (int slot = 0; slot < MAX_PIECES; slot++) {
+                if (targetSlot[slot] >= 0) target[targetSlot[slot]] = swapped ? squares[slot] ^ 56 : squares[slot];
+            }
+            return table->probe(swapped ? 1 - sideToMove : sideToMove, table->layout.index(target));
+        }
+    };
+
+    struct Conversions {
+        Conversion push;
+        Conversion capture[MAX_PIECES];                        // by captured slot
+        Conversion promotion[MAX_PIECES][4][MAX_PIECES + 1];   // pawn slot, Q/R/B/N, captured slot + 1
+    };
+
+    std::string materialSignature(const std::vector<int>& pieces) {
+        std::string sides[2];
+        for (int type = 0; type < 6; type++) {
+            for (int piece : pieces) {
+                if (typeOf(piece) == type) sides[colorOf(piece)] += PIECE_LETTERS[type];
+            }
+        }
+        return sides[0] + "v" + sides[1];
+    }
+
+    std::string tablePath(const std::string& directory, const std::string& signature) {
+        return (std::filesystem::path(directory) / (signature + Tablebase::FILE_EXTENSION)).string();
+    }
+
+    // Occupancy and attack tests over a placement; captured pieces have square -1
+    struct Placement {
+        const TablebaseLayout& layout;
+        const Squares& squares;
+        Bitboard byColor[2] = { 0, 0 };
+
+        Placement(const TablebaseLayout& tableLayout, const Squares& pieceSquares)
+            : layout(tableLayout), squares(pieceSquares) {
+            for (int slot = 0; slot < layout.getPieceCount(); slot++) {
+                if (squares[slot] >= 0) byColor[colorOf(layout.getPiece(slot))] |= Bitboards::squareBit(squares[slot]);
+            }
+        }
+
+        Bitboard occupied() const { return byColor[0] | byColor[1]; }
+
+        int slotAt(int square) const {
+            for (int slot = 0; slot < layout.getPieceCount(); slot++) {
+                if (squares[slot] == square) return slot;
+            }
+            return -1;
+        }
+
+        bool attacked(int square, int attacker) const {
+            const Bitboard target = Bitboards::squareBit(square);
+            for (int slot = 0; slot < layout.getPieceCount(); slot++) {
+                const int piece = layout.getPiece(slot);
+                if (squares[slot] < 0 || colorOf(piece) != attacker) continue;
+                const Bitboard attacks = typeOf(piece) == PAWN
+                    ? Bitboards::pawnAttacks(static_cast<PieceColor>(attacker), squares[slot])
+                    : Bitboards::pieceAttacks(static_cast<PieceType>(typeOf(piece)), squares[slot], occupied());
+                if (attacks & target) return true;
+            }
+            return false;
+        }
+
+        // Kings are always slots 0 (White) and 1 (Black)
+        bool kingAttacked(int color) const { return attacked(squares[color], 1 - color); }
+    };
+
+    // Everything the initial classification needs to know about one side's moves
+    struct MoveSummary {
+        int legalMoves = 0;
+        int successorCount = 0;
+        uint32_t successors[MAX_SUCCESSORS];   // distinct quiet successors within the slice
+        bool winningConversion = false;
+        bool drawingConversion = false;
+    };
+
+    void addSuccessor(MoveSummary& summary, uint32_t successor) {
+        if (std::find(summary.successors, summary.successors + summary.successorCount, successor) ==
+            summary.successors + summary.successorCount) {
+            summary.successors[summary.successorCount++] = successor;
+        }
+    }
+
+    // Per-slice working arrays, shared by the pool workers
+    struct SliceState {
+        uint64_t size;
+        uint64_t words;
+        std::unique_ptr<std::atomic<uint16_t>[]> values[2];
+        std::unique_ptr<std::atomic<uint8_t>[]> counters[2];
+        std::unique_ptr<std::atomic<uint64_t>[]> current[2];   // decided at the ply being propagated
+        std::unique_ptr<std::atomic<uint64_t>[]> next[2];      // decided at the following ply
+        std::atomic<uint64_t> nextCount{ 0 };
+
+        explicit SliceState(uint64_t entries) : size(entries), words((entries + 63) / 64) {
+            for (int side = 0; side < 2; side++) {
+                values[side] = std::make_unique<std::atomic<uint16_t>[]>(size);
+                counters[side] = std::make_unique<std::atomic<uint8_t>[]>(size);
+                current[side] = std::make_unique<std::atomic<uint64_t>[]>(words);
+                next[side] = std::make_unique<std::atomic<uint64_t>[]>(words);
+            }
+        }
+
+        void mark(std::unique_ptr<std::atomic<uint64_t>[]>* frontier, int side, uint64_t entry) {
+            frontier[side][entry / 64].fetch_or(1ULL << (entry % 64), std::memory_order_relaxed);
+        }
+    };
+
+    class Generator {
+    private:
+        TablebaseGenerator::Options options;
+        WorkStealingPool pool;
+        std::map<std::string, std::unique_ptr<SolvedTable>> tables;
+
+        Conversion makeConversion(const TablebaseLayout& layout, int removedSlot, int changedSlot, int newPiece);
+        void load(SolvedTable& table, const std::string& path);
+        void solve(SolvedTable& table, const std::string& path);
+
+        template <typename Body>
+        void parallelFor(uint64_t count, Body body) {
+            for (uint64_t begin = 0; begin < count; begin += CHUNK_ENTRIES) {
+                const uint64_t end = std::min(count, begin + CHUNK_ENTRIES);
+                pool.submit([&body, begin, end](int) { body(begin, end); });
+            }
+            pool.wait();
+        }
+
+    public:
+        explicit Generator(const TablebaseGenerator::Options& generatorOptions)
+            : options(generatorOptions), pool(generatorOptions.threads) {}
+
+        const SolvedTable& require(const std::string& signature);
+    };
+
+    Conversion Generator::makeConversion(const TablebaseLayout& layout, int removedSlot, int changedSlot, int newPiece) {
+        std::vector<int> after;
+        for (int slot = 0; slot < layout.getPieceCount(); slot++) {
+            if (slot != removedSlot) after.push_back(slot == changedSlot ? newPiece : layout.getPiece(slot));
+        }
+        Conversion conversion;
+        const std::string signature = Tablebase::canonicalSignature(materialSignature(after), conversion.swapped);
+        conversion.table = &require(signature);
+
+        // Give each piece the first free slot with the same (possibly color-swapped) code
+        const TablebaseLayout& target = conversion.table->layout;
+        std::array<bool, MAX_PIECES> used{};
+        conversion.targetSlot.fill(-1);
+        for (int slot = 0; slot < layout.getPieceCount(); slot++) {
+            if (slot == removedSlot) continue;
+            int piece = slot == changedSlot ? newPiece : layout.getPiece(slot);
+            if (conversion.swapped) piece = piece < 6 ? piece + 6 : piece - 6;
+            for (int targetSlot = 0; targetSlot < target.getPieceCount(); targetSlot++) {
+                if (!used[targetSlot] && target.getPiece(targetSlot) == piece) {
+                    used[targetSlot] = true;
+                    conversion.targetSlot[slot] = targetSlot;
+                    break;
+                }
+            }
+        }
+        return conversion;
+    }
+
+    const SolvedTable& Generator::require(const std::string& signature) {
+        auto found = tables.find(signature);
+        if (found != tables.end()) return *found->second;
+
+        auto table = std::make_unique<SolvedTable>(signature);
+        SolvedTable& result = *table;
+        tables.emplace(signature, std::move(table));
+
+        const std::string path = tablePath(options.directory, signature);
+        if (std::filesystem::exists(path)) {
+            load(result, path);
+        } else {
+            solve(result, path);
+        }
+        return result;
+    }
+
+    void Generator::load(SolvedTable& table, const std::string& path) {
+        MappedFile file(path);
+        const Tablebase::FileHeader& header = Tablebase::readHeader(file.data(), file.size(), path);
+        if (std::strncmp(header.signature, table.layout.getSignature().c_str(), sizeof(header.signature)) != 0 ||
+            header.entryCount != table.layout.getEntryCount()) {
+            throw std::runtime_error("Tablebase file does not match its name: " + path);
+        }
+
+        const auto* offsets = reinterpret_cast<const uint64_t*>(file.data() + header.offsetTable);
+        std::vector<uint16_t> values(Tablebase::BLOCK_ENTRIES);
+        for (uint64_t block = 0; block < header.blockCount; block++) {
+            const uint64_t first = block * Tablebase::BLOCK_ENTRIES;
+            const size_t count = static_cast<size_t>(std::min<uint64_t>(Tablebase::BLOCK_ENTRIES, header.entryCount - first));
+            for (int side = 0; side < 2; side++) {
+                const uint64_t begin = offsets[2 * block + side];
+                const uint64_t end = offsets[2 * block + side + 1];
+                if (begin > end || end > header.offsetTable ||
+                    !Tablebase::decodeBlock(file.data() + begin, static_cast<size_t>(end - begin), values.data(), count)) {
+                    throw std::runtime_error("Corrupt tablebase block in " + path);
+                }
+                for (size_t i = 0; i < count; i++) table.store(side, first + i, Tablebase::wdlOf(values[i]));
+            }
+        }
+        std::cout << "Loaded " << table.layout.getSignature() << " from " << path << "\n";
+    }
+
+    void Generator::solve(SolvedTable& table, const std::string& path) {
+        const TablebaseLayout& layout = table.layout;
+        const uint64_t estimate = TablebaseGenerator::estimateMemory(layout.getSignature());
+        if (options.memoryLimitMegabytes > 0 && estimate > options.memoryLimitMegabytes * 1024ULL * 1024ULL) {
+            throw std::runtime_error(layout.getSignature() + " needs about " + std::to_string(estimate >> 20) +
+                                     " MB, above the --memory limit");
+        }
+
+        // Tables reached by captures and promotions are finished first
+        Conversions conversions;
+        conversions.push.table = &table;
+        for (int slot = 0; slot < MAX_PIECES; slot++) conversions.push.targetSlot[slot] = slot;
+        for (int slot = 2; slot < layout.getPieceCount(); slot++) {
+            conversions.capture[slot] = makeConversion(layout, slot, -1, 0);
+        }
+        for (int slot = 2; slot < layout.getPieceCount(); slot++) {
+            const int piece = layout.getPiece(slot);
+            if (typeOf(piece) != PAWN) continue;
+            for (int promoted = 0; promoted < 4; promoted++) {
+                const int newPiece = makePieceCode(static_cast<PieceColor>(colorOf(piece)), static_cast<PieceType>(promoted + 1));
+                conversions.promotion[slot][promoted][0] = makeConversion(layout, -1, slot, newPiece);
+                for (int captured = 2; captured < layout.getPieceCount(); captured++) {
+                    if (colorOf(layout.getPiece(captured)) != colorOf(piece)) {
+                        conversions.promotion[slot][promoted][captured + 1] = makeConversion(layout, captured, slot, newPiece);
+                    }
+                }
+            }
+        }
+
+        std::cout << "Generating " << layout.getSignature() << ": " << layout.getEntryCount() << " positions per side, "
+                  << layout.getSliceCount() << (layout.getSliceCount() == 1 ? " slice" : " slices")
+                  << ", about " << (estimate >> 20) << " MB\n";
+        const auto start = std::chrono::steady_clock::now();
+
+        const std::string temporaryPath = path + ".tmp";
+        std::ofstream out(temporaryPath, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) throw std::runtime_error("Could not create " + temporaryPath);
+        Tablebase::FileHeader header{};
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+        const uint64_t blockCount = (layout.getEntryCount() + Tablebase::BLOCK_ENTRIES - 1) / Tablebase::BLOCK_ENTRIES;
+        std::vector<uint64_t> offsets(2 * blockCount + 1);
+        uint64_t nextBlock = 0;
+        uint64_t written = sizeof(header);
+        uint16_t previous[2] = { 0, 0 };
+        std::vector<uint16_t> blockValues(Tablebase::BLOCK_ENTRIES);
+        std::vector<uint8_t> encoded;
+
+        SliceState state(layout.getSliceSize());
+        std::atomic<uint64_t> counts[2][3] = {};   // side, win/draw/loss
+        std::atomic<int> maxDtz{ 0 };
+
+        for (uint64_t slice = 0; slice < layout.getSliceCount(); slice++) {
+            const uint64_t base = slice * layout.getSliceSize();
+
+            // All moves of one side; quiet ones stay in the slice, the rest are looked up
+            auto examine = [&](const Squares& squares, int side, MoveSummary& summary) {
+                const Placement placement(layout, squares);
+                const Bitboard own = placement.byColor[side];
+                const Bitboard enemy = placement.byColor[1 - side];
+                auto convert = [&](const Conversion& conversion, const Squares& after) {
+                    const int result = -conversion.probe(after, 1 - side);
+                    summary.winningConversion |= result > 0;
+                    summary.drawingConversion |= result == 0;
+                };
+
+                for (int slot = 0; slot < layout.getPieceCount(); slot++) {
+                    const int piece = layout.getPiece(slot);
+                    if (squares[slot] < 0 || colorOf(piece) != side) continue;
+                    const int from = squares[slot];
+
+                    if (typeOf(piece) != PAWN) {
+                        Bitboard targets = Bitboards::pieceAttacks(static_cast<PieceType>(typeOf(piece)), from,
+                                                                   placement.occupied()) & ~own;
+                        while (targets) {
+                            const int to = Bitboards::popLsb(targets);
+                            const int captured = (enemy & Bitboards::squareBit(to)) ? placement.slotAt(to) : -1;
+                            Squares after = squares;
+                            after[slot] = to;
+                            if (captured >= 0) after[captured] = -1;
+                            if (Placement(layout, after).kingAttacked(side)) continue;
+                            summary.legalMoves++;
+                            if (captured >= 0) {
+                                convert(conversions.capture[captured], after);
+                            } else {
+                                Squares normalized = after;
+                                addSuccessor(summary, static_cast<uint32_t>(layout.index(normalized) - base));
+                            }
+                        }
+                        continue;
+                    }
+
+                    // Pawn moves always leave the slice
+                    const int step = side == 0 ? -8 : 8;
+                    const int lastRow = side == 0 ? 0 : 7;
+                    const int startRow = side == 0 ? 6 : 1;
+                    auto pawnMove = [&](int to, int captured) {
+                        Squares after = squares;
+                        after[slot] = to;
+                        if (captured >= 0) after[captured] = -1;
+                        if (Placement(layout, after).kingAttacked(side)) return;
+                        if (Bitboards::rowOf(to) == lastRow) {
+                            summary.legalMoves += 4;
+                            for (int promoted = 0; promoted < 4; promoted++) {
+                                convert(conversions.promotion[slot][promoted][captured + 1], after);
+                            }
+                        } else {
+                            summary.legalMoves++;
+                            convert(captured >= 0 ? conversions.capture[captured] : conversions.push, after);
+                        }
+                    };
+
+                    const int push = from + step;
+                    if (!(placement.occupied() & Bitboards::squareBit(push))) {
+                        pawnMove(push, -1);
+                        if (Bitboards::rowOf(from) == startRow && !(placement.occupied() & Bitboards::squareBit(push + step))) {
+                            pawnMove(push + step, -1);
+                        }
+                    }
+                    Bitboard captures = Bitboards::pawnAttacks(static_cast<PieceColor>(side), from) & enemy;
+                    while (captures) {
+                        const int to = Bitboards::popLsb(captures);
+                        pawnMove(to, placement.slotAt(to));
+                    }
+                }
+            };
+
+            // Positions one non-pawn move before this one, deduplicated
+            auto predecessors = [&](const Squares& squares, int sideToMove, uint32_t* found) {
+                const int mover = 1 - sideToMove;
+                const Placement placement(layout, squares);
+                int count = 0;
+                for (int slot = 0; slot < layout.getPieceCount(); slot++) {
+                    const int piece = layout.getPiece(slot);
+                    if (colorOf(piece) != mover || typeOf(piece) == PAWN) continue;
+                    Bitboard origins = Bitboards::pieceAttacks(static_cast<PieceType>(typeOf(piece)), squares[slot],
+                                                               placement.occupied()) & ~placement.occupied();
+                    while (origins) {
+                        Squares before = squares;
+                        before[slot] = Bitboards::popLsb(origins);
+                        // The mover was to move, so the other side cannot have been in check
+                        if (Placement(layout, before).kingAttacked(sideToMove)) continue;
+                        const uint32_t entry = static_cast<uint32_t>(layout.index(before) - base);
+                        if (std::find(found, found + count, entry) == found + count) found[count++] = entry;
+                    }
+                }
+                return count;
+            };
+
+            // Classify every position from its captures, promotions and pawn moves
+            for (int side = 0; side < 2; side++) {
+                for (uint64_t word = 0; word < state.words; word++) {
+                    state.current[side][word] = 0;
+                    state.next[side][word] = 0;
+                }
+            }
+            state.nextCount = 0;
+            parallelFor(state.size, [&](uint64_t begin, uint64_t end) {
+                for (uint64_t entry = begin; entry < end; entry++) {
+                    Squares squares;
+                    const bool valid = layout.decode(base + entry, squares);
+                    for (int side = 0; side < 2; side++) {
+                        state.counters[side][entry].store(0, std::memory_order_relaxed);
+                        if (!valid || Placement(layout, squares).kingAttacked(1 - side)) {
+                            state.values[side][entry].store(ILLEGAL, std::memory_order_relaxed);
+                            continue;
+                        }
+
+                        MoveSummary summary;
+                        examine(squares, side, summary);
+                        uint16_t value = Tablebase::DRAW_VALUE;
+                        if (summary.legalMoves == 0) {
+                            if (Placement(layout, squares).kingAttacked(side)) {
+                                value = Tablebase::lossValue(0);
+                                state.mark(state.current, side, entry);
+                            }
+                        } else if (summary.winningConversion) {
+                            value = Tablebase::winValue(1);
+                            state.mark(state.next, side, entry);
+                            state.nextCount++;
+                        } else if (summary.successorCount == 0) {
+                            if (!summary.drawingConversion) {
+                                value = Tablebase::lossValue(1);
+                                state.mark(state.next, side, entry);
+                                state.nextCount++;
+                            }
+                        } else {
+                            state.counters[side][entry].store(
+                                static_cast<uint8_t>(summary.successorCount | (summary.drawingConversion ? CANNOT_LOSE : 0)),
+                                std::memory_order_relaxed);
+                        }
+                        state.values[side][entry].store(value, std::memory_order_relaxed);
+                    }
+                }
+            });
+
+            // Propagate ply by ply: a loss makes every predecessor a win, and a
+            // predecessor whose last undecided move reaches a win becomes a loss
+            for (int ply = 0;; ply++) {
+                parallelFor(state.size, [&](uint64_t begin, uint64_t end) {
+                    uint32_t found[MAX_SUCCESSORS * 2];
+                    for (uint64_t word = begin / 64; word < (end + 63) / 64; word++) {
+                        for (int side = 0; side < 2; side++) {
+                            uint64_t bits = state.current[side][word].load(std::memory_order_relaxed);
+                            while (bits) {
+                                const uint64_t entry = word * 64 + Bitboards::popLsb(bits);
+                                Squares squares;
+                                layout.decode(base + entry, squares);
+                                const bool lost = Tablebase::wdlOf(state.values[side][entry].load(std::memory_order_relaxed)) < 0;
+                                const int count = predecessors(squares, side, found);
+                                const int other = 1 - side;
+                                for (int i = 0; i < count; i++) {
+                                    const uint32_t before = found[i];
+                                    uint16_t expected = Tablebase::DRAW_VALUE;
+                                    if (lost) {
+                                        if (state.values[other][before].compare_exchange_strong(expected, Tablebase::winValue(ply + 1))) {
+                                            state.mark(state.next, other, before);
+                                            state.nextCount++;
+                                        }
+                                        continue;
+                                    }
+                                    if (state.values[other][before].load(std::memory_order_relaxed) != Tablebase::DRAW_VALUE) continue;
+                                    const uint8_t remaining = static_cast<uint8_t>(state.counters[other][before].fetch_sub(1) - 1);
+                                    if (remaining == 0 &&
+                                        state.values[other][before].compare_exchange_strong(expected, Tablebase::lossValue(ply + 1))) {
+                                        state.mark(state.next, other, before);
+                                        state.nextCount++;
+                                    }
+                                }
+                            }
+                        }
+                    }
+                });
+
+                if (state.nextCount == 0) break;
+                state.nextCount = 0;
+                for (int side = 0; side < 2; side++) {
+                    std::swap(state.current[side], state.next[side]);
+                    for (uint64_t word = 0; word < state.words; word++) state.next[side][word] = 0;
+                }
+            }
+
+            // Undecided positions are draws
+            parallelFor(state.size, [&](uint64_t begin, uint64_t end) {
+                uint64_t local[2][3] = {};
+                int localMax = 0;
+                for (uint64_t entry = begin; entry < end; entry++) {
+                    for (int side = 0; side < 2; side++) {
+                        const uint16_t value = state.values[side][entry].load(std::memory_order_relaxed);
+                        if (value == ILLEGAL) continue;
+                        const int result = Tablebase::wdlOf(value);
+                        table.store(side, base + entry, result);
+                        local[side][1 - result]++;
+                        localMax = std::max(localMax, Tablebase::dtzOf(value));
+                    }
+                }
+                for (int side = 0; side < 2; side++) {
+                    for (int kind = 0; kind < 3; kind++) counts[side][kind] += local[side][kind];
+                }
+                int seen = maxDtz.load();
+                while (localMax > seen && !maxDtz.compare_exchange_weak(seen, localMax)) {}
+            });
+
+            // Blocks never straddle slices: slices with pawns are multiples of 64^2 entries
+            const uint64_t sliceEnd = base + state.size;
+            for (; nextBlock * Tablebase::BLOCK_ENTRIES < sliceEnd; nextBlock++) {
+                const uint64_t first = nextBlock * Tablebase::BLOCK_ENTRIES;
+                const size_t count = static_cast<size_t>(std::min<uint64_t>(Tablebase::BLOCK_ENTRIES, sliceEnd - first));
+                for (int side = 0; side < 2; side++) {
+                    // Illegal slots repeat the previous value to lengthen runs
+                    for (size_t i = 0; i < count; i++) {
+                        const uint16_t value = state.values[side][first - base + i].load(std::memory_order_relaxed);
+                        if (value != ILLEGAL) previous[side] = value;
+                        blockValues[i] = previous[side];
+                    }
+                    encoded.clear();
+                    Tablebase::encodeBlock(blockValues.data(), count, encoded);
+                    offsets[2 * nextBlock + side] = written;
+                    out.write(reinterpret_cast<const char*>(encoded.data()), static_cast<std::streamsize>(encoded.size()));
+                    written += encoded.size();
+                }
+            }
+        }
+
+        offsets[2 * blockCount] = written;
+        std::memcpy(header.magic, Tablebase::MAGIC, sizeof(header.magic));
+        header.version = Tablebase::VERSION;
+        header.blockEntries = Tablebase::BLOCK_ENTRIES;
+        layout.getSignature().copy(header.signature, sizeof(header.signature) - 1);
+        header.entryCount = layout.getEntryCount();
+        header.blockCount = blockCount;
+        header.offsetTable = written;
+        header.maxDtz = static_cast<uint32_t>(maxDtz.load());
+        out.write(reinterpret_cast<const char*>(offsets.data()), static_cast<std::streamsize>(offsets.size() * sizeof(uint64_t)));
+        out.seekp(0);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.close();
+        if (!out) throw std::runtime_error("Could not write " + temporaryPath);
+        std::filesystem::rename(temporaryPath, path);
+
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "  White to move: " << counts[0][0] << " won, " << counts[0][1] << " drawn, " << counts[0][2] << " lost\n"
+                  << "  Black to move: " << counts[1][0] << " won, " << counts[1][1] << " drawn, " << counts[1][2] << " lost\n"
+                  << "  Longest DTZ " << header.maxDtz << " plies, " << seconds << " s, "
+                  << (written + offsets.size() * sizeof(uint64_t)) / 1024 << " KB -> " << path << "\n";
+    }
+}
+
+uint64_t TablebaseGenerator::estimateMemory(const std::string& signature) {
+    const TablebaseLayout layout(signature);
+    const uint64_t working = layout.getSliceSize() * 2 * (sizeof(uint16_t) + sizeof(uint8_t)) + layout.getSliceSize() / 2;
+    const uint64_t finished = layout.getEntryCount() * 2 / 4;
+    return working + finished;
+}
+
+void TablebaseGenerator::generate(const std::string& signature, const Options& options) {
+    bool swapped;
+    const std::string canonical = Tablebase::canonicalSignature(signature, swapped);
+    std::filesystem::create_directories(options.directory);
+    Generator generator(options);
+    generator.require(canonical);
+}
+
+int TablebaseGenerator::run(const std::vector<std::string>& args) {
+    Options options;
+    options.threads = WorkStealingPool::defaultThreadCount();
+    std::vector<std::string> signatures;
+    for (size_t i = 0; i < args.size(); i++) {
+        if (args[i] == "--dir" && i + 1 < args.size()) {
+            options.directory = args[++i];
+        } else if (args[i] == "--threads" && i + 1 < args.size()) {
+            options.threads = std::max(1, std::stoi(args[++i]));
+        } else if (args[i] == "--memory" && i + 1 < args.size()) {
+            options.memoryLimitMegabytes = std::stoull(args[++i]);
+        } else if (args[i].rfind("--", 0) != 0) {
+            signatures.push_back(args[i]);
+        } else {
+            signatures.clear();
+            break;
+        }
+    }
+    if (signatures.empty()) {
+        std::cerr << "Usage: tbgen <signature>... [--dir <path>] [--threads N] [--memory MB]\n"
+                  << "       e.g. tbgen KRPvKR --dir tb\n";
+        return 1;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    for (const std::string& signature : signatures) generate(signature, options);
+    std::cout << "Done in " << std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()
+              << " s with " << options.threads << " threads\n";
+    return 0;
+}
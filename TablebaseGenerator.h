@@ -0,0 +1,37 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Builds Tablebase files by retrograde analysis (command tbgen). Tables the
+// requested one converts into (captures, promotions) are generated first,
+// or loaded when their file already exists in the output directory.
+//
+// Each pawn slice is solved in parallel: every position is classified by
+// its captures, promotions and pawn pushes, then wins and losses are
+// propagated backwards one ply at a time through un-moves, tracking the
+// newly decided positions of each ply in bit arrays. The ply at which a
+// position is decided is its DTZ.
+//
+// Memory per table: 3 bytes per position and side to move for the slice
+// being solved (value and move counter) plus 4 frontier bits, and 2 bits
+// per position and side for every table kept for lookups. The largest
+// five-piece pawnless tables (462 * 64^3 positions per side) peak near
+// 790 MB; tables with pawns are solved one slice of 64^k positions at a
+// time and stay well below that.
+namespace TablebaseGenerator {
+    struct Options {
+        std::string directory = ".";
+        int threads = 1;
+        size_t memoryLimitMegabytes = 0;   // refuse larger tables; 0 = no limit
+    };
+
+    // Peak working memory in bytes for solving one table
+    uint64_t estimateMemory(const std::string& signature);
+
+    // Writes <directory>/<signature>.stb for the canonical signature and its dependencies
+    void generate(const std::string& signature, const Options& options);
+
+    int run(const std::vector<std::string>& args);
+}
@@ -0,0 +1,200 @@
+#include "TablebaseProber.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+#include "Endgames.h"
+
+namespace {
+    std::atomic<uint32_t> nextTableId{ 1 };
+
+    // Decoded blocks of the calling thread, direct-mapped by table, side and block
+    class BlockCache {
+    private:
+        static constexpr size_t SLOTS = 64;     // 512 KB per thread
+
+        struct Slot {
+            uint64_t key = 0;
+            std::array<uint16_t, Tablebase::BLOCK_ENTRIES> values;
+        };
+        std::unique_ptr<Slot[]> slots = std::make_unique<Slot[]>(SLOTS);
+
+    public:
+        static uint64_t keyOf(uint32_t tableId, int side, uint64_t block) {
+            return (static_cast<uint64_t>(tableId) << 40) | (static_cast<uint64_t>(side) << 39) | block;
+        }
+
+        // Slot for the key; its values are valid when slot.key == key
+        Slot& slotOf(uint64_t key) {
+            return slots[(key * 0x9E3779B97F4A7C15ULL) >> 58];
+        }
+
+        static BlockCache& local() {
+            thread_local BlockCache cache;
+            return cache;
+        }
+    };
+}
+
+void TablebaseProber::prepareThread() {
+    BlockCache::local();
+}
+
+TablebaseProber::Table::Table(const std::string& filePath, const std::string& signature, uint32_t tableId)
+    : path(filePath), layout(signature), id(tableId) {
+}
+
+TablebaseProber::TablebaseProber(const std::string& directory, size_t maxMapped)
+    : maxPieces(0), maxMappedTables(std::max<size_t>(maxMapped, 1)), mappedCount(0), useClock(0) {
+    std::error_code error;
+    std::filesystem::directory_iterator entries(directory, error);
+    if (error) throw std::runtime_error("Could not read tablebase directory " + directory);
+
+    for (const auto& entry : entries) {
+        if (!entry.is_regular_file() || entry.path().extension() != Tablebase::FILE_EXTENSION) continue;
+        const std::string name = entry.path().stem().string();
+        bool colorsSwapped = false;
+        try {
+            if (Tablebase::canonicalSignature(name, colorsSwapped) != name) continue;
+            tables.push_back(std::make_unique<Table>(entry.path().string(), name, nextTableId++));
+        }
+        catch (const std::exception&) {
+            continue;   // not a tablebase name
+        }
+
+        Table* table = tables.back().get();
+        maxPieces = std::max(maxPieces, table->layout.getPieceCount());
+        byMaterial.emplace(Endgames::materialKey(name, PieceColor::WHITE), Orientation{ table, false });
+        byMaterial.emplace(Endgames::materialKey(name, PieceColor::BLACK), Orientation{ table, true });
+    }
+}
+
+size_t TablebaseProber::getMappedCount() {
+    std::lock_guard<std::mutex> lock(mapMutex);
+    return mappedCount;
+}
+
+// Registers a reader when the table is mapped. Reader count and mapped flag
+// are sequentially consistent, so unmap() either sees this reader or the
+// reader sees the table unmapped.
+bool TablebaseProber::acquire(Table& table) {
+    table.readers.fetch_add(1);
+    if (table.mapped.load()) return true;
+    table.readers.fetch_sub(1);
+    return false;
+}
+
+bool TablebaseProber::map(Table& table) {
+    std::unique_lock<std::mutex> lock(mapMutex, std::try_to_lock);
+    if (!lock.owns_lock()) return false;
+    if (table.mapped.load()) return true;
+    if (table.failed.load()) return false;
+
+    if (mappedCount >= maxMappedTables) {
+        Table* victim = nullptr;
+        for (const auto& candidate : tables) {
+            if (candidate->mapped.load() && (victim == nullptr || candidate->lastUse < victim->lastUse)) {
+                victim = candidate.get();
+            }
+        }
+        if (victim != nullptr) unmap(*victim);
+    }
+
+    try {
+        table.file.open(table.path);
+        const Tablebase::FileHeader& header = Tablebase::readHeader(table.file.data(), table.file.size(), table.path);
+        if (std::strncmp(header.signature, table.layout.getSignature().c_str(), sizeof(header.signature)) != 0 ||
+            header.entryCount != table.layout.getEntryCount()) {
+            throw std::runtime_error("Tablebase file does not match its name: " + table.path);
+        }
+        table.header = &header;
+        table.offsets = reinterpret_cast<const uint64_t*>(table.file.data() + header.offsetTable);
+        // Blocks are read at random; the offset table is needed for every one of them
+        table.file.adviseRandomAccess();
+        table.file.adviseWillNeed(header.offsetTable, (2 * header.blockCount + 1) * sizeof(uint64_t));
+    }
+    catch (const std::exception& e) {
+        table.file.close();
+        table.failed = true;
+        std::cerr << "Tablebase disabled: " << e.what() << "\n";
+        return false;
+    }
+
+    table.mapped.store(true);
+    mappedCount++;
+    return true;
+}
+
+// Called with mapMutex held; readers are inside a single block decode, so the wait is short
+void TablebaseProber::unmap(Table& table) {
+    table.mapped.store(false);
+    while (table.readers.load() != 0) std::this_thread::yield();
+    table.file.close();
+    table.header = nullptr;
+    table.offsets = nullptr;
+    mappedCount--;
+}
+
+bool TablebaseProber::readValue(Table& table, int side, uint64_t index, uint16_t& value) {
+    const uint64_t block = index / Tablebase::BLOCK_ENTRIES;
+    const uint64_t key = BlockCache::keyOf(table.id, side, block);
+    auto& slot = BlockCache::local().slotOf(key);
+    if (slot.key != key) {
+        table.lastUse.store(++useClock, std::memory_order_relaxed);
+        if (!acquire(table) && (table.failed.load() || !map(table) || !acquire(table))) return false;
+
+        const Tablebase::FileHeader& header = *table.header;
+        const uint64_t first = block * Tablebase::BLOCK_ENTRIES;
+        const size_t count = static_cast<size_t>(std::min<uint64_t>(Tablebase::BLOCK_ENTRIES, header.entryCount - first));
+        const uint64_t begin = table.offsets[2 * block + side];
+        const uint64_t end = table.offsets[2 * block + side + 1];
+        const bool valid = begin <= end && end <= header.offsetTable &&
+            Tablebase::decodeBlock(table.file.data() + begin, static_cast<size_t>(end - begin), slot.values.data(), count);
+        table.readers.fetch_sub(1);
+
+        slot.key = valid ? key : 0;
+        if (!valid) return false;
+    }
+    value = slot.values[index % Tablebase::BLOCK_ENTRIES];
+    return true;
+}
+
+bool TablebaseProber::probe(const BoardState& state, TablebaseProbe& result) {
+    if (Bitboards::popCount(state.getOccupied()) > maxPieces || state.getCastlingRights() != 0 ||
+        state.getEnPassantSquare() >= 0) {
+        return false;
+    }
+    const auto found = byMaterial.find(state.getMaterialKey());
+    if (found == byMaterial.end()) return false;
+    Table& table = *found->second.table;
+    const bool swapped = found->second.colorsSwapped;
+
+    // The table's pieces in slot order; with swapped colors the board is
+    // flipped vertically so the table's White pawns still run up the board
+    Bitboard remaining[12];
+    for (PieceColor color : { PieceColor::WHITE, PieceColor::BLACK }) {
+        for (int type = 0; type < 6; type++) {
+            remaining[makePieceCode(color, static_cast<PieceType>(type))] = state.getPieces(color, static_cast<PieceType>(type));
+        }
+    }
+    TablebaseLayout::Squares squares{};
+    for (int slot = 0; slot < table.layout.getPieceCount(); slot++) {
+        const int piece = table.layout.getPiece(slot);
+        const PieceType type = static_cast<PieceType>(piece % 6);
+        PieceColor color = static_cast<PieceColor>(piece / 6);
+        if (swapped) color = oppositeColor(color);
+        const int square = Bitboards::popLsb(remaining[makePieceCode(color, type)]);
+        squares[slot] = swapped ? square ^ 56 : square;
+    }
+    int side = state.getSideToMove() == PieceColor::WHITE ? 0 : 1;
+    if (swapped) side ^= 1;
+
+    uint16_t value;
+    if (!readValue(table, side, table.layout.index(squares), value)) return false;
+    result.wdl = Tablebase::wdlOf(value);
+    result.dtz = Tablebase::dtzOf(value);
+    return true;
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "BoardState.h"
+#include "MappedFile.h"
+#include "Tablebase.h"
+
+struct TablebaseProbe {
+    int wdl = 0;    // side to move: 1 win, 0 draw, -1 loss
+    int dtz = 0;    // plies to the next capture, pawn move or mate; 0 for draws
+};
+
+// Read side of the Tablebase files in one directory. Files are listed at
+// construction and memory-mapped on first use; at most maxMappedTables stay
+// mapped and the least recently used one is unmapped to make room. Decoded
+// blocks are kept in a small per-thread cache, so probes that land near
+// each other skip decompression.
+//
+// Any number of search threads may probe at once. Mapped tables are reached
+// through atomics only; mapping a table takes a lock, and a probe that finds
+// it taken fails instead of waiting. A table is unmapped only after its last
+// reader has left.
+class TablebaseProber {
+private:
+    struct Table {
+        std::string path;
+        TablebaseLayout layout;
+        uint32_t id;                            // unique per process, keys the block cache
+        MappedFile file;                        // changed only under mapMutex
+        const Tablebase::FileHeader* header = nullptr;
+        const uint64_t* offsets = nullptr;
+        std::atomic<bool> mapped{ false };
+        std::atomic<bool> failed{ false };      // unreadable file, not retried
+        std::atomic<int> readers{ 0 };
+        std::atomic<uint64_t> lastUse{ 0 };
+
+        Table(const std::string& filePath, const std::string& signature, uint32_t tableId);
+    };
+
+    struct Orientation {
+        Table* table;
+        bool colorsSwapped;     // the table's White is the board's Black
+    };
+
+    std::vector<std::unique_ptr<Table>> tables;
+    std::unordered_map<uint64_t, Orientation> byMaterial;   // fixed after construction
+    int maxPieces;
+    size_t maxMappedTables;
+    std::mutex mapMutex;
+    size_t mappedCount;                         // guarded by mapMutex
+    std::atomic<uint64_t> useClock;
+
+    bool acquire(Table& table);
+    bool map(Table& table);
+    void unmap(Table& table);
+    bool readValue(Table& table, int side, uint64_t index, uint16_t& value);
+
+public:
+    // Throws std::runtime_error if the directory cannot be read
+    explicit TablebaseProber(const std::string& directory, size_t maxMappedTables = 64);
+
+    TablebaseProber(const TablebaseProber&) = delete;
+    TablebaseProber& operator=(const TablebaseProber&) = delete;
+
+    // False without a table for the material, with castling rights or an en
+    // passant square, or while another thread is mapping the table
+    bool probe(const BoardState& state, TablebaseProbe& result);
+    // Creates the calling thread's block cache, otherwise allocated on its first probe
+    static void prepareThread();
+
+    int getMaxPieces() const { return maxPieces; }
+    size_t getTableCount() const { return tables.size(); }
+    size_t getMappedCount();
+};
@@ -0,0 +1,52 @@
+#include "TranspositionTable.h"
+#include <algorithm>
+
+TranspositionTable::TranspositionTable(size_t megabytes) : indexMask(0) {
+    resize(megabytes);
+}
+
+void TranspositionTable::resize(size_t megabytes) {
+    size_t count = std::max<size_t>(1, megabytes * 1024 * 1024 / sizeof(TTEntry));
+    // Round down to a power of two so the index is a simple mask
+    size_t size = 1;
+    while (size * 2 <= count) size *= 2;
+
+    entries.assign(size, TTEntry{});
+    indexMask = size - 1;
+}
+
+void TranspositionTable::clear() {
+    std::fill(entries.begin(), entries.end(), TTEntry{});
+}
+
+bool TranspositionTable::probe(uint64_t key, TTEntry& entry) const {
+    const TTEntry& slot = entries[key & indexMask];
+    if (slot.key != key || slot.bound == Bound::NONE) return false;
+    entry = slot;
+    return true;
+}
+
+void TranspositionTable::store(uint64_t key, int score, PackedMove move, int depth, Bound bound) {
+    TTEntry& slot = entries[key & indexMask];
+
+    // Keep a deeper result for the same position unless the new one is exact
+    if (slot.key == key && slot.depth > depth && bound != Bound::EXACT) return;
+
+    // Preserve the old best move when this result has none
+    if (move.isNone() && slot.key == key) move = PackedMove::fromRaw(slot.move);
+
+    slot.key = key;
+    slot.score = static_cast<int16_t>(score);
+    slot.move = move.getRaw();
+    slot.depth = static_cast<uint8_t>(std::max(depth, 0));
+    slot.bound = bound;
+}
+
+int TranspositionTable::getHashfull() const {
+    size_t sample = std::min<size_t>(1000, entries.size());
+    int used = 0;
+    for (size_t i = 0; i < sample; i++) {
+        if (entries[i].bound != Bound::NONE) used++;
+    }
+    return static_cast<int>(used * 1000 / sample);
+}
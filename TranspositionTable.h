@@ -0,0 +1,36 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "PackedMove.h"
+
+enum class Bound : uint8_t {
+    NONE,
+    UPPER,   // score <= alpha (fail low)
+    LOWER,   // score >= beta (fail high)
+    EXACT
+};
+
+struct TTEntry {
+    uint64_t key;
+    int16_t score;
+    uint16_t move;
+    uint8_t depth;
+    Bound bound;
+};
+
+// Direct-mapped hash table of search results, indexed by Zobrist key
+class TranspositionTable {
+private:
+    std::vector<TTEntry> entries;
+    uint64_t indexMask;
+
+public:
+    explicit TranspositionTable(size_t megabytes = 16);
+
+    void resize(size_t megabytes);
+    void clear();
+    bool probe(uint64_t key, TTEntry& entry) const;
+    void store(uint64_t key, int score, PackedMove move, int depth, Bound bound);
+    int getHashfull() const;  // permille of used entries, sampled
+};
@@ -0,0 +1,18 @@
+#pragma once
+
+// Evaluation parameters written by "Schack tune". Regenerate with the tuner
+// instead of editing by hand; ChessConstants picks these values up.
+// Source: hand-set defaults
+namespace TunedParameters {
+    // Material in centipawns, midgame / endgame
+    constexpr int PAWN_MG = 100;
+    constexpr int PAWN_EG = 100;
+    constexpr int KNIGHT_MG = 300;
+    constexpr int KNIGHT_EG = 300;
+    constexpr int BISHOP_MG = 300;
+    constexpr int BISHOP_EG = 300;
+    constexpr int ROOK_MG = 500;
+    constexpr int ROOK_EG = 500;
+    constexpr int QUEEN_MG = 900;
+    constexpr int QUEEN_EG = 900;
+}
@@ -0,0 +1,355 @@
+#include "Tuner.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include "BoardState.h"
+#include "Constants.h"
+#include "Evaluation.h"
+#include "PieceSquareTables.h"
+#include "WorkStealingPool.h"
+
+namespace {
+    // Tuned piece types, in TunedParameters.h order
+    constexpr PieceType TUNED_TYPES[5] = {
+        PieceType::PAWN, PieceType::KNIGHT, PieceType::BISHOP, PieceType::ROOK, PieceType::QUEEN
+    };
+    constexpr const char* TYPE_NAMES[5] = { "PAWN", "KNIGHT", "BISHOP", "ROOK", "QUEEN" };
+    constexpr int TYPE_COUNT = 5;
+    constexpr int PARAMETER_COUNT = 2 * TYPE_COUNT;   // midgame, endgame per type
+
+    struct Options {
+        std::string inputPath;
+        std::string outputPath = "TunedParameters.h";
+        int threads = WorkStealingPool::defaultThreadCount();
+        int epochs = 500;
+        double learningRate = 2.0;
+    };
+
+    // Positions reduced to what the tuned terms need. Every other evaluation
+    // term is constant during tuning and folded into base, so one position
+    // costs 17 bytes and the loss is linear in the parameters. Stored as
+    // separate columns so the per-position loop is branch-free and vectorizable.
+    struct TrainingSet {
+        std::vector<float> base;           // White's eval without the tuned terms
+        std::vector<float> phase;          // midgame weight, 0..1
+        std::vector<float> result;         // 1 White win, 0.5 draw, 0 Black win
+        std::vector<int8_t> material[TYPE_COUNT];   // White minus Black count
+
+        size_t size() const { return base.size(); }
+    };
+
+    struct Sample {
+        float base;
+        float phase;
+        float result;
+        int8_t material[TYPE_COUNT];
+    };
+
+    // Per-chunk partial sums; chunks are reduced in order so runs are reproducible
+    struct Partial {
+        double loss = 0.0;
+        double gradient[PARAMETER_COUNT] = {};
+    };
+
+    double startingValue(int parameter) {
+        constexpr int values[PARAMETER_COUNT] = {
+            ChessConstants::PAWN_VALUE, ChessConstants::PAWN_VALUE_EG,
+            ChessConstants::KNIGHT_VALUE, ChessConstants::KNIGHT_VALUE_EG,
+            ChessConstants::BISHOP_VALUE, ChessConstants::BISHOP_VALUE_EG,
+            ChessConstants::ROOK_VALUE, ChessConstants::ROOK_VALUE_EG,
+            ChessConstants::QUEEN_VALUE, ChessConstants::QUEEN_VALUE_EG,
+        };
+        return values[parameter];
+    }
+
+    // Result from "[1.0]", "[0.5]", "1-0", "0-1", "1/2-1/2" (quoted or not) after the FEN fields
+    bool parseResult(const std::string& text, float& result) {
+        if (text.find("1/2-1/2") != std::string::npos) { result = 0.5f; return true; }
+        if (text.find("1-0") != std::string::npos) { result = 1.0f; return true; }
+        if (text.find("0-1") != std::string::npos) { result = 0.0f; return true; }
+        const size_t open = text.find('[');
+        if (open != std::string::npos) {
+            try {
+                result = std::stof(text.substr(open + 1));
+                return result >= 0.0f && result <= 1.0f;
+            }
+            catch (const std::exception&) {
+                return false;
+            }
+        }
+        return false;
+    }
+
+    bool parseSample(const std::string& line, PawnTable& pawns, Sample& sample) {
+        std::istringstream stream(line);
+        std::string placement, side, castling, enPassant;
+        if (!(stream >> placement >> side >> castling >> enPassant)) return false;
+        std::string rest;
+        std::getline(stream, rest);
+        if (!parseResult(rest, sample.result)) return false;
+
+        BoardState state;
+        if (!state.setFromFEN(placement + " " + side + " " + castling + " " + enPassant)) return false;
+
+        const double phase = std::min(state.getPhase(), PieceSquareTables::MAX_PHASE) /
+                             static_cast<double>(PieceSquareTables::MAX_PHASE);
+        double tuned = 0.0;
+        for (int t = 0; t < TYPE_COUNT; t++) {
+            const int count = Bitboards::popCount(state.getPieces(PieceColor::WHITE, TUNED_TYPES[t])) -
+                              Bitboards::popCount(state.getPieces(PieceColor::BLACK, TUNED_TYPES[t]));
+            sample.material[t] = static_cast<int8_t>(count);
+            tuned += count * (startingValue(2 * t) * phase + startingValue(2 * t + 1) * (1.0 - phase));
+        }
+        sample.phase = static_cast<float>(phase);
+        sample.base = static_cast<float>(Evaluation::evaluateWhite(state, pawns) - tuned);
+        return true;
+    }
+
+    TrainingSet loadPositions(const Options& options, WorkStealingPool& pool) {
+        std::ifstream file(options.inputPath);
+        if (!file.is_open()) {
+            throw std::runtime_error("Could not open " + options.inputPath);
+        }
+        std::vector<std::string> lines;
+        std::string line;
+        while (std::getline(file, line)) {
+            if (!line.empty()) lines.push_back(std::move(line));
+        }
+
+        // Parse in chunks on the pool, then append the chunks in file order
+        const size_t chunkCount = static_cast<size_t>(pool.size()) * 4;
+        const size_t chunkSize = (lines.size() + chunkCount - 1) / chunkCount;
+        std::vector<std::vector<Sample>> chunks(chunkCount);
+        for (size_t c = 0; c < chunkCount; c++) {
+            pool.submit([&, c](int) {
+                PawnTable pawns(1024);
+                const size_t begin = std::min(lines.size(), c * chunkSize);
+                const size_t end = std::min(lines.size(), begin + chunkSize);
+                for (size_t i = begin; i < end; i++) {
+                    Sample sample;
+                    if (parseSample(lines[i], pawns, sample)) chunks[c].push_back(sample);
+                }
+            });
+        }
+        pool.wait();
+
+        TrainingSet set;
+        size_t total = 0;
+        for (const auto& chunk : chunks) total += chunk.size();
+        set.base.reserve(total);
+        set.phase.reserve(total);
+        set.result.reserve(total);
+        for (auto& column : set.material) column.reserve(total);
+        for (const auto& chunk : chunks) {
+            for (const Sample& sample : chunk) {
+                set.base.push_back(sample.base);
+                set.phase.push_back(sample.phase);
+                set.result.push_back(sample.result);
+                for (int t = 0; t < TYPE_COUNT; t++) set.material[t].push_back(sample.material[t]);
+            }
+        }
+        std::cout << "Loaded " << total << " of " << lines.size() << " lines\n";
+        return set;
+    }
+
+    // Log loss of sigmoid(scale * eval) against the results over [begin, end),
+    // with its gradient for the midgame/endgame material parameters
+    void evaluateChunk(const TrainingSet& set, size_t begin, size_t end, const double* parameters,
+                       double scale, bool withGradient, Partial& partial) {
+        float mg[TYPE_COUNT];
+        float eg[TYPE_COUNT];
+        for (int t = 0; t < TYPE_COUNT; t++) {
+            mg[t] = static_cast<float>(parameters[2 * t]);
+            eg[t] = static_cast<float>(parameters[2 * t + 1]);
+        }
+        const float k = static_cast<float>(scale);
+        double loss = 0.0;
+        double gradient[PARAMETER_COUNT] = {};
+
+        for (size_t i = begin; i < end; i++) {
+            const float phase = set.phase[i];
+            float eval = set.base[i];
+            for (int t = 0; t < TYPE_COUNT; t++) {
+                eval += set.material[t][i] * (mg[t] * phase + eg[t] * (1.0f - phase));
+            }
+            const float predicted = 1.0f / (1.0f + std::exp(-k * eval));
+            const float target = set.result[i];
+            const float p = std::clamp(predicted, 1e-6f, 1.0f - 1e-6f);
+            loss -= target * std::log(p) + (1.0f - target) * std::log(1.0f - p);
+
+            if (withGradient) {
+                const float error = (predicted - target) * k;
+                for (int t = 0; t < TYPE_COUNT; t++) {
+                    const float weighted = error * set.material[t][i];
+                    gradient[2 * t] += weighted * phase;
+                    gradient[2 * t + 1] += weighted * (1.0f - phase);
+                }
+            }
+        }
+        partial.loss = loss;
+        for (int p = 0; p < PARAMETER_COUNT; p++) partial.gradient[p] = gradient[p];
+    }
+
+    // Mean loss (and mean gradient) over the whole set, split across the pool
+    double computeLoss(const TrainingSet& set, const double* parameters, double scale,
+                       WorkStealingPool& pool, double* gradient) {
+        const size_t chunkCount = static_cast<size_t>(pool.size()) * 4;
+        const size_t chunkSize = (set.size() + chunkCount - 1) / chunkCount;
+        std::vector<Partial> partials(chunkCount);
+        for (size_t c = 0; c < chunkCount; c++) {
+            pool.submit([&, c](int) {
+                const size_t begin = std::min(set.size(), c * chunkSize);
+                const size_t end = std::min(set.size(), begin + chunkSize);
+                evaluateChunk(set, begin, end, parameters, scale, gradient != nullptr, partials[c]);
+            });
+        }
+        pool.wait();
+
+        const double count = static_cast<double>(std::max<size_t>(set.size(), 1));
+        double loss = 0.0;
+        if (gradient != nullptr) std::fill(gradient, gradient + PARAMETER_COUNT, 0.0);
+        for (const Partial& partial : partials) {
+            loss += partial.loss;
+            if (gradient != nullptr) {
+                for (int p = 0; p < PARAMETER_COUNT; p++) gradient[p] += partial.gradient[p];
+            }
+        }
+        if (gradient != nullptr) {
+            for (int p = 0; p < PARAMETER_COUNT; p++) gradient[p] /= count;
+        }
+        return loss / count;
+    }
+
+    // Scale mapping centipawns to win probability that best fits the current
+    // evaluation (golden-section search); tuning keeps it fixed afterwards
+    double fitScale(const TrainingSet& set, const double* parameters, WorkStealingPool& pool) {
+        const double ratio = (std::sqrt(5.0) - 1.0) / 2.0;
+        double low = 0.0001;
+        double high = 0.02;
+        double a = high - ratio * (high - low);
+        double b = low + ratio * (high - low);
+        double lossA = computeLoss(set, parameters, a, pool, nullptr);
+        double lossB = computeLoss(set, parameters, b, pool, nullptr);
+        for (int i = 0; i < 40; i++) {
+            if (lossA < lossB) {
+                high = b;
+                b = a;
+                lossB = lossA;
+                a = high - ratio * (high - low);
+                lossA = computeLoss(set, parameters, a, pool, nullptr);
+            } else {
+                low = a;
+                a = b;
+                lossA = lossB;
+                b = low + ratio * (high - low);
+                lossB = computeLoss(set, parameters, b, pool, nullptr);
+            }
+        }
+        return (low + high) / 2.0;
+    }
+
+    void writeHeader(const Options& options, const double* parameters, size_t positions, double loss, double scale) {
+        std::ofstream out(options.outputPath);
+        if (!out.is_open()) {
+            throw std::runtime_error("Could not open " + options.outputPath);
+        }
+        out << "#pragma once\n\n";
+        out << "// Evaluation parameters written by \"Schack tune\". Regenerate with the tuner\n";
+        out << "// instead of editing by hand; ChessConstants picks these values up.\n";
+        out << "// Source: " << options.inputPath << ", " << positions << " positions, log loss "
+            << std::setprecision(6) << loss << ", scale " << scale << "\n";
+        out << "namespace TunedParameters {\n";
+        out << "    // Material in centipawns, midgame / endgame\n";
+        for (int t = 0; t < TYPE_COUNT; t++) {
+            out << "    constexpr int " << TYPE_NAMES[t] << "_MG = " << std::lround(parameters[2 * t]) << ";\n";
+            out << "    constexpr int " << TYPE_NAMES[t] << "_EG = " << std::lround(parameters[2 * t + 1]) << ";\n";
+        }
+        out << "}\n";
+    }
+}
+
+int Tuner::run(const std::vector<std::string>& args) {
+    Options options;
+    for (size_t i = 0; i < args.size(); i++) {
+        if (args[i] == "--threads" && i + 1 < args.size()) {
+            options.threads = std::max(std::stoi(args[++i]), 1);
+        } else if (args[i] == "--epochs" && i + 1 < args.size()) {
+            options.epochs = std::stoi(args[++i]);
+        } else if (args[i] == "--rate" && i + 1 < args.size()) {
+            options.learningRate = std::stod(args[++i]);
+        } else if (args[i] == "--out" && i + 1 < args.size()) {
+            options.outputPath = args[++i];
+        } else if (options.inputPath.empty() && args[i].rfind("--", 0) != 0) {
+            options.inputPath = args[i];
+        } else {
+            options.inputPath.clear();
+            break;
+        }
+    }
+    if (options.inputPath.empty()) {
+        std::cerr << "Usage: tune <positions.epd> [--threads N] [--epochs N] [--rate cp] [--out <TunedParameters.h>]\n";
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    auto elapsed = [&start] {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    WorkStealingPool pool(options.threads);
+    const TrainingSet set = loadPositions(options, pool);
+    if (set.size() == 0) {
+        std::cerr << "No labeled positions in " << options.inputPath << "\n";
+        return 1;
+    }
+    std::cout << "Load time: " << elapsed() << " s\n";
+
+    double parameters[PARAMETER_COUNT];
+    for (int p = 0; p < PARAMETER_COUNT; p++) parameters[p] = startingValue(p);
+    const double scale = fitScale(set, parameters, pool);
+    const double initialLoss = computeLoss(set, parameters, scale, pool, nullptr);
+    std::cout << "Scale " << scale << ", initial loss " << std::setprecision(8) << initialLoss
+              << std::setprecision(6) << "\n";
+
+    // Adam on the mean gradient of the full set each epoch
+    constexpr double BETA1 = 0.9;
+    constexpr double BETA2 = 0.999;
+    constexpr double EPSILON = 1e-8;
+    double moment[PARAMETER_COUNT] = {};
+    double velocity[PARAMETER_COUNT] = {};
+    double gradient[PARAMETER_COUNT];
+    double loss = initialLoss;
+
+    for (int epoch = 1; epoch <= options.epochs; epoch++) {
+        loss = computeLoss(set, parameters, scale, pool, gradient);
+        const double correction1 = 1.0 - std::pow(BETA1, epoch);
+        const double correction2 = 1.0 - std::pow(BETA2, epoch);
+        for (int p = 0; p < PARAMETER_COUNT; p++) {
+            moment[p] = BETA1 * moment[p] + (1.0 - BETA1) * gradient[p];
+            velocity[p] = BETA2 * velocity[p] + (1.0 - BETA2) * gradient[p] * gradient[p];
+            parameters[p] -= options.learningRate * (moment[p] / correction1) /
+                             (std::sqrt(velocity[p] / correction2) + EPSILON);
+        }
+        if (epoch % 50 == 0 || epoch == options.epochs) {
+            std::cout << "epoch " << epoch << " loss " << std::setprecision(8) << loss << std::setprecision(6)
+                      << " (" << elapsed() << " s)\n";
+        }
+    }
+    loss = computeLoss(set, parameters, scale, pool, nullptr);
+
+    std::cout << "\nParameter        start    tuned\n";
+    for (int p = 0; p < PARAMETER_COUNT; p++) {
+        const std::string name = std::string(TYPE_NAMES[p / 2]) + (p % 2 == 0 ? "_MG" : "_EG");
+        std::cout << std::left << std::setw(14) << name << std::right << std::setw(8) << startingValue(p)
+                  << std::setw(9) << std::lround(parameters[p]) << "\n";
+    }
+    writeHeader(options, parameters, set.size(), loss, scale);
+    std::cout << "Loss " << std::setprecision(8) << initialLoss << " -> " << loss << std::setprecision(6)
+              << ", " << set.size() << " positions, " << options.threads << " threads, "
+              << elapsed() << " s\nWrote " << options.outputPath << "\n";
+    return 0;
+}
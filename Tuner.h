@@ -0,0 +1,10 @@
+#pragma once
+#include <string>
+#include <vector>
+
+// Offline Texel-style tuning of evaluation parameters against game results.
+// Positions are labeled EPD/FEN lines; the fitted values are written as a
+// TunedParameters.h header.
+namespace Tuner {
+    int run(const std::vector<std::string>& args);
+}
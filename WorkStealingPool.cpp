@@ -0,0 +1,91 @@
+#include "WorkStealingPool.h"
+#include <algorithm>
+
+WorkStealingPool::WorkStealingPool(int threadCount)
+    : queuedTasks(0), pendingTasks(0), nextQueue(0), stopping(false) {
+    threadCount = std::max(threadCount, 1);
+    for (int i = 0; i < threadCount; i++) {
+        queues.push_back(std::make_unique<WorkerQueue>());
+    }
+    for (int i = 0; i < threadCount; i++) {
+        workers.emplace_back(&WorkStealingPool::workerLoop, this, i);
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> lock(idleMutex);
+        stopping = true;
+    }
+    workAvailable.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+int WorkStealingPool::defaultThreadCount() {
+    return static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u));
+}
+
+void WorkStealingPool::submit(Task task) {
+    // Spread submissions round-robin; stealing evens out the rest
+    WorkerQueue& queue = *queues[nextQueue++ % queues.size()];
+    // Count the task before a worker can take it, so neither counter drops
+    // below zero and wait() cannot see zero while the task is still queued
+    pendingTasks++;
+    {
+        std::lock_guard<std::mutex> lock(idleMutex);
+        queuedTasks++;
+    }
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back(std::move(task));
+    }
+    workAvailable.notify_one();
+}
+
+void WorkStealingPool::wait() {
+    std::unique_lock<std::mutex> lock(idleMutex);
+    allDone.wait(lock, [this] { return pendingTasks == 0; });
+}
+
+bool WorkStealingPool::popLocal(int worker, Task& task) {
+    WorkerQueue& queue = *queues[worker];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) return false;
+    task = std::move(queue.tasks.front());
+    queue.tasks.pop_front();
+    return true;
+}
+
+bool WorkStealingPool::steal(int worker, Task& task) {
+    const int count = static_cast<int>(queues.size());
+    for (int offset = 1; offset < count; offset++) {
+        WorkerQueue& victim = *queues[(worker + offset) % count];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (victim.tasks.empty()) continue;
+        task = std::move(victim.tasks.back());
+        victim.tasks.pop_back();
+        return true;
+    }
+    return false;
+}
+
+void WorkStealingPool::workerLoop(int worker) {
+    while (true) {
+        Task task;
+        if (popLocal(worker, task) || steal(worker, task)) {
+            queuedTasks--;
+            task(worker);
+            if (--pendingTasks == 0) {
+                std::lock_guard<std::mutex> lock(idleMutex);
+                allDone.notify_all();
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(idleMutex);
+        workAvailable.wait(lock, [this] { return stopping || queuedTasks > 0; });
+        if (stopping && queuedTasks == 0) return;
+    }
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed-size thread pool where every worker owns a task queue. Workers take
+// from the front of their own queue and steal from the back of the others
+// when it runs dry. Tasks receive the index of the worker running them, so
+// callers can keep per-worker state without locking.
+class WorkStealingPool {
+public:
+    using Task = std::function<void(int worker)>;
+
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::vector<std::thread> workers;
+    std::atomic<size_t> queuedTasks;    // submitted, not yet taken
+    std::atomic<size_t> pendingTasks;   // submitted, not yet finished
+    std::atomic<size_t> nextQueue;
+    bool stopping;
+    std::mutex idleMutex;
+    std::condition_variable workAvailable;
+    std::condition_variable allDone;
+
+    bool popLocal(int worker, Task& task);
+    bool steal(int worker, Task& task);
+    void workerLoop(int worker);
+
+public:
+    explicit WorkStealingPool(int threadCount);
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    void submit(Task task);
+    void wait();
+    int size() const { return static_cast<int>(workers.size()); }
+
+    static int defaultThreadCount();
+};
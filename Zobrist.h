@@ -0,0 +1,45 @@
+#pragma once
+#include <array>
+#include <cstdint>
+
+// Zobrist hashing keys, generated at compile time from a fixed seed so
+// hashes are stable across runs and builds.
+namespace Zobrist {
+    struct Keys {
+        uint64_t pieceSquare[12][64];
+        uint64_t castling[16];
+        uint64_t enPassantCol[8];
+        uint64_t sideToMove;
+    };
+
+    namespace detail {
+        constexpr uint64_t splitMix(uint64_t& state) {
+            uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            return z ^ (z >> 31);
+        }
+
+        constexpr Keys generate() {
+            Keys keys{};
+            uint64_t state = 0x5C4E55C0FFEEULL;
+            for (auto& piece : keys.pieceSquare) {
+                for (auto& key : piece) key = splitMix(state);
+            }
+            // Castling keys are XOR-combinations of the four single rights
+            uint64_t single[4] = { splitMix(state), splitMix(state), splitMix(state), splitMix(state) };
+            for (int rights = 0; rights < 16; rights++) {
+                uint64_t key = 0;
+                for (int bit = 0; bit < 4; bit++) {
+                    if (rights & (1 << bit)) key ^= single[bit];
+                }
+                keys.castling[rights] = key;
+            }
+            for (auto& key : keys.enPassantCol) key = splitMix(state);
+            keys.sideToMove = splitMix(state);
+            return keys;
+        }
+    }
+
+    inline constexpr Keys KEYS = detail::generate();
+}
@@ -1,7 +1,17 @@
 #include <iostream>
 #include "Game.h"
+#include "CommandLine.h"
+#include "Endgames.h"
+#include "KpkBitbase.h"
+
+int main(int argc, char* argv[]) {
+    KpkBitbase::init();
+    Endgames::init();
+
+    if (argc > 1) {
+        return CommandLine::run(argc, argv);
+    }
 
-int main() {
     try {
         std::cout << "=================================\n";
         std::cout << "    CHESS GAME WITH SFML\n";
@@ -11,6 +21,7 @@ int main() {
         std::cout << "- Click to select and move pieces\n";
         std::cout << "- Press 'S' to save game history\n";
         std::cout << "- Press 'R' to reset the game\n";
+        std::cout << "- Press 'A' to toggle analysis arrows\n";
         std::cout << "- Press 'ESC' to exit\n";
         std::cout << "=================================\n";
         std::cout << "Pieces per side (32 total):\n";